@@ -0,0 +1,113 @@
+#pragma once
+#include "gerber/ast/ast.hpp"
+#include "gerber/parser.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gerber {
+    /**
+     * Whether the library was built with zlib. Without it only uncompressed files
+     * and stored (not deflated) zip members can be read.
+     */
+    bool has_zlib();
+
+    /**
+     * Check for gzip magic bytes at the beginning of data.
+     */
+    bool is_gzip(const std::string_view& data);
+
+    /**
+     * Default limit of inflated size of gzip data, guards against decompression bombs
+     * which would otherwise grow the output until memory runs out.
+     */
+    constexpr std::size_t max_inflated_size = std::size_t(1) << 30;
+
+    /**
+     * Inflate all members of gzip stream into a single string. Output is grown in
+     * place, using size stored in gzip trailer as initial capacity. Throws ArchiveError
+     * when inflated data exceeds max_size bytes.
+     */
+    std::string
+    decompress_gzip(const std::string_view& data, std::size_t max_size = max_inflated_size);
+
+    /**
+     * Read whole file, transparently decompressing gzip compressed content.
+     */
+    std::string read_source_file(const std::string& path, std::size_t max_size = max_inflated_size);
+
+    class ZipEntry {
+      public:
+        enum Method : uint16_t {
+            STORED   = 0,
+            DEFLATED = 8
+        };
+
+        std::string name;
+        Method      method;
+        uint32_t    crc32;
+        uint64_t    compressed_size;
+        uint64_t    uncompressed_size;
+        uint64_t    local_header_offset;
+
+        bool isDirectory() const;
+    };
+
+    /**
+     * Read-only view of zip archive kept in memory in compressed form. Members
+     * are inflated only when requested.
+     */
+    class ZipArchive {
+      private:
+        std::string           data;
+        std::vector<ZipEntry> entries;
+
+      public:
+        explicit ZipArchive(std::string data);
+
+        static ZipArchive open(const std::string& path);
+
+        const std::vector<ZipEntry>& getEntries() const;
+        const ZipEntry*              find(const std::string_view& name) const;
+        /**
+         * Content of member, throws ArchiveError when it inflates to more than its
+         * declared uncompressed size.
+         */
+        std::string                  read(const ZipEntry& entry) const;
+
+      private:
+        void read_central_directory();
+    };
+
+    class PackageMember {
+      public:
+        std::string name;
+        File        file;
+    };
+
+    /**
+     * Parses members of fabrication package (zip archive) in parallel, each member
+     * is inflated directly into the buffer parsed by the worker thread.
+     */
+    class Package {
+      public:
+        /**
+         * Parse selected members, or all members with Gerber file extensions when
+         * names are empty. Results are in the order of names, or of the archive.
+         * threads == 0 means one thread per CPU core.
+         */
+        static std::vector<PackageMember> parse(
+            const ZipArchive&               archive,
+            const Parser&                   parser,
+            const std::vector<std::string>& names   = {},
+            std::size_t                     threads = 0
+        );
+
+        /**
+         * Check if file name has one of extensions commonly used by Gerber files.
+         */
+        static bool is_gerber_name(const std::string_view& name);
+    };
+} // namespace gerber
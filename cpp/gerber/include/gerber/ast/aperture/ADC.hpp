@@ -1,5 +1,6 @@
 #pragma once
 #include "gerber/ast/aperture/AD.hpp"
+#include <cstddef>
 #include <optional>
 #include <string>
 
@@ -10,9 +11,10 @@ namespace gerber {
         std::optional<double> holeDiameter;
 
       public:
-        ADC(const std::string_view& apertureId, double diameter, std::optional<double> holeDiameter
-        );
+        ADC(Text apertureId, double diameter, std::optional<double> holeDiameter);
         std::string           getNodeName() const override;
+        void                  visit(Visitor& visitor) const override;
+        size_t                memory_usage() const override;
         double                getDiameter() const;
         std::optional<double> getHoleDiameter() const;
     };
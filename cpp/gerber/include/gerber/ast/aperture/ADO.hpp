@@ -1,5 +1,6 @@
 #pragma once
 #include "gerber/ast/aperture/AD.hpp"
+#include <cstddef>
 #include <optional>
 #include <string>
 
@@ -11,12 +12,14 @@ namespace gerber {
         std::optional<double> holeDiameter;
 
       public:
-        ADO(const std::string_view& apertureId,
-            double                  width,
-            double                  height,
-            std::optional<double>   holeDiameter);
+        ADO(Text                  apertureId,
+            double                width,
+            double                height,
+            std::optional<double> holeDiameter);
 
         std::string           getNodeName() const override;
+        void                  visit(Visitor& visitor) const override;
+        size_t                memory_usage() const override;
         double                getWidth() const;
         double                getHeight() const;
         std::optional<double> getHoleDiameter() const;
@@ -1,5 +1,6 @@
 #pragma once
 #include "gerber/ast/aperture/AD.hpp"
+#include <cstddef>
 #include <optional>
 #include <string>
 
@@ -12,13 +13,15 @@ namespace gerber {
         std::optional<double> holeDiameter;
 
       public:
-        ADP(const std::string_view& apertureId,
-            double                  outerDiameter,
-            double                  verticesCount,
-            std::optional<double>   rotation,
-            std::optional<double>   holeDiameter);
+        ADP(Text                  apertureId,
+            double                outerDiameter,
+            double                verticesCount,
+            std::optional<double> rotation,
+            std::optional<double> holeDiameter);
 
         std::string           getNodeName() const override;
+        void                  visit(Visitor& visitor) const override;
+        size_t                memory_usage() const override;
         double                getOuterDiameter() const;
         double                getVerticesCount() const;
         std::optional<double> getRotation() const;
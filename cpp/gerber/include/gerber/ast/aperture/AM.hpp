@@ -3,6 +3,7 @@
 #include "gerber/ast/aperture/AMopen.hpp"
 #include "gerber/ast/command.hpp"
 #include "gerber/ast/extended_command.hpp"
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <vector>
@@ -23,6 +24,8 @@ namespace gerber {
            std::shared_ptr<AMclose> amClose);
 
         std::string              getNodeName() const override;
+        void                     visit(Visitor& visitor) const override;
+        size_t                   memory_usage() const override;
         std::shared_ptr<AMopen>  getAmOpen() const;
         primitives_container_t   getPrimitives() const;
         std::shared_ptr<AMclose> getAmClose() const;
@@ -1,17 +1,23 @@
 #pragma once
 #include "gerber/ast/node.hpp"
+#include "gerber/ast/text.hpp"
+#include <cstddef>
 #include <string>
+#include <string_view>
 
 namespace gerber {
     class AMopen: public Node {
       private:
-        std::string apertureId;
+        Text apertureId;
 
         AMopen() = delete;
 
       public:
-        AMopen(const std::string_view& apertureId);
+        AMopen(Text apertureId);
         std::string getNodeName() const override;
-        std::string getApertureId() const;
+        void        visit(Visitor& visitor) const override;
+        size_t      memory_usage() const override;
+        std::string      getApertureId() const;
+        std::string_view getApertureIdView() const;
     };
 } // namespace gerber
\ No newline at end of file
@@ -2,7 +2,10 @@
 #include "./enums.hpp"
 #include "./extended_command.hpp"
 #include "./file.hpp"
+#include "./memory.hpp"
 #include "./node.hpp"
+#include "./text.hpp"
+#include "./visitor.hpp"
 
 #include "./aperture/AD.hpp"
 #include "./aperture/ADC.hpp"
@@ -17,6 +20,7 @@
 #include "./d_codes/D02.hpp"
 #include "./d_codes/D03.hpp"
 #include "./d_codes/Dnn.hpp"
+#include "./d_codes/operation.hpp"
 
 #include "./g_codes/G01.hpp"
 #include "./g_codes/G02.hpp"
@@ -1,14 +1,20 @@
 #pragma once
 #include "gerber/ast/command.hpp"
+#include "gerber/ast/text.hpp"
+#include <cstddef>
 #include <string>
+#include <string_view>
 
 namespace gerber {
     class Dnn : public Command {
-        std::string aperture_id;
+        Text aperture_id;
 
       public:
-        Dnn(const std::string_view& aperture_id_);
+        Dnn(Text aperture_id_);
         std::string getNodeName() const override;
-        std::string getApertureId() const;
+        void        visit(Visitor& visitor) const override;
+        size_t      memory_usage() const override;
+        std::string      getApertureId() const;
+        std::string_view getApertureIdView() const;
     };
 } // namespace gerber
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+#include "gerber/ast/command.hpp"
+#include "gerber/ast/text.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace gerber {
+    /**
+     * Complete operation statement, eg. X100Y100D01*, with optional coordinate data
+     * and the operation code. Parser emits it instead of separate coordinate nodes
+     * followed by D01, D02 or D03 node, unless split operations are requested.
+     */
+    class Operation : public Command {
+      public:
+        enum Kind : uint8_t {
+            INTERPOLATE = 1,
+            MOVE        = 2,
+            FLASH       = 3
+        };
+
+      private:
+        Kind                kind;
+        std::optional<Text> x;
+        std::optional<Text> y;
+        std::optional<Text> i;
+        std::optional<Text> j;
+
+        Operation() = delete;
+
+      public:
+        Operation(
+            Kind                kind,
+            std::optional<Text> x,
+            std::optional<Text> y,
+            std::optional<Text> i,
+            std::optional<Text> j
+        );
+        std::string                     getNodeName() const override;
+        void                            visit(Visitor& visitor) const override;
+        size_t                          memory_usage() const override;
+        Kind                            getKind() const;
+        std::optional<std::string>      getX() const;
+        std::optional<std::string>      getY() const;
+        std::optional<std::string>      getI() const;
+        std::optional<std::string>      getJ() const;
+        std::optional<std::string_view> getXView() const;
+        std::optional<std::string_view> getYView() const;
+        std::optional<std::string_view> getIView() const;
+        std::optional<std::string_view> getJView() const;
+    };
+} // namespace gerber
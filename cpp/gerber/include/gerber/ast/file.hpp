@@ -1,5 +1,7 @@
 #pragma once
 #include "gerber/ast/node.hpp"
+#include "gerber/scanner.hpp"
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <vector>
@@ -8,11 +10,41 @@ namespace gerber {
     class File : public Node {
       private:
         std::vector<std::shared_ptr<Node>> nodes;
+        // Buffer text of nodes may be borrowed from, null when all nodes own their text.
+        std::shared_ptr<const std::string> source;
+        // Source range of each node, only filled by incremental parse.
+        std::vector<Span>                  spans;
 
       public:
         File(File&& other);
         File(std::vector<std::shared_ptr<Node>>&& nodes);
-        std::vector<std::shared_ptr<Node>>& getNodes();
-        virtual std::string                 getNodeName() const;
+        /**
+         * File retaining source buffer, nodes may hold text borrowed from it and must
+         * not be used after all Files sharing the buffer are destroyed.
+         */
+        File(std::vector<std::shared_ptr<Node>>&& nodes, std::shared_ptr<const std::string> source);
+        /**
+         * File which can be updated with Parser::reparse, spans are source ranges of
+         * nodes. Commands producing several nodes give each of them the same span.
+         */
+        File(
+            std::vector<std::shared_ptr<Node>>&& nodes,
+            std::shared_ptr<const std::string>   source,
+            std::vector<Span>&&                  spans
+        );
+        std::vector<std::shared_ptr<Node>>&       getNodes();
+        const std::vector<std::shared_ptr<Node>>& getNodes() const;
+        const std::shared_ptr<const std::string>& getSource() const;
+        virtual std::string                       getNodeName() const;
+        void                                      visit(Visitor& visitor) const override;
+        /**
+         * Bytes used by node list, all nodes and retained source. Nodes and source
+         * shared with other files are counted in full.
+         */
+        size_t                                    memory_usage() const override;
+
+        void                     setSource(std::shared_ptr<const std::string> source);
+        std::vector<Span>&       getSpans();
+        const std::vector<Span>& getSpans() const;
     };
 } // namespace gerber
\ No newline at end of file
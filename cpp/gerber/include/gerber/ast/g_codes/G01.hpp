@@ -1,10 +1,13 @@
 #pragma once
 #include "gerber/ast/command.hpp"
+#include <cstddef>
 #include <string>
 
 namespace gerber {
     class G01 : public Command {
       public:
         std::string getNodeName() const override;
+        void        visit(Visitor& visitor) const override;
+        size_t      memory_usage() const override;
     };
 } // namespace gerber
\ No newline at end of file
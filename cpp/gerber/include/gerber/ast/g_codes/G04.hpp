@@ -1,15 +1,22 @@
 #pragma once
 #include "gerber/ast/command.hpp"
+#include "gerber/ast/text.hpp"
+#include <cstddef>
 #include <string>
+#include <string_view>
 
 namespace gerber {
     class G04 : public Command {
       private:
-        std::string comment;
+        Text comment;
 
       public:
-        G04(std::string comment);
+        G04(Text comment);
 
         std::string getNodeName() const override;
+        void        visit(Visitor& visitor) const override;
+        size_t      memory_usage() const override;
+        std::string      getComment() const;
+        std::string_view getCommentView() const;
     };
 } // namespace gerber
\ No newline at end of file
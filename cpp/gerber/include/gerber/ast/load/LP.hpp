@@ -1,6 +1,7 @@
 #pragma once
 #include "gerber/ast/enums.hpp"
 #include "gerber/ast/extended_command.hpp"
+#include <cstddef>
 #include <string>
 
 namespace gerber {
@@ -11,5 +12,7 @@ namespace gerber {
       public:
         LP(const char polarity);
         std::string getNodeName() const override;
+        void        visit(Visitor& visitor) const override;
+        size_t      memory_usage() const override;
     };
 } // namespace gerber
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+#include "gerber/ast/text.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace gerber {
+    /**
+     * Size of control block allocated together with object by std::make_shared,
+     * vtable pointer and two reference counters in libstdc++ and libc++.
+     */
+    inline constexpr size_t shared_control_block_size = sizeof(void*) + 2 * sizeof(int32_t);
+
+    /**
+     * Bytes allocated by string outside of the object itself, zero when the string
+     * fits in small string buffer.
+     */
+    inline size_t heap_usage(const std::string& value) {
+        const auto data   = reinterpret_cast<std::uintptr_t>(value.data());
+        const auto object = reinterpret_cast<std::uintptr_t>(&value);
+        if (data >= object && data < object + sizeof(value)) {
+            return 0;
+        }
+        return value.capacity() + 1;
+    }
+
+    inline size_t heap_usage(const std::optional<std::string>& value) {
+        return value.has_value() ? heap_usage(*value) : 0;
+    }
+
+    inline size_t heap_usage(const Text& value) {
+        return value.heap_usage();
+    }
+
+    inline size_t heap_usage(const std::optional<Text>& value) {
+        return value.has_value() ? value->heap_usage() : 0;
+    }
+
+    /**
+     * Bytes of vector storage, excluding memory owned by elements.
+     */
+    template <typename T>
+    size_t heap_usage(const std::vector<T>& value) {
+        return value.capacity() * sizeof(T);
+    }
+
+    /**
+     * Bytes of node created with std::make_shared, including its control block.
+     */
+    template <typename T>
+    size_t shared_usage(const std::shared_ptr<T>& node) {
+        return node ? shared_control_block_size + node->memory_usage() : 0;
+    }
+} // namespace gerber
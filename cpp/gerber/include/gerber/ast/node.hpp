@@ -1,9 +1,17 @@
 #pragma once
+#include <cstddef>
 #include <string>
 
 namespace gerber {
+    class Visitor;
+
     class Node {
       public:
         virtual std::string getNodeName() const;
+        virtual void        visit(Visitor& visitor) const;
+        /**
+         * Bytes used by the node object and memory it owns, including child nodes.
+         */
+        virtual size_t      memory_usage() const;
     };
 } // namespace gerber
\ No newline at end of file
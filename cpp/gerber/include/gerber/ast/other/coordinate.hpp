@@ -1,17 +1,23 @@
 #pragma once
 #include "gerber/ast/command.hpp"
+#include "gerber/ast/text.hpp"
+#include <cstddef>
 #include <string>
+#include <string_view>
 
 namespace gerber {
     class Coordinate : public Command {
       private:
-        std::string value;
+        Text value;
 
         Coordinate() = delete;
 
       public:
-        Coordinate(const std::string_view& value);
+        Coordinate(Text value);
         std::string getNodeName() const override;
-        std::string getValue() const;
+        void        visit(Visitor& visitor) const override;
+        size_t      memory_usage() const override;
+        std::string      getValue() const;
+        std::string_view getValueView() const;
     };
 } // namespace gerber
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include "./coordinate.hpp"
+#include <cstddef>
 #include <string>
 
 namespace gerber {
@@ -7,5 +8,7 @@ namespace gerber {
       public:
         using Coordinate::Coordinate;
         std::string getNodeName() const override;
+        void        visit(Visitor& visitor) const override;
+        size_t      memory_usage() const override;
     };
 } // namespace gerber
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include "gerber/ast/extended_command.hpp"
 #include "gerber/ast/enums.hpp"
+#include <cstddef>
 #include <string>
 #include <string_view>
 
@@ -25,5 +26,7 @@ namespace gerber {
            int                     y_decimal);
 
         std::string getNodeName() const override;
+        void        visit(Visitor& visitor) const override;
+        size_t      memory_usage() const override;
     };
 } // namespace gerber
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include "gerber/ast/extended_command.hpp"
 #include "gerber/ast/enums.hpp"
+#include <cstddef>
 #include <string>
 #include <string_view>
 
@@ -12,5 +13,7 @@ namespace gerber {
       public:
         MO(const std::string_view& unit_mode);
         std::string getNodeName() const override;
+        void        visit(Visitor& visitor) const override;
+        size_t      memory_usage() const override;
     };
 }
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace gerber {
+    /**
+     * Text field of a node. Either a slice of source buffer owned by File, or an
+     * owned copy stored inline when it fits in 16 bytes and on the heap otherwise.
+     * Borrowed text is valid only as long as the buffer it was sliced from.
+     */
+    class Text {
+      public:
+        static constexpr size_t inline_capacity = 16;
+
+      private:
+        enum Storage : uint8_t {
+            BORROWED,
+            INLINE,
+            HEAP
+        };
+
+        uint32_t size;
+        Storage  storage;
+
+        union {
+            const char* borrowed;
+            char*       heap;
+            char        small[inline_capacity];
+        };
+
+      public:
+        Text();
+        Text(const std::string_view& value);
+        Text(const std::string& value);
+        Text(const char* value);
+        Text(const Text& other);
+        Text(Text&& other) noexcept;
+        ~Text();
+
+        Text& operator=(const Text& other);
+        Text& operator=(Text&& other) noexcept;
+
+        /**
+         * Reference slice of a buffer without copying it.
+         */
+        static Text borrow(const std::string_view& slice);
+
+        std::string_view view() const;
+        std::string      str() const;
+        bool             isBorrowed() const;
+        /**
+         * Bytes allocated outside of the object itself.
+         */
+        size_t           heap_usage() const;
+
+        operator std::string_view() const;
+        bool operator==(const Text& other) const;
+
+      private:
+        void assign(const std::string_view& value);
+        void release();
+    };
+} // namespace gerber
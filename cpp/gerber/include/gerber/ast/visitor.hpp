@@ -0,0 +1,117 @@
+#pragma once
+
+namespace gerber {
+    class Node;
+    class File;
+    class Command;
+    class ExtendedCommand;
+
+    class AD;
+    class ADC;
+    class ADO;
+    class ADP;
+    class ADR;
+    class AM;
+    class AMclose;
+    class AMopen;
+
+    class D01;
+    class D02;
+    class D03;
+    class Dnn;
+    class Operation;
+
+    class G01;
+    class G02;
+    class G03;
+    class G04;
+    class G36;
+    class G37;
+    class G54;
+    class G55;
+    class G70;
+    class G71;
+    class G74;
+    class G75;
+    class G90;
+    class G91;
+
+    class LP;
+
+    class M02;
+
+    class Coordinate;
+    class CoordinateI;
+    class CoordinateJ;
+    class CoordinateX;
+    class CoordinateY;
+
+    class FS;
+    class MO;
+
+    /**
+     * Base class for AST visitors, C++ counterpart of visitors used by Python API.
+     * Every callback by default forwards to the callback of more general node kind,
+     * eg. on_adc() calls on_ad(), which calls on_command(), which calls on_node().
+     * on_file() visits all nodes of the file in order.
+     */
+    class Visitor {
+      public:
+        virtual ~Visitor() = default;
+
+        virtual void on_node(const Node& node);
+        virtual void on_file(const File& node);
+        virtual void on_command(const Command& node);
+        virtual void on_extended_command(const ExtendedCommand& node);
+
+        // Aperture
+        virtual void on_ad(const AD& node);
+        virtual void on_adc(const ADC& node);
+        virtual void on_ado(const ADO& node);
+        virtual void on_adp(const ADP& node);
+        virtual void on_adr(const ADR& node);
+        virtual void on_am(const AM& node);
+        virtual void on_am_close(const AMclose& node);
+        virtual void on_am_open(const AMopen& node);
+
+        // D codes
+        virtual void on_d01(const D01& node);
+        virtual void on_d02(const D02& node);
+        virtual void on_d03(const D03& node);
+        virtual void on_dnn(const Dnn& node);
+        virtual void on_operation(const Operation& node);
+
+        // G codes
+        virtual void on_g01(const G01& node);
+        virtual void on_g02(const G02& node);
+        virtual void on_g03(const G03& node);
+        virtual void on_g04(const G04& node);
+        virtual void on_g36(const G36& node);
+        virtual void on_g37(const G37& node);
+        virtual void on_g54(const G54& node);
+        virtual void on_g55(const G55& node);
+        virtual void on_g70(const G70& node);
+        virtual void on_g71(const G71& node);
+        virtual void on_g74(const G74& node);
+        virtual void on_g75(const G75& node);
+        virtual void on_g90(const G90& node);
+        virtual void on_g91(const G91& node);
+
+        // Load
+        virtual void on_lp(const LP& node);
+
+        // M codes
+        virtual void on_m02(const M02& node);
+
+        // Other
+        virtual void on_coordinate(const Coordinate& node);
+        virtual void on_coordinate_i(const CoordinateI& node);
+        virtual void on_coordinate_j(const CoordinateJ& node);
+        virtual void on_coordinate_x(const CoordinateX& node);
+        virtual void on_coordinate_y(const CoordinateY& node);
+
+        // Properties
+        virtual void on_fs(const FS& node);
+        virtual void on_mo(const MO& node);
+    };
+} // namespace gerber
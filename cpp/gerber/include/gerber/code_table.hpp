@@ -0,0 +1,121 @@
+#pragma once
+#include "gerber/ast/ast.hpp"
+#include "gerber/ast/text.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+namespace gerber {
+    /**
+     * Creates node for a code, receives code digits without leading zeros, which
+     * may be borrowed from the parsed source.
+     */
+    using code_factory_t = std::shared_ptr<Node> (*)(Text digits);
+
+    class CodeEntry {
+      public:
+        uint32_t       code;
+        code_factory_t factory;
+    };
+
+    /**
+     * Number parsed from the beginning of a string, length is the count of digits.
+     * Value saturates at UINT32_MAX for numbers too long to fit.
+     */
+    class CodeNumber {
+      public:
+        uint32_t value;
+        uint32_t length;
+
+        bool operator==(const CodeNumber& other) const = default;
+    };
+
+    /**
+     * Parse leading decimal digits of source. Converts 8 digits at a time with
+     * SWAR arithmetic on little endian targets.
+     */
+    CodeNumber scan_code_number(const std::string_view& source);
+
+    /**
+     * Compile time perfect hash table mapping code numbers to node factories. Hash is
+     * code modulo table size, so size has to be a power of two large enough to avoid
+     * collisions, which are reported as compilation errors. Codes not present in the
+     * table map to the fallback factory, which may be nullptr.
+     */
+    template <std::size_t size>
+    class CodeTable {
+        static_assert(size > 0 && (size & (size - 1)) == 0, "Table size must be a power of 2");
+
+      private:
+        std::array<CodeEntry, size> slots;
+        code_factory_t              fallback;
+
+      public:
+        template <std::size_t count>
+        consteval CodeTable(
+            const std::array<CodeEntry, count>& entries, code_factory_t fallback_ = nullptr
+        ) :
+            slots(),
+            fallback(fallback_) {
+            for (const auto& entry : entries) {
+                auto& slot = slots[entry.code & (size - 1)];
+                if (slot.factory != nullptr) {
+                    throw "Code collision, increase CodeTable size";
+                }
+                slot = entry;
+            }
+        }
+
+        constexpr code_factory_t find(uint32_t code) const {
+            const auto& slot = slots[code & (size - 1)];
+            return (slot.code == code && slot.factory != nullptr) ? slot.factory : fallback;
+        }
+    };
+
+    template <typename node_type>
+    std::shared_ptr<Node> make_code_node(Text) {
+        return std::make_shared<node_type>();
+    }
+
+    template <>
+    std::shared_ptr<Node> make_code_node<G04>(Text);
+
+    template <>
+    std::shared_ptr<Node> make_code_node<Dnn>(Text digits);
+
+    // To support new code add its entry below and increase table size if compilation
+    // fails due to a collision.
+
+    inline constexpr CodeTable<128> g_code_table{std::array{
+        CodeEntry{1, &make_code_node<G01>},
+        CodeEntry{2, &make_code_node<G02>},
+        CodeEntry{3, &make_code_node<G03>},
+        CodeEntry{4, &make_code_node<G04>},
+        CodeEntry{36, &make_code_node<G36>},
+        CodeEntry{37, &make_code_node<G37>},
+        CodeEntry{54, &make_code_node<G54>},
+        CodeEntry{55, &make_code_node<G55>},
+        CodeEntry{70, &make_code_node<G70>},
+        CodeEntry{71, &make_code_node<G71>},
+        CodeEntry{74, &make_code_node<G74>},
+        CodeEntry{75, &make_code_node<G75>},
+        CodeEntry{90, &make_code_node<G90>},
+        CodeEntry{91, &make_code_node<G91>},
+    }};
+
+    // Codes which are not operations select aperture.
+    inline constexpr CodeTable<4> d_code_table{
+        std::array{
+            CodeEntry{1, &make_code_node<D01>},
+            CodeEntry{2, &make_code_node<D02>},
+            CodeEntry{3, &make_code_node<D03>},
+        },
+        &make_code_node<Dnn>,
+    };
+
+    inline constexpr CodeTable<4> m_code_table{std::array{
+        CodeEntry{2, &make_code_node<M02>},
+    }};
+} // namespace gerber
@@ -0,0 +1,61 @@
+#pragma once
+#include "gerber/ast/ast.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gerber {
+    /**
+     * Compact read-only form of File, for keeping many large layers in memory.
+     *
+     * Nodes are encoded into a byte stream, each as a one byte opcode followed by its
+     * payload. Coordinates are stored as zigzag varints of the difference from the
+     * previous value of the same axis, so usually take one or two bytes. Commands
+     * without payload are just the opcode. Nodes with text which can't be restored
+     * from a number, like aperture definitions and comments, are kept as they are.
+     *
+     * Every checkpoint_interval nodes the decoder state is saved, so random access
+     * decodes at most that many nodes.
+     */
+    class CompactFile {
+      public:
+        static constexpr std::size_t checkpoint_interval = 256;
+
+      private:
+        class Checkpoint {
+          public:
+            uint64_t offset;
+            uint32_t literal;
+            // Previous X, Y, I and J.
+            int64_t  previous[4];
+        };
+
+        std::vector<uint8_t>               bytes;
+        std::vector<Checkpoint>            checkpoints;
+        std::vector<std::shared_ptr<Node>> literals;
+        std::size_t                        count;
+        // Nodes kept as they are may borrow text from it.
+        std::shared_ptr<const std::string> source;
+
+      public:
+        CompactFile(const File& file);
+
+        std::size_t           size() const;
+        /**
+         * Decode single node, throws std::out_of_range for index past the end.
+         */
+        std::shared_ptr<Node> at(std::size_t index) const;
+        File                  decode() const;
+        /**
+         * Decode nodes one by one and pass them to visitor, without building File.
+         */
+        void                  visit(Visitor& visitor) const;
+        /**
+         * Bytes used by the encoded stream, checkpoints and nodes kept as they are.
+         * Retained source is counted in full.
+         */
+        size_t                memory_usage() const;
+    };
+} // namespace gerber
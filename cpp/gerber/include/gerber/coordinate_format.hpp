@@ -0,0 +1,32 @@
+#pragma once
+#include "gerber/ast/enums.hpp"
+#include "gerber/ast/properties/FS.hpp"
+#include <cstdint>
+#include <string_view>
+
+namespace gerber {
+    /**
+     * Numeric interpretation of coordinate data for one axis, as declared by FS.
+     */
+    class CoordinateFormat {
+      public:
+        Zeros zeros;
+        int   integral;
+        int   decimal;
+
+      public:
+        CoordinateFormat(Zeros zeros, int integral, int decimal);
+        static CoordinateFormat x(const FS& fs);
+        static CoordinateFormat y(const FS& fs);
+
+        /**
+         * Convert coordinate data to integer count of 10^-decimal units. Throws
+         * std::invalid_argument when value is not a valid coordinate.
+         */
+        int64_t toInteger(const std::string_view& value) const;
+        /**
+         * Convert coordinate data to a number in file units.
+         */
+        double  toDouble(const std::string_view& value) const;
+    };
+} // namespace gerber
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace gerber {
+    /**
+     * Content of generated files. Weights are relative frequencies of blocks of
+     * commands, zero disables the kind of block.
+     */
+    class CorpusOptions {
+      public:
+        uint64_t seed          = 1;
+        // Generation stops at the first block boundary past this size.
+        uint64_t target_bytes  = 1024 * 1024;
+        // Board size in millimeters, all coordinates lie within it.
+        double   board_width   = 300;
+        double   board_height  = 200;
+        // Number of %ADD apertures and %AM macros in the header.
+        uint32_t apertures     = 100;
+        uint32_t macros        = 10;
+        // Vertices of a single G36/G37 pour.
+        uint32_t pour_vertices = 500;
+        // Length of a G04 comment.
+        uint32_t comment_bytes = 200;
+
+        // Runs of D01 draws.
+        uint32_t tracks   = 40;
+        // Grids of D03 flashes.
+        uint32_t pads     = 20;
+        uint32_t pours    = 4;
+        // Outlines made of G02/G03 arcs.
+        uint32_t arcs     = 10;
+        // Clear polarity blocks enclosed in LPC/LPD.
+        uint32_t clears   = 4;
+        uint32_t comments = 2;
+    };
+
+    /**
+     * Generates deterministic synthetic Gerber files for load and scaling tests, same
+     * options always give byte-for-byte the same output. Files use 4.6 format in
+     * millimeters and always parse with Parser.
+     *
+     * Output is formatted into a buffer which is flushed to the stream whenever it
+     * exceeds flush_threshold, so files of any size are produced in constant memory.
+     */
+    class CorpusGenerator {
+      public:
+        static constexpr size_t flush_threshold = 64 * 1024;
+
+        static void        generate(const CorpusOptions& options, std::ostream& output);
+        static std::string generate(const CorpusOptions& options);
+    };
+} // namespace gerber
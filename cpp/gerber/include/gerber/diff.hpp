@@ -0,0 +1,65 @@
+#pragma once
+#include "gerber/interpreter.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gerber {
+    /**
+     * Feature which is present in both revisions with the same shape, only at
+     * a different position.
+     */
+    class FeatureMove {
+      public:
+        uint32_t before;
+        uint32_t after;
+        Point    offset;
+    };
+
+    class DiffOptions {
+      public:
+        // Coordinates closer than this are considered equal, in millimeters.
+        double      tolerance   = 1e-6;
+        // Largest distance of a moved feature, farther ones are removed and added.
+        double      move_radius = 1.0;
+        // Worker threads, 0 means one per CPU core.
+        std::size_t threads     = 0;
+    };
+
+    /**
+     * Differences between two Images. Indices refer to Image::features of the
+     * revision before and after the change.
+     */
+    class ImageDiff {
+      public:
+        std::vector<uint32_t>    removed;
+        std::vector<uint32_t>    added;
+        std::vector<FeatureMove> moved;
+        std::size_t              unchanged = 0;
+
+        BoundingBox removed_bounds;
+        BoundingBox added_bounds;
+        // Covers moved features at both positions.
+        BoundingBox moved_bounds;
+
+        bool empty() const;
+    };
+
+    /**
+     * Structural comparison of two interpreted layers, independent of the order of
+     * features. Each feature is hashed from its kind, polarity, aperture and geometry
+     * relative to its anchor point, all snapped to DiffOptions::tolerance, so that
+     * draws traversed in the opposite direction and region contours starting at another
+     * vertex or traversed in the opposite direction compare equal too.
+     *
+     * Features with the same hash and anchor are unchanged, the rest with the same
+     * shape hash are paired as moves with the nearest counterpart within move_radius,
+     * found through a grid of cells. Both steps are split by hash into shards which
+     * are matched in parallel.
+     */
+    class Differ {
+      public:
+        static ImageDiff
+        diff(const Image& before, const Image& after, const DiffOptions& options = DiffOptions());
+    };
+} // namespace gerber
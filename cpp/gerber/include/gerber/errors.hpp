@@ -7,4 +7,19 @@ namespace gerber {
       public:
         explicit SyntaxError(const std::string& message);
     };
+
+    class InterpreterError : public std::runtime_error {
+      public:
+        explicit InterpreterError(const std::string& message);
+    };
+
+    class ArchiveError : public std::runtime_error {
+      public:
+        explicit ArchiveError(const std::string& message);
+    };
+
+    class CancelledError : public std::runtime_error {
+      public:
+        explicit CancelledError(const std::string& message);
+    };
 } // namespace gerber
\ No newline at end of file
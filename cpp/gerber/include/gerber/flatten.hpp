@@ -0,0 +1,50 @@
+#pragma once
+#include "gerber/interpreter.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gerber {
+    /**
+     * Polygon with counterclockwise outer boundary and clockwise holes, coordinates
+     * in millimeters. Rings are not closed, last vertex connects to the first one.
+     */
+    class Polygon {
+      public:
+        std::vector<Point>              outer;
+        std::vector<std::vector<Point>> holes;
+
+        /**
+         * Area of outer boundary minus area of holes.
+         */
+        double area() const;
+    };
+
+    class FlattenOptions {
+      public:
+        // Maximum chord error of arcs and circles, in millimeters.
+        double      tolerance    = 0.001;
+        // Resolution of integer coordinates used internally, 1 nm by default.
+        double      units_per_mm = 1e6;
+        // Number of horizontal bands processed in parallel, 0 means one per thread.
+        std::size_t tiles        = 0;
+        // Worker threads, 0 means one per CPU core.
+        std::size_t threads      = 0;
+    };
+
+    /**
+     * Resolves dark and clear polarity of Image features into final, non-overlapping
+     * copper polygons. Each point is covered by copper when the last feature covering
+     * it is dark.
+     *
+     * Features are converted to polygons with integer coordinates and processed with
+     * a scanbeam sweep, which splits the plane into trapezoids at every vertex and
+     * edge intersection. Horizontal bands are swept in parallel, trapezoids of all
+     * bands are then stitched into rings along band seams.
+     */
+    class Flattener {
+      public:
+        static std::vector<Polygon>
+        flatten(const Image& image, const FlattenOptions& options = FlattenOptions());
+    };
+} // namespace gerber
@@ -1,4 +1,24 @@
 #pragma once
+#include "gerber/archive.hpp"
 #include "gerber/ast/ast.hpp"
 #include "gerber/errors.hpp"
+#include "gerber/code_table.hpp"
+#include "gerber/parse_stats.hpp"
 #include "gerber/parser.hpp"
+#include "gerber/scanner.hpp"
+#include "gerber/thread_pool.hpp"
+#include "gerber/writer.hpp"
+#include "gerber/coordinate_format.hpp"
+#include "gerber/interpreter.hpp"
+#include "gerber/optimizer.hpp"
+#include "gerber/tessellation.hpp"
+#include "gerber/flatten.hpp"
+#include "gerber/svg.hpp"
+#include "gerber/diff.hpp"
+#include "gerber/raster.hpp"
+#include "gerber/corpus.hpp"
+#include "gerber/compact.hpp"
+#include "gerber/lazy.hpp"
+#include "gerber/validator.hpp"
+#include "gerber/transform.hpp"
+#include "gerber/panel.hpp"
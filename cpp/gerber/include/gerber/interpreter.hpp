@@ -0,0 +1,247 @@
+#pragma once
+#include "gerber/ast/ast.hpp"
+#include "gerber/ast/visitor.hpp"
+#include "gerber/coordinate_format.hpp"
+#include "gerber/errors.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace gerber {
+    class Point {
+      public:
+        double x;
+        double y;
+
+        bool operator==(const Point& other) const = default;
+    };
+
+    /**
+     * Standard aperture with dimensions converted to millimeters.
+     */
+    class Aperture {
+      public:
+        enum Shape : uint8_t {
+            CIRCLE,
+            RECTANGLE,
+            OBROUND,
+            POLYGON
+        };
+
+        Shape  shape;
+        // Diameter for circles and outer diameter for polygons.
+        double width;
+        double height;
+        // Polygon only, rotation is in degrees.
+        double vertices;
+        double rotation;
+        // Zero when aperture has no hole.
+        double hole;
+
+        /**
+         * Distance from aperture origin to its farthest point.
+         */
+        double extent() const;
+
+        bool operator==(const Aperture& other) const = default;
+    };
+
+    /**
+     * Line or circular arc with absolute coordinates in millimeters. For arcs center
+     * is already resolved, also for single quadrant mode.
+     */
+    class Segment {
+      public:
+        enum Kind : uint8_t {
+            LINE,
+            ARC_CW,
+            ARC_CCW
+        };
+
+        Kind  kind;
+        // Arc was created in multi quadrant mode, in which start == end means full circle.
+        bool  multi_quadrant;
+        Point start;
+        Point end;
+        Point center;
+
+        bool operator==(const Segment& other) const = default;
+    };
+
+    /**
+     * Axis aligned bounding box in millimeters, empty until first point is included.
+     */
+    class BoundingBox {
+      public:
+        Point min{0.0, 0.0};
+        Point max{0.0, 0.0};
+        bool  empty = true;
+
+        void include(const Point& point, double margin = 0.0);
+        /**
+         * Arcs are included with their whole circle, which is a cheap upper bound.
+         */
+        void include(const Segment& segment, double margin = 0.0);
+        void include(const BoundingBox& other);
+
+        bool operator==(const BoundingBox& other) const = default;
+    };
+
+    /**
+     * Graphical object created by an operation.
+     * - DRAW is a segment stroked with an aperture (D01 outside of region),
+     * - FLASH is an aperture replicated at segment.end (D03),
+     * - REGION is a single contour made of contour_size segments of Image::contours
+     *   starting at contour_begin (D01/D02 inside G36/G37).
+     */
+    class Feature {
+      public:
+        enum Kind : uint8_t {
+            DRAW,
+            FLASH,
+            REGION
+        };
+
+        Kind           kind;
+        Polarity::Enum polarity;
+        // Index in Image::apertures, -1 for regions.
+        int32_t        aperture;
+        Segment        segment;
+        uint32_t       contour_begin;
+        uint32_t       contour_size;
+
+        bool operator==(const Feature& other) const = default;
+    };
+
+    /**
+     * Result of interpretation of a Gerber file. Identical apertures are stored only
+     * once, regardless of how many times they were defined.
+     */
+    class Image {
+      public:
+        std::vector<Aperture> apertures;
+        std::vector<Feature>  features;
+        std::vector<Segment>  contours;
+
+        bool operator==(const Image& other) const = default;
+    };
+
+    /**
+     * Receives features as soon as Interpreter produces them. Image passed along holds
+     * apertures and, for regions, contours of the feature.
+     */
+    class FeatureSink {
+      public:
+        virtual ~FeatureSink() = default;
+
+        virtual void on_feature(const Image& image, const Feature& feature) = 0;
+    };
+
+    /**
+     * Executes commands of a File, resolving modal state (units, coordinate format,
+     * interpolation mode, polarity, current aperture and point) into Image.
+     */
+    class Interpreter : public Visitor {
+      private:
+        enum Interpolation : uint8_t {
+            LINEAR,
+            CLOCKWISE,
+            COUNTERCLOCKWISE
+        };
+
+        // Allows lookup of aperture ids by std::string_view without a copy.
+        struct ApertureIdHash {
+            using is_transparent = void;
+
+            size_t operator()(const std::string_view& id) const {
+                return std::hash<std::string_view>{}(id);
+            }
+        };
+
+        Image&                                                                   image;
+        FeatureSink*                                                             sink;
+        std::unordered_map<std::string, int32_t, ApertureIdHash, std::equal_to<>> aperture_ids;
+
+        std::optional<CoordinateFormat> x_format;
+        std::optional<CoordinateFormat> y_format;
+        double                          unit_scale;
+        bool                            incremental;
+        Interpolation                   interpolation;
+        bool                            multi_quadrant;
+        bool                            region_mode;
+        Polarity::Enum                  polarity;
+        int32_t                         aperture;
+        uint32_t                        contour_begin;
+        Point                           current_point;
+
+        std::optional<double> pending_x;
+        std::optional<double> pending_y;
+        std::optional<double> pending_i;
+        std::optional<double> pending_j;
+
+      public:
+        /**
+         * With sink, features are passed to it instead of being stored in image and
+         * contours are dropped once their region is passed, so only apertures are kept.
+         */
+        Interpreter(Image& image, FeatureSink* sink = nullptr);
+
+        static Image interpret(const File& file);
+
+        void on_adc(const ADC& node) override;
+        void on_ado(const ADO& node) override;
+        void on_adp(const ADP& node) override;
+        void on_adr(const ADR& node) override;
+
+        void on_d01(const D01& node) override;
+        void on_d02(const D02& node) override;
+        void on_d03(const D03& node) override;
+        void on_dnn(const Dnn& node) override;
+        void on_operation(const Operation& node) override;
+
+        void on_g01(const G01& node) override;
+        void on_g02(const G02& node) override;
+        void on_g03(const G03& node) override;
+        void on_g36(const G36& node) override;
+        void on_g37(const G37& node) override;
+        void on_g70(const G70& node) override;
+        void on_g71(const G71& node) override;
+        void on_g74(const G74& node) override;
+        void on_g75(const G75& node) override;
+        void on_g90(const G90& node) override;
+        void on_g91(const G91& node) override;
+
+        void on_lp(const LP& node) override;
+
+        void on_coordinate_i(const CoordinateI& node) override;
+        void on_coordinate_j(const CoordinateJ& node) override;
+        void on_coordinate_x(const CoordinateX& node) override;
+        void on_coordinate_y(const CoordinateY& node) override;
+
+        void on_fs(const FS& node) override;
+        void on_mo(const MO& node) override;
+
+        /**
+         * Close region contour which is still open at the end of the file.
+         */
+        void finish();
+
+      private:
+        void    interpolate();
+        void    move();
+        void    flash();
+        void    define_aperture(const std::string_view& id, const Aperture& aperture);
+        double  to_millimeters(const std::optional<CoordinateFormat>& format,
+                               const std::string_view&                value) const;
+        Point   consume_target();
+        Segment make_segment(const Point& target);
+        Point   resolve_single_quadrant_center(const Segment& segment, double i, double j) const;
+        void    close_contour();
+        void    emit(const Feature& feature);
+    };
+} // namespace gerber
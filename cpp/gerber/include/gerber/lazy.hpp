@@ -0,0 +1,69 @@
+#pragma once
+#include "gerber/ast/ast.hpp"
+#include "gerber/parser.hpp"
+#include "gerber/scanner.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gerber {
+    /**
+     * File whose commands are decoded on first access. Construction only finds
+     * command boundaries with Scanner and records code of each command, so queries
+     * touching few commands, like reading the header, cost a fraction of full parse.
+     *
+     * Commands may be decoded from many threads at once, each is decoded exactly
+     * once. Syntax errors are thrown by the access which decodes the command. Text of
+     * nodes is borrowed from the source, so nodes must not outlive the LazyFile.
+     */
+    class LazyFile {
+      private:
+        class CommandEntry {
+          public:
+            Span    span;
+            // Length of the code at the beginning of command, after '%' if any.
+            uint8_t code_length;
+        };
+
+        class Slot {
+          public:
+            std::once_flag                     once;
+            std::atomic<bool>                  decoded{false};
+            std::vector<std::shared_ptr<Node>> nodes;
+        };
+
+        ParserOptions                      options;
+        std::shared_ptr<const std::string> source;
+        std::vector<CommandEntry>          commands;
+        std::unique_ptr<Slot[]>            slots;
+
+      public:
+        LazyFile(
+            std::shared_ptr<const std::string> source,
+            const ParserOptions&               options = ParserOptions()
+        );
+
+        std::size_t                               size() const;
+        const Span&                               getSpan(std::size_t index) const;
+        /**
+         * Code identifying kind of command, eg. "FS" or "AD" for extended commands,
+         * "G04" or "D10" for codes and "X" for operations starting with X coordinate.
+         */
+        std::string_view                          getCode(std::size_t index) const;
+        bool                                      isDecoded(std::size_t index) const;
+        /**
+         * Nodes of the command, most commands produce exactly one.
+         */
+        const std::vector<std::shared_ptr<Node>>& getNodes(std::size_t index) const;
+        /**
+         * Decode all commands which weren't decoded yet. File shares nodes and source
+         * with this LazyFile.
+         */
+        File                                      decode() const;
+    };
+} // namespace gerber
@@ -0,0 +1,17 @@
+#pragma once
+#include "gerber/ast/ast.hpp"
+
+namespace gerber {
+    /**
+     * Produces smaller File with geometry identical to the input one. Removes
+     * modal commands which do not change state (G01/G02/G03, G74/G75, LP, MO, FS,
+     * Dnn selecting current aperture), X/Y coordinates equal to the current point,
+     * moves to the current point and merges duplicate aperture definitions.
+     *
+     * Nodes which are kept are shared with the input File, not copied.
+     */
+    class Optimizer {
+      public:
+        File optimize(const File& file) const;
+    };
+} // namespace gerber
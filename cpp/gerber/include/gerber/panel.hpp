@@ -0,0 +1,115 @@
+#pragma once
+#include "gerber/ast/ast.hpp"
+#include "gerber/flatten.hpp"
+#include "gerber/interpreter.hpp"
+#include "gerber/transform.hpp"
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace gerber {
+    /**
+     * Placement of a layer on the panel.
+     */
+    class PanelInstance {
+      public:
+        // Index of the layer in Panel::getLayers().
+        std::size_t     layer;
+        AffineTransform transform;
+    };
+
+    class PanelWriteOptions {
+      public:
+        TransformOptions format;
+        // Write regular grids of the same layer as %SR step and repeat blocks, which
+        // is more compact. Parser doesn't support %SR, so such output is write-only for
+        // this library and has to be read by other tools.
+        bool             step_repeat = false;
+    };
+
+    /**
+     * Panel made of instances of layers, each layer is a shared immutable File and
+     * instances only hold its index and a transform, so placing a layer many times
+     * doesn't copy its geometry.
+     *
+     * Geometry is expanded only by consumers which need it. Layers are interpreted on
+     * first use, once for all their instances, to find bounds of instances. flatten()
+     * flattens every layer once and copies the polygons to instances. write()
+     * transforms the nodes of one instance at a time while writing. Instances are
+     * assumed not to overlap, clear polarity of one instance doesn't affect others.
+     */
+    class Panel {
+      private:
+        class Layer {
+          public:
+            std::shared_ptr<const File> file;
+            std::once_flag              interpreted;
+            Image                       image;
+            BoundingBox                 bounds;
+
+            Layer(std::shared_ptr<const File> file_);
+        };
+
+        std::vector<std::unique_ptr<Layer>> layers;
+        std::vector<PanelInstance>          instances;
+
+        const Layer& interpreted_layer(std::size_t layer) const;
+
+      public:
+        /**
+         * Add a layer without placing it, returns its index.
+         */
+        std::size_t addLayer(std::shared_ptr<const File> file);
+        /**
+         * Place instance of a layer, throws std::out_of_range for unknown layer and
+         * std::invalid_argument for transforms which don't keep angles.
+         */
+        void        place(std::size_t layer, const AffineTransform& transform);
+        /**
+         * Place columns x rows instances, instance in column c and row r is origin
+         * followed by translation by (c * step_x, r * step_y) millimeters.
+         */
+        void        placeGrid(
+                   std::size_t            layer,
+                   std::size_t            columns,
+                   std::size_t            rows,
+                   double                 step_x,
+                   double                 step_y,
+                   const AffineTransform& origin = AffineTransform()
+               );
+
+        std::size_t                       getLayerCount() const;
+        const File&                       getLayer(std::size_t layer) const;
+        const std::vector<PanelInstance>& getInstances() const;
+
+        /**
+         * Interpreted layer, shared by all its instances.
+         */
+        const Image&             getImage(std::size_t layer) const;
+        /**
+         * Bounds of the instance, transformed bounds of its layer.
+         */
+        BoundingBox              getBounds(std::size_t instance) const;
+        BoundingBox              getBounds() const;
+        /**
+         * Indices of instances with bounds intersecting area.
+         */
+        std::vector<std::size_t> query(const BoundingBox& area) const;
+
+        /**
+         * Copper polygons of all instances, eg. for RasterComparator.
+         */
+        std::vector<Polygon> flatten(const FlattenOptions& options = FlattenOptions()) const;
+
+        /**
+         * Write the panel as a single Gerber file. Aperture numbers are reassigned so
+         * that layers don't collide. With default options every instance is written out,
+         * so the output can be parsed back.
+         */
+        void        write(std::ostream& output, const PanelWriteOptions& options = {}) const;
+        std::string write(const PanelWriteOptions& options = {}) const;
+    };
+} // namespace gerber
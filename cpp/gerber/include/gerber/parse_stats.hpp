@@ -0,0 +1,63 @@
+#pragma once
+#include "gerber/ast/ast.hpp"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+
+// Set to 0 to compile out timing of command families from the parse loop.
+#ifndef GERBER_PARSE_STATS
+#define GERBER_PARSE_STATS 1
+#endif
+
+namespace gerber {
+    /**
+     * Statistics of a single parse, filled by Parser::parse() when requested.
+     * Collecting them costs nothing for parses which don't ask for them. Time per
+     * command family is measured only when GERBER_PARSE_STATS is enabled.
+     */
+    class ParseStats {
+      public:
+        using duration_t = std::chrono::nanoseconds;
+
+        enum Family : uint8_t {
+            G_CODE,
+            D_CODE,
+            M_CODE,
+            // Coordinates and operations, eg. X100Y100D01*.
+            OPERATION,
+            // Commands enclosed in '%'.
+            EXTENDED,
+            FAMILY_COUNT
+        };
+
+        static constexpr bool timing_enabled = GERBER_PARSE_STATS != 0;
+
+        uint64_t bytes_scanned  = 0;
+        uint64_t comment_bytes  = 0;
+        uint64_t aperture_count = 0;
+        // Number of segments in the largest region (G36/G37 block).
+        uint64_t largest_region = 0;
+        // Peak memory of the parse, which is the resulting File as pre-scan keeps no index.
+        uint64_t peak_bytes     = 0;
+
+        duration_t scan_time{0};
+        duration_t total_time{0};
+
+        std::array<uint64_t, FAMILY_COUNT>   family_commands{};
+        std::array<duration_t, FAMILY_COUNT> family_time{};
+
+        // Count of nodes by node name.
+        std::map<std::string, uint64_t> nodes;
+
+        static Family           family_of(char first_character);
+        static std::string_view family_name(Family family);
+
+        /**
+         * Fill statistics which can be derived from the AST.
+         */
+        void collect(const File& file);
+    };
+} // namespace gerber
@@ -1,61 +1,199 @@
 #pragma once
 #include "gerber/ast/ast.hpp"
+#include "gerber/ast/visitor.hpp"
+#include "gerber/code_table.hpp"
 #include "gerber/errors.hpp"
+#include "gerber/parse_stats.hpp"
+#include "gerber/scanner.hpp"
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <regex>
+#include <stop_token>
 #include <string>
 #include <string_view>
 #include <tuple>
 #include <vector>
 
 namespace gerber {
-    using location_t = uint64_t;
-    using offset_t   = uint64_t;
+    using offset_t = uint64_t;
 
     const std::tuple<location_t, location_t>
     get_line_column(const std::string_view& source, const location_t& index);
 
+    class ParserOptions {
+      public:
+        // Emit coordinates and D01/D02/D03 of operation statements as separate nodes,
+        // instead of a single Operation node.
+        bool split_operations = false;
+        // Keep source buffer in the resulting File and make text of nodes slices of it,
+        // instead of copying it into each node. Nodes must not outlive the File.
+        bool borrow_source    = false;
+        // Record source span of each node and keep a copy of the source in File, so it
+        // can be updated with Parser::reparse. Text of nodes is always copied.
+        bool incremental      = false;
+    };
+
+    /**
+     * Nodes replaced by Parser::reparse, nodes [first, first + removed) of the previous
+     * File became nodes [first, first + inserted).
+     */
+    class NodeSplice {
+      public:
+        std::size_t first;
+        std::size_t removed;
+        std::size_t inserted;
+    };
+
+    /**
+     * Parses Gerber source into File. Parser holds only options, all state of a parse
+     * lives in ParseContext created per call, so single Parser can be shared by many
+     * threads and is cheap to construct.
+     */
     class Parser {
       private:
+        ParserOptions options;
+
+      public:
+        Parser();
+        Parser(const ParserOptions& options);
+
+        File parse(const std::string& source) const;
+        /**
+         * Parse source which is no longer needed by the caller, with borrow_source
+         * the buffer is moved into resulting File instead of being copied.
+         */
+        File parse(std::string&& source) const;
+        /**
+         * Parse which can be interrupted from other thread, throws CancelledError
+         * shortly after stop is requested.
+         */
+        File parse(const std::string& source, std::stop_token stop_token) const;
+        /**
+         * Parse and fill stats, which should be freshly constructed.
+         */
+        File parse(const std::string& source, ParseStats& stats) const;
+        /**
+         * Parse shared source buffer, resulting File retains it and text of nodes is
+         * borrowed from it regardless of ParserOptions::borrow_source.
+         */
+        File parse(std::shared_ptr<const std::string> source) const;
+        /**
+         * Parse file from disk, gzip compressed files are inflated in memory.
+         */
+        File parse_file(const std::string& path) const;
+        /**
+         * Parse without building File, each node is passed to visitor as soon as it
+         * is parsed and destroyed right after, so memory doesn't grow with number of
+         * commands. Text of nodes is borrowed from source.
+         */
+        void stream(const std::string_view& source, Visitor& visitor) const;
+        /**
+         * Replace edited range of the source of file parsed with ParserOptions::incremental
+         * by text and update nodes in place. Parsing starts at the beginning of the first
+         * statement touching the edit and stops as soon as the next command begins where
+         * one of the nodes after the edit does, so parsing work is proportional to the size
+         * of the edit. No modal state has to be restored, but parsing is not context free
+         * within a statement: whether its coordinates are fused into a single operation
+         * depends on the rest of it, so it is reparsed from the previous '*' or '%'.
+         *
+         * Bookkeeping around it is still proportional to the size of the file: updated
+         * source is a new copy of the whole string, spans of all nodes after the edit are
+         * shifted and nodes and spans after it are moved within their vectors. These are
+         * plain copies, much cheaper than parsing, but an edit near the start of a large
+         * file costs O(file size) all the same.
+         *
+         * Throws std::invalid_argument when file wasn't parsed with incremental option or
+         * range is outside of its source. On SyntaxError file is left unchanged.
+         */
+        NodeSplice reparse(File& file, const Span& edited, const std::string_view& text) const;
+    };
+
+    /**
+     * State of a single parse, used internally by Parser.
+     */
+    class ParseContext {
+      private:
+        const ParserOptions&               options;
         std::vector<std::shared_ptr<Node>> commands;
         std::string_view                   full_source;
         location_t                         global_index;
-        // Regular expressions cache
+        std::stop_token                    stop_token;
+        ParseStats*                        stats;
+        // Buffer the source is a view of, when text of nodes is borrowed from it.
+        std::shared_ptr<const std::string> buffer;
+        // When set, nodes are visited right after parsing instead of being collected.
+        Visitor*                           visitor;
+        // Source range of each command, with ParserOptions::incremental.
+        std::vector<Span>                  spans;
+        // Regular expressions are immutable and compiled once per process.
         // Aperture
-        std::regex                         ad_header_regex{"^%ADD([1-9][0-9]*)([a-zA-Z0-9_]+),"};
-        // D-codes
-        std::regex                         d_code_regex{"^[Dd]0*([1-9][0-9]*)\\*"};
-        // G-codes
-        std::regex                         g_code_regex{"^[Gg]0*([1-9][0-9]*)\\*"};
-        std::regex                         g04_regex{"^[Gg]0*4([^%*]+)\\*"};
+        static const std::regex            ad_header_regex;
         // Properties
-        std::regex fs_regex{"^%FS([TL])([IA])X([0-9])([0-9])Y([0-9])([0-9])\\*%"};
-        std::regex mo_regex{"^%MO(IN|MM)\\*%"};
-        // M-codes
-        std::regex m_code_regex{"^[Mm]0*([1-9][0-9]*)\\*"};
+        static const std::regex            fs_regex;
+        static const std::regex            mo_regex;
         // Helper regex
-        std::regex float_regex{"([+-]?((([0-9]+)(\\.[0-9]*)?)|(\\.[0-9]+)))"};
-        std::regex name_regex{"([._a-zA-Z$][._a-zA-Z0-9]*)"};
+        static const std::regex            float_regex;
+        static const std::regex            name_regex;
 
       public:
-        Parser();
+        ParseContext(
+            const ParserOptions&    options,
+            const std::string_view& source,
+            std::stop_token                    stop_token = {},
+            ParseStats*                        stats      = nullptr,
+            std::shared_ptr<const std::string> buffer     = nullptr,
+            Visitor*                           visitor    = nullptr
+        );
 
-        File parse(const std::string& source);
+        File parse();
+        void stream();
+        /**
+         * Parse commands from begin until resume returns true for the position of the
+         * next command or source ends. Resulting File has no source, spans are filled
+         * with ParserOptions::incremental.
+         */
+        File parse_until(location_t begin, const std::function<bool(location_t)>& resume);
+
+      private:
+        File make_file();
 
       private:
+        /**
+         * Text of node, borrowed from the buffer or copied when there is none. Streamed
+         * nodes never outlive the source, so they borrow too. Incrementally parsed nodes
+         * are kept across edits of the source, so they always copy.
+         */
+        Text text(const std::string_view& slice) const {
+            return ((buffer || visitor != nullptr) && !options.incremental) ? Text::borrow(slice)
+                                                                            : Text(slice);
+        }
+
+        /**
+         * Give commands which don't have a span yet the one from begin to current index.
+         */
+        void record_spans(location_t begin) {
+            if (options.incremental) {
+                spans.resize(commands.size(), Span{begin, global_index});
+            }
+        }
+
+
+        template <bool with_stats>
+        void              parse_commands();
         location_t        parse_global(const std::string_view& source, const location_t& index);
         [[noreturn]] void throw_syntax_error();
 
         offset_t parse_aperture(const std::string_view& source);
         offset_t parse_aperture_definition(const std::string_view& source);
         offset_t parse_standard_aperture_c_tail(
-            const std::string_view& source, const std::string& aperture_id
+            const std::string_view& source, const std::string_view& aperture_id
         );
 
         template <typename aperture_type>
         offset_t parse_standard_aperture_r_like_tail(
-            const std::string_view& source, const std::string& aperture_id
+            const std::string_view& source, const std::string_view& aperture_id
         ) {
             std::string_view rest   = source;
             offset_t         offset = 0;
@@ -73,13 +211,13 @@ namespace gerber {
             consume_char(rest, offset, '%');
 
             commands.push_back(
-                std::make_shared<aperture_type>(aperture_id, width, height, holeDiameter)
+                std::make_shared<aperture_type>(text(aperture_id), width, height, holeDiameter)
             );
             return offset;
         }
 
         offset_t parse_standard_aperture_p_tail(
-            const std::string_view& source, const std::string& aperture_id
+            const std::string_view& source, const std::string_view& aperture_id
         );
 
         /**
@@ -102,9 +240,10 @@ namespace gerber {
         /**
          * Check if next characters in the source string match regex. If they do,
          * move source and offset to point to the next character after the match and
-         * return matched string. Otherwise throw SyntaxError.
+         * return matched part of source. Otherwise throw SyntaxError.
          */
-        std::string consume_regex(std::string_view& source, offset_t& offset, std::regex& expected);
+        std::string_view
+        consume_regex(std::string_view& source, offset_t& offset, const std::regex& expected);
 
         offset_t    match_char(const std::string_view& source, char expected);
         std::string match_float(const std::string_view& source);
@@ -125,6 +264,11 @@ namespace gerber {
          */
         void skip_whitespace(std::string_view& source, offset_t& offset);
 
+        /**
+         * Parse code number following code letter, returns offset of its first
+         * significant digit.
+         */
+        offset_t parse_code(const std::string_view& source, CodeNumber& number);
         offset_t parse_g_code(const std::string_view& gerber, const location_t& index);
         offset_t parse_m_code(const std::string_view& gerber);
         offset_t parse_d_code(const std::string_view& source, const location_t& index);
@@ -136,12 +280,30 @@ namespace gerber {
                 throw_syntax_error();
             }
 
-            auto length = parse_integer(source.substr(1));
-            commands.push_back(std::make_shared<coordinate_type>(source.substr(1, length)));
+            const offset_t sign   = (source[1] == '+' || source[1] == '-') ? 1 : 0;
+            const auto     length = sign + parse_integer(source.substr(1 + sign));
+            commands.push_back(std::make_shared<coordinate_type>(text(source.substr(1, length))));
 
             return 1 + length;
         }
 
+        template <typename coordinate_type>
+        offset_t
+        parse_operation_or_coordinate(const std::string_view& source, const location_t& index) {
+            if (!options.split_operations) {
+                if (const auto length = parse_operation(source)) {
+                    return length;
+                }
+            }
+            return parse_coordinate<coordinate_type>(source, index);
+        }
+
+        /**
+         * Fast path for complete operation statements, eg. X100Y100D01*. Returns 0
+         * without consuming anything when source doesn't start with such statement.
+         */
+        offset_t parse_operation(const std::string_view& source);
+
         offset_t parse_integer(const std::string_view& source);
 
         template <typename lambda_t>
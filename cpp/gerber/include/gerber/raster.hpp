@@ -0,0 +1,66 @@
+#pragma once
+#include "gerber/ast/ast.hpp"
+#include "gerber/flatten.hpp"
+#include "gerber/interpreter.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gerber {
+    class RasterOptions {
+      public:
+        // Pixel size in millimeters.
+        double      resolution = 0.01;
+        // Edge of a square tile, in pixels.
+        uint32_t    tile_size  = 256;
+        // Worker threads, 0 means one per CPU core.
+        std::size_t threads    = 0;
+    };
+
+    /**
+     * Tile containing pixels which differ, bounds enclose just the differing pixels.
+     */
+    class RasterDifference {
+      public:
+        BoundingBox bounds;
+        uint64_t    pixels;
+    };
+
+    class RasterComparison {
+      public:
+        // Ordered by tile row from the bottom, then by tile column.
+        std::vector<RasterDifference> regions;
+        uint64_t                      different_pixels = 0;
+        uint64_t                      tiles            = 0;
+        // Tiles which were not compared pixel by pixel, because their hashes matched.
+        uint64_t                      identical_tiles  = 0;
+
+        bool identical() const;
+    };
+
+    /**
+     * Pixel level comparison of two layers, independent of how their geometry was
+     * constructed. Pixel is set when its center is covered by copper.
+     *
+     * Layers are flattened into polygons, which are then scan converted one band of
+     * tiles at a time, bands in parallel. Rows are kept as spans of set pixels, so
+     * full resolution images never exist. Each tile of both layers is hashed and only
+     * tiles with different hashes are XORed.
+     */
+    class RasterComparator {
+      public:
+        /**
+         * Throws std::invalid_argument when resolution isn't positive or tile_size is 0.
+         */
+        static RasterComparison compare(
+            const File&          before,
+            const File&          after,
+            const RasterOptions& options = RasterOptions()
+        );
+        static RasterComparison compare(
+            const std::vector<Polygon>& before,
+            const std::vector<Polygon>& after,
+            const RasterOptions&        options = RasterOptions()
+        );
+    };
+} // namespace gerber
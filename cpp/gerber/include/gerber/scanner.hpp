@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace gerber {
+    using location_t = uint64_t;
+
+    /**
+     * Half-open range [begin, end) of indices in the source string.
+     */
+    class Span {
+      public:
+        location_t begin;
+        location_t end;
+
+        bool operator==(const Span& other) const = default;
+    };
+
+    /**
+     * Result of structural pre-scan of Gerber source. Contains sorted positions of
+     * command delimiters ('*' and '%') and sorted runs of whitespace characters
+     * (' ', '\r' and '\n').
+     */
+    class StructuralIndex {
+      public:
+        std::vector<location_t> delimiters;
+        std::vector<Span>       whitespace;
+    };
+
+    /**
+     * Structural pre-scan of Gerber source. Finds structural characters in a single
+     * sweep over the source using AVX2 or SSE2 when available, with a scalar fallback.
+     * Backend is selected at runtime.
+     *
+     * Parser only counts delimiters, which takes constant memory, to size its node
+     * vector up front and skips whitespace between commands with skip_whitespace().
+     * Full index is used by LazyFile, which keeps command boundaries.
+     */
+    class Scanner {
+      public:
+        enum Backend : uint8_t {
+            AUTO,
+            SCALAR,
+            SSE2,
+            AVX2
+        };
+
+        /**
+         * Return the best backend supported by the CPU we are running on.
+         */
+        static Backend detect_backend();
+        /**
+         * Build structural index of the source. When requested backend is not supported
+         * by the CPU, the best supported one is used instead.
+         */
+        static StructuralIndex scan(const std::string_view& source, Backend backend = AUTO);
+        /**
+         * Number of delimiters in the source, same as size of delimiters of scan() but
+         * without storing them.
+         */
+        static location_t count_delimiters(const std::string_view& source, Backend backend = AUTO);
+        /**
+         * Position of the first character at or after position which isn't whitespace,
+         * or size of the source. Compares 16 characters at a time with SSE2 on x86-64.
+         */
+        static location_t skip_whitespace(const std::string_view& source, location_t position);
+
+      private:
+        /**
+         * Requested backend, or the best supported one when it's AUTO or unsupported.
+         */
+        static Backend resolve_backend(Backend backend);
+    };
+} // namespace gerber
@@ -0,0 +1,100 @@
+#pragma once
+#include "gerber/interpreter.hpp"
+#include "gerber/parser.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gerber {
+    class SvgOptions {
+      public:
+        // Fill and stroke color of copper, any SVG color.
+        std::string color     = "black";
+        // Decimal places of coordinates, in millimeters.
+        int         precision = 4;
+    };
+
+    /**
+     * Writes features into SVG as they are produced by Interpreter, so neither File
+     * nor Image has to be built. Each aperture is defined once and flashes refer to
+     * it with <use>, consecutive draws with the same aperture share a single path.
+     *
+     * Bounds of the image are only known at the end, so the image is built inside
+     * <defs> and shown by a nested <svg> with viewBox written last. Clear polarity
+     * masks everything drawn before it, which is expressed the same way: content so
+     * far is closed in a group and referenced with a mask from the next one. Color
+     * is inherited from the outermost <use>, strokes refer to it with currentColor.
+     */
+    class SvgExporter : public FeatureSink {
+      public:
+        // Output is flushed to the stream in chunks of this size.
+        static constexpr size_t flush_threshold = 64 * 1024;
+
+      private:
+        enum PathKind : uint8_t {
+            NONE,
+            STROKE,
+        };
+
+        std::ostream&                          output;
+        SvgOptions                             options;
+        std::string                            out;
+        std::back_insert_iterator<std::string> it;
+
+        std::vector<bool> defined_apertures;
+        uint32_t          layer;
+        bool              masking;
+
+        PathKind path;
+        int32_t  path_aperture;
+        Point    path_end;
+
+        BoundingBox bounds;
+
+      public:
+        SvgExporter(std::ostream& output, const SvgOptions& options = SvgOptions());
+
+        void on_feature(const Image& image, const Feature& feature) override;
+        /**
+         * Write the rest of the document and flush it, must be called once after the
+         * last feature.
+         */
+        void finish();
+
+        /**
+         * Parse, interpret and export source in a single streaming pass.
+         */
+        static void render(
+            const std::string_view& source,
+            std::ostream&           output,
+            const SvgOptions&       options        = SvgOptions(),
+            const ParserOptions&    parser_options = ParserOptions()
+        );
+        static std::string render(
+            const std::string_view& source,
+            const SvgOptions&       options        = SvgOptions(),
+            const ParserOptions&    parser_options = ParserOptions()
+        );
+
+      private:
+        void write_number(double value);
+        void write_point(const Point& point);
+        void write_arc(const Segment& segment);
+        void write_segment(const Segment& segment);
+        void write_aperture(const Aperture& aperture);
+        void define_aperture(const Image& image, int32_t aperture);
+
+        void flash(const Image& image, const Feature& feature);
+        void draw(const Image& image, const Feature& feature);
+        void region(const Image& image, const Feature& feature);
+        void set_polarity(Polarity::Enum polarity);
+        void close_path();
+        void close_mask();
+
+        void flush();
+    };
+} // namespace gerber
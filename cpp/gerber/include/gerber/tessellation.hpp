@@ -0,0 +1,58 @@
+#pragma once
+#include "gerber/interpreter.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gerber {
+    /**
+     * Polylines stored in a single flat vertex array. Polyline i consists of
+     * vertices[offsets[i]] up to, but excluding, vertices[offsets[i + 1]].
+     */
+    class Polylines {
+      public:
+        std::vector<Point>       vertices;
+        std::vector<std::size_t> offsets{0};
+
+        std::size_t size() const;
+        void        clear();
+    };
+
+    /**
+     * Converts segments resolved by Interpreter into polylines. Arcs are split into
+     * chords deviating from the arc by at most tolerance, lines are kept as they are.
+     * First and last vertex of each polyline are exactly segment start and end.
+     */
+    class ArcTessellator {
+      public:
+        // Default maximum chord error in millimeters.
+        static constexpr double   default_tolerance = 0.001;
+        // Upper bound of chords per arc, guards against absurdly small tolerances.
+        static constexpr uint32_t max_chords        = 1 << 16;
+
+      private:
+        double tolerance;
+
+      public:
+        /**
+         * Throws std::invalid_argument when tolerance isn't positive.
+         */
+        explicit ArcTessellator(double tolerance = default_tolerance);
+
+        double getTolerance() const;
+
+        /**
+         * Number of chords of segment's polyline, 1 for lines.
+         */
+        uint32_t chord_count(const Segment& segment) const;
+
+        /**
+         * Append polyline of a single segment.
+         */
+        void      tessellate(const Segment& segment, Polylines& output) const;
+        /**
+         * Tessellate all segments at once, polyline i corresponds to segments[i].
+         */
+        Polylines tessellate(const std::vector<Segment>& segments) const;
+    };
+} // namespace gerber
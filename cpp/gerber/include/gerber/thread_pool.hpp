@@ -0,0 +1,39 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace gerber {
+    /**
+     * Fixed size pool of worker threads executing tasks in FIFO order. Tasks must not
+     * throw. Destructor waits until all queued tasks are executed.
+     */
+    class ThreadPool {
+      private:
+        std::mutex                        mutex;
+        std::condition_variable           condition;
+        std::queue<std::function<void()>> tasks;
+        std::vector<std::thread>          workers;
+        bool                              stopping;
+
+      public:
+        /**
+         * Create pool with given number of threads, 0 means one thread per CPU core.
+         */
+        explicit ThreadPool(std::size_t size = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&)            = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        std::size_t size() const;
+        void        submit(std::function<void()> task);
+
+      private:
+        void run();
+    };
+} // namespace gerber
@@ -0,0 +1,105 @@
+#pragma once
+#include "gerber/ast/ast.hpp"
+#include "gerber/ast/enums.hpp"
+#include "gerber/interpreter.hpp"
+#include <vector>
+
+namespace gerber {
+    /**
+     * 2D affine transform, maps (x, y) to (xx * x + xy * y + dx, yx * x + yy * y + dy).
+     * Offsets are in millimeters.
+     */
+    class AffineTransform {
+      public:
+        double xx = 1.0;
+        double xy = 0.0;
+        double yx = 0.0;
+        double yy = 1.0;
+        double dx = 0.0;
+        double dy = 0.0;
+
+        static AffineTransform translate(double dx, double dy);
+        /**
+         * Counterclockwise rotation around origin.
+         */
+        static AffineTransform rotate(double degrees);
+        static AffineTransform scale(double factor);
+        /**
+         * Mirror across the Y axis, negating X.
+         */
+        static AffineTransform mirror_x();
+        /**
+         * Mirror across the X axis, negating Y.
+         */
+        static AffineTransform mirror_y();
+
+        /**
+         * Transform applying this one first and other after it.
+         */
+        AffineTransform then(const AffineTransform& other) const;
+
+        Point  apply(const Point& point) const;
+        /**
+         * Transform points given as separate arrays of coordinates in place, four points
+         * at a time with AVX2 or two with SSE2, selected at runtime like in Scanner.
+         * Results don't depend on the instruction set, no fused multiply-add is used.
+         */
+        void   apply(std::vector<double>& x, std::vector<double>& y) const;
+        /**
+         * Transform vectors in place, like apply() without the offset.
+         */
+        void   apply_linear(std::vector<double>& x, std::vector<double>& y) const;
+        /**
+         * Length of transformed unit vector, for conformal transforms.
+         */
+        double scale_factor() const;
+        /**
+         * True when transform flips orientation, which swaps arc directions.
+         */
+        bool   mirrors() const;
+        /**
+         * True when transform keeps angles, i.e. it is composed of rotation, mirror,
+         * uniform scale and translation. Only those keep circles and arcs circular.
+         */
+        bool   conformal() const;
+        /**
+         * True when axes are mapped onto axes, i.e. rotation is a multiple of 90 degrees.
+         */
+        bool   axis_aligned() const;
+    };
+
+    class TransformOptions {
+      public:
+        // Units of the output, coordinates and apertures are converted to them.
+        UnitMode::Enum units    = UnitMode::MILLIMETERS;
+        // Coordinate format of the output, the same for both axes.
+        int            integral = 4;
+        int            decimal  = 6;
+    };
+
+    /**
+     * Applies unit conversion and a conformal affine transform to a File.
+     *
+     * Coordinates are decoded into arrays of absolute positions and arc offsets in
+     * millimeters, transformed in one vectorized pass together with scaling to output
+     * units, then encoded back as operations, which share a single allocation.
+     * Output has a single FS with absolute coordinates and omitted leading zeros and
+     * a single MO, placed where the first FS, MO, G70 or G71 was; G70, G71, G90 and
+     * G91 are removed. Aperture sizes are scaled, polygon apertures rotated, rectangles
+     * and obrounds swap sides when rotated by 90 degrees and G02 and G03 are swapped
+     * by mirroring transforms.
+     *
+     * Throws std::invalid_argument for transforms which aren't conformal and for
+     * rotations which aren't multiples of 90 degrees when the file has rectangle or
+     * obround apertures or single quadrant arcs, none of which can represent them.
+     * Throws InterpreterError when coordinate data precedes FS.
+     */
+    class Transformer {
+      public:
+        static File transform(
+            const File&             file,
+            const AffineTransform&  transform,
+            const TransformOptions& options = TransformOptions()
+        );
+    };
+} // namespace gerber
@@ -0,0 +1,60 @@
+#pragma once
+#include "gerber/ast/ast.hpp"
+#include "gerber/scanner.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gerber {
+    /**
+     * Semantic problem found by Validator.
+     */
+    class Diagnostic {
+      public:
+        enum Code : uint8_t {
+            // Dnn selects aperture which wasn't defined before.
+            UNDEFINED_APERTURE,
+            // %ADD defines aperture number which is already defined.
+            REDEFINED_APERTURE,
+            // Coordinate data before the first %FS.
+            MISSING_FORMAT,
+            // Coordinate data before the first %MO.
+            MISSING_UNITS,
+            // G36 not followed by G37, either before another G36 or the end of file.
+            UNCLOSED_REGION,
+            // G37 outside of region.
+            UNOPENED_REGION,
+            // File doesn't end with M02.
+            MISSING_END,
+        };
+
+        Code                code;
+        // Index of the offending node in File::getNodes(), for MISSING_END the node
+        // count.
+        std::size_t         node;
+        // Source range of the node, when the File has spans.
+        std::optional<Span> span;
+        std::string         message;
+
+        static std::string_view code_name(Code code);
+    };
+
+    /**
+     * Checks of a parsed File which go beyond syntax, done in a single pass over its
+     * nodes. Apertures are tracked in a bitset indexed by aperture number, so the pass
+     * runs close to parse speed.
+     */
+    class Validator {
+      public:
+        // Aperture numbers below this are tracked in bitsets, larger ones in a hash set.
+        static constexpr uint32_t dense_apertures = 1 << 16;
+
+        /**
+         * Diagnostics ordered by node index, empty for a valid file.
+         */
+        static std::vector<Diagnostic> validate(const File& file);
+    };
+} // namespace gerber
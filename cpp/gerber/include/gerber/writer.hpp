@@ -0,0 +1,21 @@
+#pragma once
+#include "gerber/ast/ast.hpp"
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+namespace gerber {
+    /**
+     * Serializes AST back into Gerber source code. Each command is written on
+     * its own line, coordinates are kept on the same line as the operation they
+     * belong to, so canonical input roundtrips byte-for-byte.
+     */
+    class Writer {
+      public:
+        // Output is flushed to streams in chunks of this size.
+        static constexpr size_t flush_threshold = 64 * 1024;
+
+        std::string write(const File& file) const;
+        void        write(const File& file, std::ostream& output) const;
+    };
+} // namespace gerber
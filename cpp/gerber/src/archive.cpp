@@ -0,0 +1,389 @@
+#include "gerber/archive.hpp"
+#include "gerber/errors.hpp"
+#include "gerber/parser.hpp"
+#include "gerber/thread_pool.hpp"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fmt/format.h>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef GERBER_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+namespace gerber {
+
+    namespace {
+        constexpr uint32_t zip_local_header_signature     = 0x04034b50;
+        constexpr uint32_t zip_central_header_signature   = 0x02014b50;
+        constexpr uint32_t zip_end_of_directory_signature = 0x06054b50;
+        constexpr size_t   zip_local_header_size          = 30;
+        constexpr size_t   zip_central_header_size        = 46;
+        constexpr size_t   zip_end_of_directory_size      = 22;
+        constexpr size_t   zip_max_comment_size           = 0xFFFF;
+        constexpr uint32_t zip64_marker                   = 0xFFFFFFFF;
+        // Smallest initial output buffer, used also when size of inflated data is unknown.
+        constexpr size_t   inflate_chunk_size             = 256 * 1024;
+        // Deflate can't compress better than this, caps size hints read from archives.
+        constexpr size_t   max_deflate_ratio              = 1032;
+
+        constexpr std::array<std::string_view, 22> gerber_extensions = {
+            ".gbr", ".ger", ".gerber", ".pho", ".art", ".gtl", ".gbl", ".gto",
+            ".gbo", ".gts", ".gbs", ".gtp", ".gbp", ".gko", ".gm1", ".gml",
+            ".g1",  ".g2",  ".g3",  ".g4",  ".gd1", ".gg1",
+        };
+
+        uint16_t read_u16(const std::string_view& data, size_t offset) {
+            if (offset + 2 > data.size()) {
+                throw ArchiveError("Unexpected end of zip archive");
+            }
+            return static_cast<uint16_t>(
+                static_cast<uint8_t>(data[offset]) | (static_cast<uint8_t>(data[offset + 1]) << 8)
+            );
+        }
+
+        uint32_t read_u32(const std::string_view& data, size_t offset) {
+            return static_cast<uint32_t>(read_u16(data, offset)) |
+                   (static_cast<uint32_t>(read_u16(data, offset + 2)) << 16);
+        }
+
+        std::string read_binary_file(const std::string& path) {
+            std::ifstream input(path, std::ios::binary);
+            if (!input) {
+                throw ArchiveError(fmt::format("Failed to open '{}'", path));
+            }
+            return std::string(std::istreambuf_iterator<char>(input), {});
+        }
+
+#ifdef GERBER_WITH_ZLIB
+        /**
+         * Inflate data into output, which is resized to fit. For gzip streams
+         * (window_bits with 32 added) all concatenated members are inflated. Output
+         * never grows past limit + 1 bytes, more data than limit is an ArchiveError.
+         */
+        void inflate_into(
+            const std::string_view& data,
+            int                     window_bits,
+            size_t                  size_hint,
+            size_t                  limit,
+            std::string&            output
+        ) {
+            z_stream stream{};
+            if (inflateInit2(&stream, window_bits) != Z_OK) {
+                throw ArchiveError("Failed to initialize zlib");
+            }
+            // One byte over the limit is enough to tell that data exceeds it.
+            const size_t capacity = limit == SIZE_MAX ? limit : limit + 1;
+            size_hint             = std::min(size_hint, data.size() * max_deflate_ratio);
+            output.resize(std::min(std::max(size_hint, inflate_chunk_size), capacity));
+
+            size_t input_offset  = 0;
+            size_t output_offset = 0;
+            int    status        = Z_OK;
+
+            while (true) {
+                if (output_offset == output.size()) {
+                    if (output_offset == capacity) {
+                        break;
+                    }
+                    output.resize(std::min(output.size() * 2, capacity));
+                }
+                // zlib counts are 32 bit, large buffers are processed in slices.
+                const auto input_size  = std::min<size_t>(data.size() - input_offset, UINT32_MAX);
+                const auto output_size =
+                    std::min<size_t>(output.size() - output_offset, UINT32_MAX);
+
+                stream.next_in =
+                    reinterpret_cast<Bytef*>(const_cast<char*>(data.data())) + input_offset;
+                stream.avail_in  = static_cast<uInt>(input_size);
+                stream.next_out  = reinterpret_cast<Bytef*>(output.data()) + output_offset;
+                stream.avail_out = static_cast<uInt>(output_size);
+
+                status = inflate(&stream, Z_NO_FLUSH);
+
+                input_offset  += input_size - stream.avail_in;
+                output_offset += output_size - stream.avail_out;
+
+                if (status == Z_STREAM_END) {
+                    // Next gzip member may follow, raw deflate streams end here.
+                    if (window_bits < 0 || input_offset >= data.size() ||
+                        !is_gzip(data.substr(input_offset))) {
+                        break;
+                    }
+                    inflateReset(&stream);
+                    continue;
+                }
+                if (status != Z_OK && status != Z_BUF_ERROR) {
+                    break;
+                }
+                if (status == Z_BUF_ERROR && input_offset >= data.size()) {
+                    break;
+                }
+            }
+            inflateEnd(&stream);
+
+            if (output_offset > limit) {
+                throw ArchiveError(fmt::format("Inflated data exceeds {} bytes", limit));
+            }
+            if (status != Z_STREAM_END) {
+                throw ArchiveError(fmt::format("Corrupted compressed data (zlib error {})", status));
+            }
+            output.resize(output_offset);
+        }
+#else
+        [[noreturn]] void throw_no_zlib() {
+            throw ArchiveError("Compressed data requires library built with zlib");
+        }
+#endif
+    } // namespace
+
+    bool has_zlib() {
+#ifdef GERBER_WITH_ZLIB
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    bool is_gzip(const std::string_view& data) {
+        return data.size() >= 2 && static_cast<uint8_t>(data[0]) == 0x1f &&
+               static_cast<uint8_t>(data[1]) == 0x8b;
+    }
+
+    std::string decompress_gzip(const std::string_view& data, std::size_t max_size) {
+#ifdef GERBER_WITH_ZLIB
+        // Trailer holds size of the last member modulo 2^32, good enough as a hint.
+        const size_t size_hint = data.size() >= 4 ? read_u32(data, data.size() - 4) : 0;
+
+        std::string output;
+        inflate_into(data, 15 + 32, size_hint, max_size, output);
+        return output;
+#else
+        (void)data;
+        (void)max_size;
+        throw_no_zlib();
+#endif
+    }
+
+    std::string read_source_file(const std::string& path, std::size_t max_size) {
+        auto data = read_binary_file(path);
+        if (is_gzip(data)) {
+            return decompress_gzip(data, max_size);
+        }
+        return data;
+    }
+
+    // ZipEntry
+
+    bool ZipEntry::isDirectory() const {
+        return !name.empty() && name.back() == '/';
+    }
+
+    // ZipArchive
+
+    ZipArchive::ZipArchive(std::string data_) :
+        data(std::move(data_)),
+        entries() {
+        read_central_directory();
+    }
+
+    ZipArchive ZipArchive::open(const std::string& path) {
+        return ZipArchive(read_binary_file(path));
+    }
+
+    const std::vector<ZipEntry>& ZipArchive::getEntries() const {
+        return entries;
+    }
+
+    const ZipEntry* ZipArchive::find(const std::string_view& name) const {
+        const auto found = std::find_if(entries.begin(), entries.end(), [&](const auto& entry) {
+            return entry.name == name;
+        });
+        return found == entries.end() ? nullptr : &*found;
+    }
+
+    void ZipArchive::read_central_directory() {
+        const std::string_view view = data;
+        if (view.size() < zip_end_of_directory_size) {
+            throw ArchiveError("File is too small to be a zip archive");
+        }
+
+        // End of central directory record is followed by comment of unknown length.
+        const size_t          last  = view.size() - zip_end_of_directory_size;
+        const size_t          first = last > zip_max_comment_size ? last - zip_max_comment_size : 0;
+        std::optional<size_t> eocd;
+        for (size_t offset = last + 1; offset-- > first;) {
+            if (read_u32(view, offset) == zip_end_of_directory_signature) {
+                eocd = offset;
+                break;
+            }
+        }
+        if (!eocd.has_value()) {
+            throw ArchiveError("End of central directory not found, not a zip archive");
+        }
+
+        const uint16_t entry_count      = read_u16(view, *eocd + 10);
+        const uint32_t directory_offset = read_u32(view, *eocd + 16);
+        if (directory_offset == zip64_marker) {
+            throw ArchiveError("Zip64 archives are not supported");
+        }
+
+        entries.reserve(entry_count);
+        size_t offset = directory_offset;
+        for (uint16_t i = 0; i < entry_count; i++) {
+            if (read_u32(view, offset) != zip_central_header_signature) {
+                throw ArchiveError("Corrupted zip central directory");
+            }
+            const uint16_t method        = read_u16(view, offset + 10);
+            const uint32_t crc32         = read_u32(view, offset + 16);
+            const uint32_t compressed    = read_u32(view, offset + 20);
+            const uint32_t uncompressed  = read_u32(view, offset + 24);
+            const uint16_t name_size     = read_u16(view, offset + 28);
+            const uint16_t extra_size    = read_u16(view, offset + 30);
+            const uint16_t comment_size  = read_u16(view, offset + 32);
+            const uint32_t header_offset = read_u32(view, offset + 42);
+
+            if (compressed == zip64_marker || uncompressed == zip64_marker ||
+                header_offset == zip64_marker) {
+                throw ArchiveError("Zip64 archives are not supported");
+            }
+            if (offset + zip_central_header_size + name_size > view.size()) {
+                throw ArchiveError("Unexpected end of zip archive");
+            }
+            entries.push_back(ZipEntry{
+                std::string(view.substr(offset + zip_central_header_size, name_size)),
+                static_cast<ZipEntry::Method>(method),
+                crc32,
+                compressed,
+                uncompressed,
+                header_offset,
+            });
+            offset += zip_central_header_size + name_size + extra_size + comment_size;
+        }
+    }
+
+    std::string ZipArchive::read(const ZipEntry& entry) const {
+        const std::string_view view   = data;
+        const size_t           header = entry.local_header_offset;
+        if (read_u32(view, header) != zip_local_header_signature) {
+            throw ArchiveError(fmt::format("Corrupted zip local header of '{}'", entry.name));
+        }
+        const size_t begin = header + zip_local_header_size + read_u16(view, header + 26) +
+                             read_u16(view, header + 28);
+        if (begin + entry.compressed_size > view.size()) {
+            throw ArchiveError(fmt::format("Unexpected end of zip member '{}'", entry.name));
+        }
+        const auto compressed = view.substr(begin, entry.compressed_size);
+
+        std::string output;
+        switch (entry.method) {
+            case ZipEntry::STORED:
+                output = std::string(compressed);
+                break;
+            case ZipEntry::DEFLATED:
+#ifdef GERBER_WITH_ZLIB
+                inflate_into(
+                    compressed, -15, entry.uncompressed_size, entry.uncompressed_size, output
+                );
+                break;
+#else
+                throw_no_zlib();
+#endif
+            default:
+                throw ArchiveError(fmt::format(
+                    "Unsupported compression method {} of '{}'",
+                    static_cast<int>(entry.method),
+                    entry.name
+                ));
+        }
+
+#ifdef GERBER_WITH_ZLIB
+        const auto checksum = ::crc32(
+            ::crc32(0L, Z_NULL, 0), reinterpret_cast<const Bytef*>(output.data()), output.size()
+        );
+        if (checksum != entry.crc32) {
+            throw ArchiveError(fmt::format("CRC mismatch of zip member '{}'", entry.name));
+        }
+#endif
+        return output;
+    }
+
+    // Package
+
+    bool Package::is_gerber_name(const std::string_view& name) {
+        const auto dot = name.rfind('.');
+        if (dot == std::string_view::npos) {
+            return false;
+        }
+        std::string extension(name.substr(dot));
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) {
+            return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        });
+        return std::find(gerber_extensions.begin(), gerber_extensions.end(), extension) !=
+               gerber_extensions.end();
+    }
+
+    std::vector<PackageMember> Package::parse(
+        const ZipArchive&               archive,
+        const Parser&                   parser,
+        const std::vector<std::string>& names,
+        std::size_t                     threads
+    ) {
+        std::vector<const ZipEntry*> selected;
+        if (names.empty()) {
+            for (const auto& entry : archive.getEntries()) {
+                if (!entry.isDirectory() && is_gerber_name(entry.name)) {
+                    selected.push_back(&entry);
+                }
+            }
+        } else {
+            for (const auto& name : names) {
+                const auto* entry = archive.find(name);
+                if (entry == nullptr) {
+                    throw ArchiveError(fmt::format("Zip archive has no member '{}'", name));
+                }
+                selected.push_back(entry);
+            }
+        }
+
+        if (threads == 0) {
+            threads = std::thread::hardware_concurrency();
+        }
+        std::vector<std::optional<File>> files(selected.size());
+        std::vector<std::exception_ptr>  errors(selected.size());
+        {
+            // Each worker inflates and parses whole member, pool waits for all of them.
+            ThreadPool pool(std::max<size_t>(1, std::min(threads, selected.size())));
+            for (size_t i = 0; i < selected.size(); i++) {
+                pool.submit([&, i]() {
+                    try {
+                        files[i].emplace(parser.parse(archive.read(*selected[i])));
+                    } catch (...) {
+                        errors[i] = std::current_exception();
+                    }
+                });
+            }
+        }
+
+        std::vector<PackageMember> members;
+        members.reserve(selected.size());
+        for (size_t i = 0; i < selected.size(); i++) {
+            if (errors[i]) {
+                std::rethrow_exception(errors[i]);
+            }
+            members.push_back(PackageMember{selected[i]->name, std::move(*files[i])});
+        }
+        return members;
+    }
+} // namespace gerber
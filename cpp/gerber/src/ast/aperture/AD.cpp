@@ -1,14 +1,31 @@
 #include "gerber/ast/aperture/AD.hpp"
+#include "gerber/ast/memory.hpp"
+#include "gerber/ast/visitor.hpp"
+#include <string>
+#include <string_view>
+#include <utility>
 
 namespace gerber {
-    AD::AD(const std::string_view& apertureId_) :
-        apertureId(apertureId_) {}
+    AD::AD(Text apertureId_) :
+        apertureId(std::move(apertureId_)) {}
 
     std::string AD::getNodeName() const {
         return "AD";
     }
 
+    void AD::visit(Visitor& visitor) const {
+        visitor.on_ad(*this);
+    }
+
+    size_t AD::memory_usage() const {
+        return sizeof(AD) + heap_usage(apertureId);
+    }
+
     std::string AD::getApertureId() const {
-        return apertureId;
+        return apertureId.str();
+    }
+
+    std::string_view AD::getApertureIdView() const {
+        return apertureId.view();
     }
 } // namespace gerber
\ No newline at end of file
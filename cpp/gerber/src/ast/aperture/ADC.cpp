@@ -1,11 +1,11 @@
 
 #include "gerber/ast/aperture/ADC.hpp"
+#include "gerber/ast/visitor.hpp"
+#include <utility>
 
 namespace gerber {
-    ADC::ADC(
-        const std::string_view& apertureId_, double diameter_, std::optional<double> holeDiameter_
-    ) :
-        AD(apertureId_),
+    ADC::ADC(Text apertureId_, double diameter_, std::optional<double> holeDiameter_) :
+        AD(std::move(apertureId_)),
         diameter(diameter_),
         holeDiameter(holeDiameter_) {}
 
@@ -13,6 +13,14 @@ namespace gerber {
         return "ADC";
     }
 
+    void ADC::visit(Visitor& visitor) const {
+        visitor.on_adc(*this);
+    }
+
+    size_t ADC::memory_usage() const {
+        return sizeof(ADC) - sizeof(AD) + AD::memory_usage();
+    }
+
     double ADC::getDiameter() const {
         return diameter;
     }
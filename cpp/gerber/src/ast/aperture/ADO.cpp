@@ -1,14 +1,16 @@
 
 #include "gerber/ast/aperture/ADO.hpp"
+#include "gerber/ast/visitor.hpp"
+#include <utility>
 
 namespace gerber {
     ADO::ADO(
-        const std::string_view& apertureId_,
-        double                  width_,
-        double                  height_,
-        std::optional<double>   holeDiameter_
+        Text                  apertureId_,
+        double                width_,
+        double                height_,
+        std::optional<double> holeDiameter_
     ) :
-        AD(apertureId_),
+        AD(std::move(apertureId_)),
         width(width_),
         height(height_),
         holeDiameter(holeDiameter_) {}
@@ -17,6 +19,14 @@ namespace gerber {
         return "ADO";
     }
 
+    void ADO::visit(Visitor& visitor) const {
+        visitor.on_ado(*this);
+    }
+
+    size_t ADO::memory_usage() const {
+        return sizeof(ADO) - sizeof(AD) + AD::memory_usage();
+    }
+
     double ADO::getWidth() const {
         return width;
     }
@@ -1,15 +1,17 @@
 
 #include "gerber/ast/aperture/ADP.hpp"
+#include "gerber/ast/visitor.hpp"
+#include <utility>
 
 namespace gerber {
     ADP::ADP(
-        const std::string_view& apertureId,
-        double                  outerDiameter,
-        double                  verticesCount,
-        std::optional<double>   rotation,
-        std::optional<double>   holeDiameter
+        Text                  apertureId,
+        double                outerDiameter,
+        double                verticesCount,
+        std::optional<double> rotation,
+        std::optional<double> holeDiameter
     ) :
-        AD(apertureId),
+        AD(std::move(apertureId)),
         outerDiameter(outerDiameter),
         verticesCount(verticesCount),
         rotation(rotation),
@@ -19,6 +21,14 @@ namespace gerber {
         return "ADP";
     }
 
+    void ADP::visit(Visitor& visitor) const {
+        visitor.on_adp(*this);
+    }
+
+    size_t ADP::memory_usage() const {
+        return sizeof(ADP) - sizeof(AD) + AD::memory_usage();
+    }
+
     double ADP::getOuterDiameter() const {
         return outerDiameter;
     }
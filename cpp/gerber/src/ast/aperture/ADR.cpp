@@ -1,14 +1,16 @@
 
 #include "gerber/ast/aperture/ADR.hpp"
+#include "gerber/ast/visitor.hpp"
+#include <utility>
 
 namespace gerber {
     ADR::ADR(
-        const std::string_view& apertureId_,
-        double                  width_,
-        double                  height_,
-        std::optional<double>   holeDiameter_
+        Text                  apertureId_,
+        double                width_,
+        double                height_,
+        std::optional<double> holeDiameter_
     ) :
-        AD(apertureId_),
+        AD(std::move(apertureId_)),
         width(width_),
         height(height_),
         holeDiameter(holeDiameter_) {}
@@ -17,6 +19,14 @@ namespace gerber {
         return "ADR";
     }
 
+    void ADR::visit(Visitor& visitor) const {
+        visitor.on_adr(*this);
+    }
+
+    size_t ADR::memory_usage() const {
+        return sizeof(ADR) - sizeof(AD) + AD::memory_usage();
+    }
+
     double ADR::getWidth() const {
         return width;
     }
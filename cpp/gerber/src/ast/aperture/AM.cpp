@@ -1,4 +1,6 @@
 #include "gerber/ast/aperture/AM.hpp"
+#include "gerber/ast/memory.hpp"
+#include "gerber/ast/visitor.hpp"
 
 namespace gerber {
     AM::AM(
@@ -14,6 +16,19 @@ namespace gerber {
         return "AM";
     }
 
+    void AM::visit(Visitor& visitor) const {
+        visitor.on_am(*this);
+    }
+
+    size_t AM::memory_usage() const {
+        size_t usage = sizeof(AM) + shared_usage(amOpen) + heap_usage(primitives) +
+                       shared_usage(amClose);
+        for (const auto& primitive : primitives) {
+            usage += shared_usage(primitive);
+        }
+        return usage;
+    }
+
     std::shared_ptr<AMopen> AM::getAmOpen() const {
         return amOpen;
     }
@@ -1,4 +1,5 @@
 #include "gerber/ast/aperture/AMclose.hpp"
+#include "gerber/ast/visitor.hpp"
 
 namespace gerber {
     AMclose::AMclose() {}
@@ -6,4 +7,12 @@ namespace gerber {
     std::string AMclose::getNodeName() const {
         return "AMclose";
     }
+
+    void AMclose::visit(Visitor& visitor) const {
+        visitor.on_am_close(*this);
+    }
+
+    size_t AMclose::memory_usage() const {
+        return sizeof(AMclose);
+    }
 } // namespace gerber
\ No newline at end of file
@@ -1,14 +1,31 @@
 #include "gerber/ast/aperture/AMopen.hpp"
+#include "gerber/ast/memory.hpp"
+#include "gerber/ast/visitor.hpp"
+#include <string>
+#include <string_view>
+#include <utility>
 
 namespace gerber {
-    AMopen::AMopen(const std::string_view& apertureId_) :
-        apertureId(apertureId_) {}
+    AMopen::AMopen(Text apertureId_) :
+        apertureId(std::move(apertureId_)) {}
 
     std::string AMopen::getNodeName() const {
         return "AMopen";
     }
 
+    void AMopen::visit(Visitor& visitor) const {
+        visitor.on_am_open(*this);
+    }
+
+    size_t AMopen::memory_usage() const {
+        return sizeof(AMopen) + heap_usage(apertureId);
+    }
+
     std::string AMopen::getApertureId() const {
-        return apertureId;
+        return apertureId.str();
+    }
+
+    std::string_view AMopen::getApertureIdView() const {
+        return apertureId.view();
     }
 } // namespace gerber
\ No newline at end of file
@@ -1,7 +1,16 @@
 #include "gerber/ast/command.hpp"
+#include "gerber/ast/visitor.hpp"
 
 namespace gerber {
     std::string Command::getNodeName() const {
         return "Command";
     }
+
+    void Command::visit(Visitor& visitor) const {
+        visitor.on_command(*this);
+    }
+
+    size_t Command::memory_usage() const {
+        return sizeof(Command);
+    }
 } // namespace gerber
\ No newline at end of file
@@ -1,7 +1,16 @@
 #include "gerber/ast/d_codes/D01.hpp"
+#include "gerber/ast/visitor.hpp"
 
 namespace gerber {
     std::string D01::getNodeName() const {
         return "D01";
     }
+
+    void D01::visit(Visitor& visitor) const {
+        visitor.on_d01(*this);
+    }
+
+    size_t D01::memory_usage() const {
+        return sizeof(D01);
+    }
 } // namespace gerber
\ No newline at end of file
@@ -1,7 +1,16 @@
 #include "gerber/ast/d_codes/D02.hpp"
+#include "gerber/ast/visitor.hpp"
 
 namespace gerber {
     std::string D02::getNodeName() const {
         return "D02";
     }
+
+    void D02::visit(Visitor& visitor) const {
+        visitor.on_d02(*this);
+    }
+
+    size_t D02::memory_usage() const {
+        return sizeof(D02);
+    }
 } // namespace gerber
\ No newline at end of file
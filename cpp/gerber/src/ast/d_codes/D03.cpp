@@ -1,7 +1,16 @@
 #include "gerber/ast/d_codes/D03.hpp"
+#include "gerber/ast/visitor.hpp"
 
 namespace gerber {
     std::string D03::getNodeName() const {
         return "D03";
     }
+
+    void D03::visit(Visitor& visitor) const {
+        visitor.on_d03(*this);
+    }
+
+    size_t D03::memory_usage() const {
+        return sizeof(D03);
+    }
 } // namespace gerber
\ No newline at end of file
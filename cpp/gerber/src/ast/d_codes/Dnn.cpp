@@ -1,14 +1,31 @@
 #include "gerber/ast/d_codes/Dnn.hpp"
+#include "gerber/ast/memory.hpp"
+#include "gerber/ast/visitor.hpp"
+#include <string>
+#include <string_view>
+#include <utility>
 
 namespace gerber {
-    Dnn::Dnn(const std::string_view& aperture_id_) :
-        aperture_id(aperture_id_) {}
+    Dnn::Dnn(Text aperture_id_) :
+        aperture_id(std::move(aperture_id_)) {}
 
     std::string Dnn::getNodeName() const {
         return "Dnn";
     }
 
+    void Dnn::visit(Visitor& visitor) const {
+        visitor.on_dnn(*this);
+    }
+
+    size_t Dnn::memory_usage() const {
+        return sizeof(Dnn) + heap_usage(aperture_id);
+    }
+
     std::string Dnn::getApertureId() const {
-        return aperture_id;
+        return aperture_id.str();
+    }
+
+    std::string_view Dnn::getApertureIdView() const {
+        return aperture_id.view();
     }
 } // namespace gerber
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include "gerber/ast/d_codes/operation.hpp"
+#include "gerber/ast/memory.hpp"
+#include "gerber/ast/visitor.hpp"
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace gerber {
+    Operation::Operation(
+        Kind                kind_,
+        std::optional<Text> x_,
+        std::optional<Text> y_,
+        std::optional<Text> i_,
+        std::optional<Text> j_
+    ) :
+        kind(kind_),
+        x(std::move(x_)),
+        y(std::move(y_)),
+        i(std::move(i_)),
+        j(std::move(j_)) {}
+
+    std::string Operation::getNodeName() const {
+        return "Operation";
+    }
+
+    void Operation::visit(Visitor& visitor) const {
+        visitor.on_operation(*this);
+    }
+
+    size_t Operation::memory_usage() const {
+        return sizeof(Operation) + heap_usage(x) + heap_usage(y) + heap_usage(i) + heap_usage(j);
+    }
+
+    Operation::Kind Operation::getKind() const {
+        return kind;
+    }
+
+    namespace {
+        std::optional<std::string> text_string(const std::optional<Text>& value) {
+            if (value.has_value()) {
+                return value->str();
+            }
+            return std::nullopt;
+        }
+
+        std::optional<std::string_view> text_view(const std::optional<Text>& value) {
+            if (value.has_value()) {
+                return value->view();
+            }
+            return std::nullopt;
+        }
+    } // namespace
+
+    std::optional<std::string> Operation::getX() const {
+        return text_string(x);
+    }
+
+    std::optional<std::string> Operation::getY() const {
+        return text_string(y);
+    }
+
+    std::optional<std::string> Operation::getI() const {
+        return text_string(i);
+    }
+
+    std::optional<std::string> Operation::getJ() const {
+        return text_string(j);
+    }
+
+    std::optional<std::string_view> Operation::getXView() const {
+        return text_view(x);
+    }
+
+    std::optional<std::string_view> Operation::getYView() const {
+        return text_view(y);
+    }
+
+    std::optional<std::string_view> Operation::getIView() const {
+        return text_view(i);
+    }
+
+    std::optional<std::string_view> Operation::getJView() const {
+        return text_view(j);
+    }
+} // namespace gerber
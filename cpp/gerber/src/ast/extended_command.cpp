@@ -1,7 +1,16 @@
 #include "gerber/ast/extended_command.hpp"
+#include "gerber/ast/visitor.hpp"
 
 namespace gerber {
     std::string ExtendedCommand::getNodeName() const {
         return "ExtendedCommand";
     }
+
+    void ExtendedCommand::visit(Visitor& visitor) const {
+        visitor.on_extended_command(*this);
+    }
+
+    size_t ExtendedCommand::memory_usage() const {
+        return sizeof(ExtendedCommand);
+    }
 } // namespace gerber
\ No newline at end of file
@@ -1,20 +1,79 @@
 #include "gerber/ast/file.hpp"
+#include "gerber/ast/memory.hpp"
+#include "gerber/ast/visitor.hpp"
+#include "gerber/scanner.hpp"
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <vector>
 
 namespace gerber {
     File::File(File&& other) :
-        nodes(std::move(other.nodes)) {}
+        nodes(std::move(other.nodes)),
+        source(std::move(other.source)),
+        spans(std::move(other.spans)) {}
 
     File::File(std::vector<std::shared_ptr<Node>>&& nodes) :
-        nodes(std::move(nodes)) {}
+        nodes(std::move(nodes)),
+        source(),
+        spans() {}
+
+    File::File(
+        std::vector<std::shared_ptr<Node>>&& nodes, std::shared_ptr<const std::string> source
+    ) :
+        nodes(std::move(nodes)),
+        source(std::move(source)),
+        spans() {}
+
+    File::File(
+        std::vector<std::shared_ptr<Node>>&& nodes,
+        std::shared_ptr<const std::string>   source,
+        std::vector<Span>&&                  spans
+    ) :
+        nodes(std::move(nodes)),
+        source(std::move(source)),
+        spans(std::move(spans)) {}
 
     std::vector<std::shared_ptr<Node>>& File::getNodes() {
         return nodes;
     }
 
+    const std::vector<std::shared_ptr<Node>>& File::getNodes() const {
+        return nodes;
+    }
+
+    const std::shared_ptr<const std::string>& File::getSource() const {
+        return source;
+    }
+
+    void File::setSource(std::shared_ptr<const std::string> source_) {
+        source = std::move(source_);
+    }
+
+    std::vector<Span>& File::getSpans() {
+        return spans;
+    }
+
+    const std::vector<Span>& File::getSpans() const {
+        return spans;
+    }
+
     std::string File::getNodeName() const {
         return "File";
     }
+
+    void File::visit(Visitor& visitor) const {
+        visitor.on_file(*this);
+    }
+
+    size_t File::memory_usage() const {
+        size_t usage = sizeof(File) + heap_usage(nodes) + heap_usage(spans);
+        if (source) {
+            usage += shared_control_block_size + sizeof(std::string) + heap_usage(*source);
+        }
+        for (const auto& node : nodes) {
+            usage += shared_usage(node);
+        }
+        return usage;
+    }
 } // namespace gerber
\ No newline at end of file
@@ -1,7 +1,16 @@
 #include "gerber/ast/g_codes/G01.hpp"
+#include "gerber/ast/visitor.hpp"
 
 namespace gerber {
     std::string G01::getNodeName() const {
         return "G01";
     }
+
+    void G01::visit(Visitor& visitor) const {
+        visitor.on_g01(*this);
+    }
+
+    size_t G01::memory_usage() const {
+        return sizeof(G01);
+    }
 } // namespace gerber
\ No newline at end of file
@@ -1,7 +1,16 @@
 #include "gerber/ast/g_codes/G02.hpp"
+#include "gerber/ast/visitor.hpp"
 
 namespace gerber {
     std::string G02::getNodeName() const {
         return "G02";
     }
+
+    void G02::visit(Visitor& visitor) const {
+        visitor.on_g02(*this);
+    }
+
+    size_t G02::memory_usage() const {
+        return sizeof(G02);
+    }
 } // namespace gerber
\ No newline at end of file
@@ -1,7 +1,16 @@
 #include "gerber/ast/g_codes/G03.hpp"
+#include "gerber/ast/visitor.hpp"
 
 namespace gerber {
     std::string G03::getNodeName() const {
         return "G03";
     }
+
+    void G03::visit(Visitor& visitor) const {
+        visitor.on_g03(*this);
+    }
+
+    size_t G03::memory_usage() const {
+        return sizeof(G03);
+    }
 } // namespace gerber
\ No newline at end of file
@@ -1,11 +1,31 @@
 #include "gerber/ast/g_codes/G04.hpp"
+#include "gerber/ast/memory.hpp"
+#include "gerber/ast/visitor.hpp"
 #include <string>
+#include <string_view>
+#include <utility>
 
 namespace gerber {
-    G04::G04(std::string comment) :
-        comment(comment) {}
+    G04::G04(Text comment_) :
+        comment(std::move(comment_)) {}
 
     std::string G04::getNodeName() const {
         return "G04";
     }
+
+    void G04::visit(Visitor& visitor) const {
+        visitor.on_g04(*this);
+    }
+
+    size_t G04::memory_usage() const {
+        return sizeof(G04) + heap_usage(comment);
+    }
+
+    std::string G04::getComment() const {
+        return comment.str();
+    }
+
+    std::string_view G04::getCommentView() const {
+        return comment.view();
+    }
 } // namespace gerber
\ No newline at end of file
@@ -1,7 +1,16 @@
 #include "gerber/ast/g_codes/G36.hpp"
+#include "gerber/ast/visitor.hpp"
 
 namespace gerber {
     std::string G36::getNodeName() const {
         return "G36";
     }
+
+    void G36::visit(Visitor& visitor) const {
+        visitor.on_g36(*this);
+    }
+
+    size_t G36::memory_usage() const {
+        return sizeof(G36);
+    }
 } // namespace gerber
\ No newline at end of file
@@ -1,7 +1,16 @@
 #include "gerber/ast/g_codes/G37.hpp"
+#include "gerber/ast/visitor.hpp"
 
 namespace gerber {
     std::string G37::getNodeName() const {
         return "G37";
     }
+
+    void G37::visit(Visitor& visitor) const {
+        visitor.on_g37(*this);
+    }
+
+    size_t G37::memory_usage() const {
+        return sizeof(G37);
+    }
 } // namespace gerber
\ No newline at end of file
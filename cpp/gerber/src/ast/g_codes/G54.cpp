@@ -1,7 +1,16 @@
 #include "gerber/ast/g_codes/G54.hpp"
+#include "gerber/ast/visitor.hpp"
 
 namespace gerber {
     std::string G54::getNodeName() const {
         return "G54";
     }
+
+    void G54::visit(Visitor& visitor) const {
+        visitor.on_g54(*this);
+    }
+
+    size_t G54::memory_usage() const {
+        return sizeof(G54);
+    }
 } // namespace gerber
\ No newline at end of file
@@ -1,7 +1,16 @@
 #include "gerber/ast/g_codes/G55.hpp"
+#include "gerber/ast/visitor.hpp"
 
 namespace gerber {
     std::string G55::getNodeName() const {
         return "G55";
     }
+
+    void G55::visit(Visitor& visitor) const {
+        visitor.on_g55(*this);
+    }
+
+    size_t G55::memory_usage() const {
+        return sizeof(G55);
+    }
 } // namespace gerber
\ No newline at end of file
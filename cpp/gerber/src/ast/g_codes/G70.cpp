@@ -1,7 +1,16 @@
 #include "gerber/ast/g_codes/G70.hpp"
+#include "gerber/ast/visitor.hpp"
 
 namespace gerber {
     std::string G70::getNodeName() const {
         return "G70";
     }
+
+    void G70::visit(Visitor& visitor) const {
+        visitor.on_g70(*this);
+    }
+
+    size_t G70::memory_usage() const {
+        return sizeof(G70);
+    }
 } // namespace gerber
\ No newline at end of file
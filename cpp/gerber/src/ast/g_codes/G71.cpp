@@ -1,7 +1,16 @@
 #include "gerber/ast/g_codes/G71.hpp"
+#include "gerber/ast/visitor.hpp"
 
 namespace gerber {
     std::string G71::getNodeName() const {
         return "G71";
     }
+
+    void G71::visit(Visitor& visitor) const {
+        visitor.on_g71(*this);
+    }
+
+    size_t G71::memory_usage() const {
+        return sizeof(G71);
+    }
 } // namespace gerber
\ No newline at end of file
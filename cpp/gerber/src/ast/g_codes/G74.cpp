@@ -1,7 +1,16 @@
 #include "gerber/ast/g_codes/G74.hpp"
+#include "gerber/ast/visitor.hpp"
 
 namespace gerber {
     std::string G74::getNodeName() const {
         return "G74";
     }
+
+    void G74::visit(Visitor& visitor) const {
+        visitor.on_g74(*this);
+    }
+
+    size_t G74::memory_usage() const {
+        return sizeof(G74);
+    }
 } // namespace gerber
\ No newline at end of file
@@ -1,7 +1,16 @@
 #include "gerber/ast/g_codes/G75.hpp"
+#include "gerber/ast/visitor.hpp"
 
 namespace gerber {
     std::string G75::getNodeName() const {
         return "G75";
     }
+
+    void G75::visit(Visitor& visitor) const {
+        visitor.on_g75(*this);
+    }
+
+    size_t G75::memory_usage() const {
+        return sizeof(G75);
+    }
 } // namespace gerber
\ No newline at end of file
@@ -1,7 +1,16 @@
 #include "gerber/ast/g_codes/G90.hpp"
+#include "gerber/ast/visitor.hpp"
 
 namespace gerber {
     std::string G90::getNodeName() const {
         return "G90";
     }
+
+    void G90::visit(Visitor& visitor) const {
+        visitor.on_g90(*this);
+    }
+
+    size_t G90::memory_usage() const {
+        return sizeof(G90);
+    }
 } // namespace gerber
\ No newline at end of file
@@ -1,7 +1,16 @@
 #include "gerber/ast/g_codes/G91.hpp"
+#include "gerber/ast/visitor.hpp"
 
 namespace gerber {
     std::string G91::getNodeName() const {
         return "G91";
     }
+
+    void G91::visit(Visitor& visitor) const {
+        visitor.on_g91(*this);
+    }
+
+    size_t G91::memory_usage() const {
+        return sizeof(G91);
+    }
 } // namespace gerber
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "gerber/ast/load/LP.hpp"
+#include "gerber/ast/visitor.hpp"
 #include "gerber/ast/enums.hpp"
 #include <string>
 
@@ -9,4 +10,12 @@ namespace gerber {
     std::string LP::getNodeName() const {
         return "LP";
     }
+
+    void LP::visit(Visitor& visitor) const {
+        visitor.on_lp(*this);
+    }
+
+    size_t LP::memory_usage() const {
+        return sizeof(LP);
+    }
 } // namespace gerber
\ No newline at end of file
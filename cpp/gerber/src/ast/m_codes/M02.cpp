@@ -1,7 +1,16 @@
 #include "gerber/ast/m_codes/M02.hpp"
+#include "gerber/ast/visitor.hpp"
 
 namespace gerber {
     std::string M02::getNodeName() const {
         return "M02";
     }
+
+    void M02::visit(Visitor& visitor) const {
+        visitor.on_m02(*this);
+    }
+
+    size_t M02::memory_usage() const {
+        return sizeof(M02);
+    }
 } // namespace gerber
\ No newline at end of file
@@ -1,7 +1,16 @@
 #include "gerber/ast/node.hpp"
+#include "gerber/ast/visitor.hpp"
 
 namespace gerber {
     std::string Node::getNodeName() const {
         return "Node";
     }
+
+    void Node::visit(Visitor& visitor) const {
+        visitor.on_node(*this);
+    }
+
+    size_t Node::memory_usage() const {
+        return sizeof(Node);
+    }
 } // namespace gerber
\ No newline at end of file
@@ -1,14 +1,31 @@
 #include "gerber/ast/other/coordinate.hpp"
+#include "gerber/ast/memory.hpp"
+#include "gerber/ast/visitor.hpp"
+#include <string>
+#include <string_view>
+#include <utility>
 
 namespace gerber {
-    Coordinate::Coordinate(const std::string_view& value) :
-        value(value) {}
+    Coordinate::Coordinate(Text value) :
+        value(std::move(value)) {}
 
     std::string Coordinate::getNodeName() const {
         return "Coordinate";
     }
 
+    void Coordinate::visit(Visitor& visitor) const {
+        visitor.on_coordinate(*this);
+    }
+
+    size_t Coordinate::memory_usage() const {
+        return sizeof(Coordinate) + heap_usage(value);
+    }
+
     std::string Coordinate::getValue() const {
-        return value;
+        return value.str();
+    }
+
+    std::string_view Coordinate::getValueView() const {
+        return value.view();
     }
 } // namespace gerber
\ No newline at end of file
@@ -1,7 +1,16 @@
 #include "gerber/ast/other/coordinate_i.hpp"
+#include "gerber/ast/visitor.hpp"
 
 namespace gerber {
     std::string CoordinateI::getNodeName() const {
         return "I";
     }
+
+    void CoordinateI::visit(Visitor& visitor) const {
+        visitor.on_coordinate_i(*this);
+    }
+
+    size_t CoordinateI::memory_usage() const {
+        return sizeof(CoordinateI) - sizeof(Coordinate) + Coordinate::memory_usage();
+    }
 } // namespace gerber
\ No newline at end of file
@@ -1,7 +1,16 @@
 #include "gerber/ast/other/coordinate_j.hpp"
+#include "gerber/ast/visitor.hpp"
 
 namespace gerber {
     std::string CoordinateJ::getNodeName() const {
         return "J";
     }
+
+    void CoordinateJ::visit(Visitor& visitor) const {
+        visitor.on_coordinate_j(*this);
+    }
+
+    size_t CoordinateJ::memory_usage() const {
+        return sizeof(CoordinateJ) - sizeof(Coordinate) + Coordinate::memory_usage();
+    }
 } // namespace gerber
\ No newline at end of file
@@ -1,7 +1,16 @@
 #include "gerber/ast/other/coordinate_x.hpp"
+#include "gerber/ast/visitor.hpp"
 
 namespace gerber {
     std::string CoordinateX::getNodeName() const {
         return "X";
     }
+
+    void CoordinateX::visit(Visitor& visitor) const {
+        visitor.on_coordinate_x(*this);
+    }
+
+    size_t CoordinateX::memory_usage() const {
+        return sizeof(CoordinateX) - sizeof(Coordinate) + Coordinate::memory_usage();
+    }
 } // namespace gerber
\ No newline at end of file
@@ -1,7 +1,16 @@
 #include "gerber/ast/other/coordinate_y.hpp"
+#include "gerber/ast/visitor.hpp"
 
 namespace gerber {
     std::string CoordinateY::getNodeName() const {
         return "Y";
     }
+
+    void CoordinateY::visit(Visitor& visitor) const {
+        visitor.on_coordinate_y(*this);
+    }
+
+    size_t CoordinateY::memory_usage() const {
+        return sizeof(CoordinateY) - sizeof(Coordinate) + Coordinate::memory_usage();
+    }
 } // namespace gerber
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "gerber/ast/properties/FS.hpp"
+#include "gerber/ast/visitor.hpp"
 
 namespace gerber {
     FS::FS(
@@ -19,4 +20,12 @@ namespace gerber {
     std::string FS::getNodeName() const {
         return "FS";
     }
+
+    void FS::visit(Visitor& visitor) const {
+        visitor.on_fs(*this);
+    }
+
+    size_t FS::memory_usage() const {
+        return sizeof(FS);
+    }
 } // namespace gerber
\ No newline at end of file
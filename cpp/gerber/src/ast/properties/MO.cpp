@@ -1,4 +1,5 @@
 #include "gerber/ast/properties/MO.hpp"
+#include "gerber/ast/visitor.hpp"
 #include "gerber/ast/enums.hpp"
 #include <string>
 #include <string_view>
@@ -10,4 +11,12 @@ namespace gerber {
     std::string MO::getNodeName() const {
         return "MO";
     }
+
+    void MO::visit(Visitor& visitor) const {
+        visitor.on_mo(*this);
+    }
+
+    size_t MO::memory_usage() const {
+        return sizeof(MO);
+    }
 } // namespace gerber
\ No newline at end of file
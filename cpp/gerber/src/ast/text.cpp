@@ -0,0 +1,130 @@
+#include "gerber/ast/text.hpp"
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+
+namespace gerber {
+    Text::Text() :
+        size(0),
+        storage(BORROWED),
+        borrowed("") {}
+
+    Text::Text(const std::string_view& value) :
+        Text() {
+        assign(value);
+    }
+
+    Text::Text(const std::string& value) :
+        Text(std::string_view(value)) {}
+
+    Text::Text(const char* value) :
+        Text(std::string_view(value)) {}
+
+    Text::Text(const Text& other) :
+        Text() {
+        if (other.storage == BORROWED) {
+            size     = other.size;
+            borrowed = other.borrowed;
+        } else {
+            assign(other.view());
+        }
+    }
+
+    Text::Text(Text&& other) noexcept :
+        size(other.size),
+        storage(other.storage) {
+        std::memcpy(small, other.small, inline_capacity);
+        other.size     = 0;
+        other.storage  = BORROWED;
+        other.borrowed = "";
+    }
+
+    Text::~Text() {
+        release();
+    }
+
+    Text& Text::operator=(const Text& other) {
+        if (this != &other) {
+            *this = Text(other);
+        }
+        return *this;
+    }
+
+    Text& Text::operator=(Text&& other) noexcept {
+        if (this != &other) {
+            release();
+            size    = other.size;
+            storage = other.storage;
+            std::memcpy(small, other.small, inline_capacity);
+            other.size     = 0;
+            other.storage  = BORROWED;
+            other.borrowed = "";
+        }
+        return *this;
+    }
+
+    Text Text::borrow(const std::string_view& slice) {
+        assert(slice.size() <= std::numeric_limits<uint32_t>::max());
+        Text text;
+        text.size     = static_cast<uint32_t>(slice.size());
+        text.borrowed = slice.data();
+        return text;
+    }
+
+    std::string_view Text::view() const {
+        switch (storage) {
+            case INLINE:
+                return std::string_view(small, size);
+            case HEAP:
+                return std::string_view(heap, size);
+            default:
+                return std::string_view(borrowed, size);
+        }
+    }
+
+    std::string Text::str() const {
+        return std::string(view());
+    }
+
+    bool Text::isBorrowed() const {
+        return storage == BORROWED;
+    }
+
+    size_t Text::heap_usage() const {
+        return storage == HEAP ? size : 0;
+    }
+
+    Text::operator std::string_view() const {
+        return view();
+    }
+
+    bool Text::operator==(const Text& other) const {
+        return view() == other.view();
+    }
+
+    void Text::assign(const std::string_view& value) {
+        assert(value.size() <= std::numeric_limits<uint32_t>::max());
+        release();
+        size = static_cast<uint32_t>(value.size());
+        if (value.size() <= inline_capacity) {
+            storage = INLINE;
+            std::memcpy(small, value.data(), value.size());
+        } else {
+            storage = HEAP;
+            heap    = new char[value.size()];
+            std::memcpy(heap, value.data(), value.size());
+        }
+    }
+
+    void Text::release() {
+        if (storage == HEAP) {
+            delete[] heap;
+        }
+        storage  = BORROWED;
+        borrowed = "";
+        size     = 0;
+    }
+} // namespace gerber
@@ -0,0 +1,164 @@
+#include "gerber/ast/visitor.hpp"
+#include "gerber/ast/ast.hpp"
+
+namespace gerber {
+    void Visitor::on_node(const Node&) {}
+
+    void Visitor::on_file(const File& node) {
+        for (const auto& child : node.getNodes()) {
+            child->visit(*this);
+        }
+    }
+
+    void Visitor::on_command(const Command& node) {
+        on_node(node);
+    }
+
+    void Visitor::on_extended_command(const ExtendedCommand& node) {
+        on_node(node);
+    }
+
+    void Visitor::on_ad(const AD& node) {
+        on_command(node);
+    }
+
+    void Visitor::on_adc(const ADC& node) {
+        on_ad(node);
+    }
+
+    void Visitor::on_ado(const ADO& node) {
+        on_ad(node);
+    }
+
+    void Visitor::on_adp(const ADP& node) {
+        on_ad(node);
+    }
+
+    void Visitor::on_adr(const ADR& node) {
+        on_ad(node);
+    }
+
+    void Visitor::on_am(const AM& node) {
+        on_extended_command(node);
+    }
+
+    void Visitor::on_am_close(const AMclose& node) {
+        on_node(node);
+    }
+
+    void Visitor::on_am_open(const AMopen& node) {
+        on_node(node);
+    }
+
+    void Visitor::on_d01(const D01& node) {
+        on_command(node);
+    }
+
+    void Visitor::on_d02(const D02& node) {
+        on_command(node);
+    }
+
+    void Visitor::on_d03(const D03& node) {
+        on_command(node);
+    }
+
+    void Visitor::on_dnn(const Dnn& node) {
+        on_command(node);
+    }
+
+    void Visitor::on_operation(const Operation& node) {
+        on_command(node);
+    }
+
+    void Visitor::on_g01(const G01& node) {
+        on_command(node);
+    }
+
+    void Visitor::on_g02(const G02& node) {
+        on_command(node);
+    }
+
+    void Visitor::on_g03(const G03& node) {
+        on_command(node);
+    }
+
+    void Visitor::on_g04(const G04& node) {
+        on_command(node);
+    }
+
+    void Visitor::on_g36(const G36& node) {
+        on_command(node);
+    }
+
+    void Visitor::on_g37(const G37& node) {
+        on_command(node);
+    }
+
+    void Visitor::on_g54(const G54& node) {
+        on_command(node);
+    }
+
+    void Visitor::on_g55(const G55& node) {
+        on_command(node);
+    }
+
+    void Visitor::on_g70(const G70& node) {
+        on_command(node);
+    }
+
+    void Visitor::on_g71(const G71& node) {
+        on_command(node);
+    }
+
+    void Visitor::on_g74(const G74& node) {
+        on_command(node);
+    }
+
+    void Visitor::on_g75(const G75& node) {
+        on_command(node);
+    }
+
+    void Visitor::on_g90(const G90& node) {
+        on_command(node);
+    }
+
+    void Visitor::on_g91(const G91& node) {
+        on_command(node);
+    }
+
+    void Visitor::on_lp(const LP& node) {
+        on_extended_command(node);
+    }
+
+    void Visitor::on_m02(const M02& node) {
+        on_command(node);
+    }
+
+    void Visitor::on_coordinate(const Coordinate& node) {
+        on_command(node);
+    }
+
+    void Visitor::on_coordinate_i(const CoordinateI& node) {
+        on_coordinate(node);
+    }
+
+    void Visitor::on_coordinate_j(const CoordinateJ& node) {
+        on_coordinate(node);
+    }
+
+    void Visitor::on_coordinate_x(const CoordinateX& node) {
+        on_coordinate(node);
+    }
+
+    void Visitor::on_coordinate_y(const CoordinateY& node) {
+        on_coordinate(node);
+    }
+
+    void Visitor::on_fs(const FS& node) {
+        on_extended_command(node);
+    }
+
+    void Visitor::on_mo(const MO& node) {
+        on_extended_command(node);
+    }
+} // namespace gerber
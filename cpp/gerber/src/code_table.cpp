@@ -0,0 +1,93 @@
+#include "gerber/code_table.hpp"
+#include "gerber/ast/ast.hpp"
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace gerber {
+
+    namespace {
+        constexpr uint64_t swar_zeros      = 0x3030303030303030;
+        constexpr uint64_t swar_high_bits  = 0xF0F0F0F0F0F0F0F0;
+        constexpr uint64_t swar_digit_step = 0x0606060606060606;
+        constexpr uint64_t swar_sign_bits  = 0x8080808080808080;
+
+        // Longest number which always fits in uint32_t.
+        constexpr uint32_t max_exact_digits = 9;
+
+        /**
+         * Count of leading ASCII digits in 8 bytes loaded in little endian order.
+         */
+        uint32_t swar_digit_count(uint64_t chunk) {
+            // High nibble of every digit is 3 both before and after adding 6, any
+            // carry between bytes can only come from a non digit byte.
+            const uint64_t below = (chunk & swar_high_bits) ^ swar_zeros;
+            const uint64_t above = ((chunk + swar_digit_step) & swar_high_bits) ^ swar_zeros;
+            const uint64_t error = below | above;
+            const uint64_t mask  = (error | (error << 1) | (error << 2) | (error << 3)) &
+                                  swar_sign_bits;
+            return static_cast<uint32_t>(std::countr_zero(mask) / 8);
+        }
+
+        /**
+         * Value of first count digits in 8 bytes loaded in little endian order.
+         */
+        uint32_t swar_digit_value(uint64_t chunk, uint32_t count) {
+            // Digits are moved to the most significant bytes, zero bytes shifted in act
+            // as leading zeros.
+            uint64_t value = (chunk - swar_zeros) << (8 * (8 - count));
+            value          = ((value & 0x0F0F0F0F0F0F0F0F) * 2561) >> 8;
+            value          = ((value & 0x00FF00FF00FF00FF) * 6553601) >> 16;
+            value          = ((value & 0x0000FFFF0000FFFF) * 42949672960001) >> 32;
+            return static_cast<uint32_t>(value);
+        }
+    } // namespace
+
+    CodeNumber scan_code_number(const std::string_view& source) {
+        const auto size   = source.size();
+        uint64_t   value  = 0;
+        uint32_t   length = 0;
+
+        if constexpr (std::endian::native == std::endian::little) {
+            if (size >= 8) {
+                uint64_t chunk;
+                std::memcpy(&chunk, source.data(), sizeof(chunk));
+
+                const auto count = swar_digit_count(chunk);
+                if (count < 8) {
+                    if (count == 0) {
+                        return CodeNumber{0, 0};
+                    }
+                    return CodeNumber{swar_digit_value(chunk, count), count};
+                }
+                value  = swar_digit_value(chunk, 8);
+                length = 8;
+            }
+        }
+        while (length < size && source[length] >= '0' && source[length] <= '9') {
+            if (length < max_exact_digits) {
+                value = value * 10 + static_cast<uint64_t>(source[length] - '0');
+            }
+            length++;
+        }
+        if (length > max_exact_digits) {
+            value = std::numeric_limits<uint32_t>::max();
+        }
+        return CodeNumber{static_cast<uint32_t>(value), length};
+    }
+
+    template <>
+    std::shared_ptr<Node> make_code_node<G04>(Text) {
+        return std::make_shared<G04>("");
+    }
+
+    template <>
+    std::shared_ptr<Node> make_code_node<Dnn>(Text digits) {
+        return std::make_shared<Dnn>(std::move(digits));
+    }
+} // namespace gerber
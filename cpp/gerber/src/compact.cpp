@@ -0,0 +1,499 @@
+#include "gerber/compact.hpp"
+#include "gerber/ast/ast.hpp"
+#include "gerber/ast/memory.hpp"
+#include "gerber/ast/visitor.hpp"
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace gerber {
+
+    namespace {
+        enum Opcode : uint8_t {
+            LITERAL,
+            OP_D01,
+            OP_D02,
+            OP_D03,
+            OP_DNN,
+            OP_G01,
+            OP_G02,
+            OP_G03,
+            OP_G36,
+            OP_G37,
+            OP_G54,
+            OP_G55,
+            OP_G70,
+            OP_G71,
+            OP_G74,
+            OP_G75,
+            OP_G90,
+            OP_G91,
+            OP_M02,
+            OP_LP_DARK,
+            OP_LP_CLEAR,
+            // Followed by coordinate, in order of axes.
+            OP_COORDINATE_X,
+            OP_COORDINATE_Y,
+            OP_COORDINATE_I,
+            OP_COORDINATE_J,
+            // Operation kind in bits 4-5, bits 0-3 tell which of X, Y, I and J follow.
+            OP_OPERATION = 0x40,
+        };
+
+        enum Axis : uint8_t {
+            X,
+            Y,
+            I,
+            J
+        };
+
+        // Longest number which is encoded, longer ones would overflow int64_t.
+        constexpr size_t max_digits = 18;
+
+        /**
+         * Number in canonical form, without leading zeros and plus sign, which can be
+         * restored from its value.
+         */
+        std::optional<int64_t> canonical_number(const std::string_view& text) {
+            const size_t sign = (!text.empty() && text[0] == '-') ? 1 : 0;
+            if (text.size() == sign || text.size() - sign > max_digits ||
+                (text[sign] == '0' && text.size() > 1)) {
+                return std::nullopt;
+            }
+            const char* end   = text.data() + text.size();
+            int64_t     value = 0;
+            if (const auto result = std::from_chars(text.data(), end, value);
+                result.ec != std::errc() || result.ptr != end) {
+                return std::nullopt;
+            }
+            return value;
+        }
+
+        Text number_text(int64_t value) {
+            char       buffer[24];
+            const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            return Text(std::string_view(buffer, result.ptr - buffer));
+        }
+
+        class Encoder : public Visitor {
+          private:
+            std::vector<uint8_t>&               bytes;
+            std::vector<std::shared_ptr<Node>>& literals;
+            std::array<int64_t, 4>&             previous;
+            const std::shared_ptr<Node>*        current = nullptr;
+
+          public:
+            Encoder(
+                std::vector<uint8_t>&               bytes_,
+                std::vector<std::shared_ptr<Node>>& literals_,
+                std::array<int64_t, 4>&             previous_
+            ) :
+                bytes(bytes_),
+                literals(literals_),
+                previous(previous_) {}
+
+            void encode(const std::shared_ptr<Node>& node) {
+                current = &node;
+                node->visit(*this);
+            }
+
+            void on_node(const Node&) override {
+                bytes.push_back(LITERAL);
+                literals.push_back(*current);
+            }
+
+            void on_d01(const D01&) override {
+                bytes.push_back(OP_D01);
+            }
+
+            void on_d02(const D02&) override {
+                bytes.push_back(OP_D02);
+            }
+
+            void on_d03(const D03&) override {
+                bytes.push_back(OP_D03);
+            }
+
+            void on_dnn(const Dnn& node) override {
+                const auto number = canonical_number(node.getApertureIdView());
+                if (!number || *number < 0) {
+                    return on_node(node);
+                }
+                bytes.push_back(OP_DNN);
+                write_varint(static_cast<uint64_t>(*number));
+            }
+
+            void on_g01(const G01&) override {
+                bytes.push_back(OP_G01);
+            }
+
+            void on_g02(const G02&) override {
+                bytes.push_back(OP_G02);
+            }
+
+            void on_g03(const G03&) override {
+                bytes.push_back(OP_G03);
+            }
+
+            void on_g36(const G36&) override {
+                bytes.push_back(OP_G36);
+            }
+
+            void on_g37(const G37&) override {
+                bytes.push_back(OP_G37);
+            }
+
+            void on_g54(const G54&) override {
+                bytes.push_back(OP_G54);
+            }
+
+            void on_g55(const G55&) override {
+                bytes.push_back(OP_G55);
+            }
+
+            void on_g70(const G70&) override {
+                bytes.push_back(OP_G70);
+            }
+
+            void on_g71(const G71&) override {
+                bytes.push_back(OP_G71);
+            }
+
+            void on_g74(const G74&) override {
+                bytes.push_back(OP_G74);
+            }
+
+            void on_g75(const G75&) override {
+                bytes.push_back(OP_G75);
+            }
+
+            void on_g90(const G90&) override {
+                bytes.push_back(OP_G90);
+            }
+
+            void on_g91(const G91&) override {
+                bytes.push_back(OP_G91);
+            }
+
+            void on_m02(const M02&) override {
+                bytes.push_back(OP_M02);
+            }
+
+            void on_lp(const LP& node) override {
+                bytes.push_back(node.polarity == Polarity::DARK ? OP_LP_DARK : OP_LP_CLEAR);
+            }
+
+            void on_coordinate_x(const CoordinateX& node) override {
+                coordinate(node, X);
+            }
+
+            void on_coordinate_y(const CoordinateY& node) override {
+                coordinate(node, Y);
+            }
+
+            void on_coordinate_i(const CoordinateI& node) override {
+                coordinate(node, I);
+            }
+
+            void on_coordinate_j(const CoordinateJ& node) override {
+                coordinate(node, J);
+            }
+
+            void on_operation(const Operation& node) override {
+                const std::optional<std::string_view> views[] = {
+                    node.getXView(), node.getYView(), node.getIView(), node.getJView()
+                };
+                int64_t values[4] = {};
+                uint8_t mask      = 0;
+                for (uint8_t axis = X; axis <= J; axis++) {
+                    if (!views[axis]) {
+                        continue;
+                    }
+                    const auto number = canonical_number(*views[axis]);
+                    if (!number) {
+                        return on_node(node);
+                    }
+                    values[axis] = *number;
+                    mask |= 1 << axis;
+                }
+
+                const auto kind = static_cast<uint8_t>(node.getKind() - 1);
+                bytes.push_back(static_cast<uint8_t>(OP_OPERATION | (kind << 4) | mask));
+                for (uint8_t axis = X; axis <= J; axis++) {
+                    if (mask & (1 << axis)) {
+                        write_delta(values[axis], axis);
+                    }
+                }
+            }
+
+          private:
+            void coordinate(const Coordinate& node, Axis axis) {
+                const auto number = canonical_number(node.getValueView());
+                if (!number) {
+                    return on_node(node);
+                }
+                bytes.push_back(static_cast<uint8_t>(OP_COORDINATE_X + uint8_t{axis}));
+                write_delta(*number, axis);
+            }
+
+            void write_delta(int64_t value, uint8_t axis) {
+                // Wrapping arithmetic, difference of any two values fits.
+                const uint64_t delta =
+                    static_cast<uint64_t>(value) - static_cast<uint64_t>(previous[axis]);
+                previous[axis] = value;
+                // Zigzag, small negative deltas become small unsigned numbers too.
+                const uint64_t sign = static_cast<uint64_t>(static_cast<int64_t>(delta) >> 63);
+                write_varint((delta << 1) ^ sign);
+            }
+
+            void write_varint(uint64_t value) {
+                while (value >= 0x80) {
+                    bytes.push_back(static_cast<uint8_t>(value) | 0x80);
+                    value >>= 7;
+                }
+                bytes.push_back(static_cast<uint8_t>(value));
+            }
+        };
+
+        /**
+         * Sequential decoder, starting at a checkpoint.
+         */
+        class Cursor {
+          private:
+            const uint8_t*                            data;
+            const std::vector<std::shared_ptr<Node>>& literals;
+            uint32_t                                  literal;
+            std::array<int64_t, 4>                    previous;
+
+          public:
+            Cursor(
+                const uint8_t*                            data_,
+                const std::vector<std::shared_ptr<Node>>& literals_,
+                uint32_t                                  literal_,
+                const int64_t (&previous_)[4]
+            ) :
+                data(data_),
+                literals(literals_),
+                literal(literal_),
+                previous{previous_[0], previous_[1], previous_[2], previous_[3]} {}
+
+            /**
+             * Decode next node, skip only updates decoder state without creating it.
+             */
+            template <bool skip = false>
+            std::shared_ptr<Node> next() {
+                const uint8_t opcode = *data++;
+                if (opcode >= OP_OPERATION) {
+                    std::optional<Text> values[4];
+                    for (uint8_t axis = X; axis <= J; axis++) {
+                        if (opcode & (1 << axis)) {
+                            const auto value = read_delta(axis);
+                            if constexpr (!skip) {
+                                values[axis] = number_text(value);
+                            }
+                        }
+                    }
+                    if constexpr (skip) {
+                        return nullptr;
+                    }
+                    const auto kind = static_cast<Operation::Kind>(((opcode >> 4) & 0x3) + 1);
+                    return std::make_shared<Operation>(
+                        kind,
+                        std::move(values[X]),
+                        std::move(values[Y]),
+                        std::move(values[I]),
+                        std::move(values[J])
+                    );
+                }
+                if (opcode >= OP_COORDINATE_X) {
+                    const uint8_t axis  = opcode - OP_COORDINATE_X;
+                    const auto    value = read_delta(axis);
+                    if constexpr (skip) {
+                        return nullptr;
+                    }
+                    switch (axis) {
+                        case X:
+                            return std::make_shared<CoordinateX>(number_text(value));
+                        case Y:
+                            return std::make_shared<CoordinateY>(number_text(value));
+                        case I:
+                            return std::make_shared<CoordinateI>(number_text(value));
+                        default:
+                            return std::make_shared<CoordinateJ>(number_text(value));
+                    }
+                }
+                if (opcode == LITERAL) {
+                    return literals[literal++];
+                }
+                if (opcode == OP_DNN) {
+                    const auto number = read_varint();
+                    if constexpr (skip) {
+                        return nullptr;
+                    }
+                    return std::make_shared<Dnn>(number_text(static_cast<int64_t>(number)));
+                }
+                if constexpr (skip) {
+                    return nullptr;
+                }
+                return simple_node(opcode);
+            }
+
+          private:
+            static std::shared_ptr<Node> simple_node(uint8_t opcode) {
+                switch (opcode) {
+                    case OP_D01:
+                        return std::make_shared<D01>();
+                    case OP_D02:
+                        return std::make_shared<D02>();
+                    case OP_D03:
+                        return std::make_shared<D03>();
+                    case OP_G01:
+                        return std::make_shared<G01>();
+                    case OP_G02:
+                        return std::make_shared<G02>();
+                    case OP_G03:
+                        return std::make_shared<G03>();
+                    case OP_G36:
+                        return std::make_shared<G36>();
+                    case OP_G37:
+                        return std::make_shared<G37>();
+                    case OP_G54:
+                        return std::make_shared<G54>();
+                    case OP_G55:
+                        return std::make_shared<G55>();
+                    case OP_G70:
+                        return std::make_shared<G70>();
+                    case OP_G71:
+                        return std::make_shared<G71>();
+                    case OP_G74:
+                        return std::make_shared<G74>();
+                    case OP_G75:
+                        return std::make_shared<G75>();
+                    case OP_G90:
+                        return std::make_shared<G90>();
+                    case OP_G91:
+                        return std::make_shared<G91>();
+                    case OP_M02:
+                        return std::make_shared<M02>();
+                    case OP_LP_DARK:
+                        return std::make_shared<LP>('D');
+                    default:
+                        return std::make_shared<LP>('C');
+                }
+            }
+
+            int64_t read_delta(uint8_t axis) {
+                const uint64_t zigzag = read_varint();
+                const uint64_t delta  = (zigzag >> 1) ^ (~(zigzag & 1) + 1);
+                previous[axis] =
+                    static_cast<int64_t>(static_cast<uint64_t>(previous[axis]) + delta);
+                return previous[axis];
+            }
+
+            uint64_t read_varint() {
+                uint64_t value = 0;
+                for (uint32_t shift = 0;; shift += 7) {
+                    const uint8_t byte = *data++;
+                    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                    if ((byte & 0x80) == 0) {
+                        return value;
+                    }
+                }
+            }
+        };
+    } // namespace
+
+    CompactFile::CompactFile(const File& file) :
+        bytes(),
+        checkpoints(),
+        literals(),
+        count(file.getNodes().size()),
+        source(file.getSource()) {
+        const auto& nodes = file.getNodes();
+        // Most nodes of large files are operations taking a few bytes.
+        bytes.reserve(nodes.size() * 4);
+        checkpoints.reserve(nodes.size() / checkpoint_interval + 1);
+
+        std::array<int64_t, 4> previous{};
+        Encoder                encoder(bytes, literals, previous);
+        for (size_t index = 0; index < nodes.size(); index++) {
+            if (index % checkpoint_interval == 0) {
+                checkpoints.push_back(Checkpoint{
+                    bytes.size(),
+                    static_cast<uint32_t>(literals.size()),
+                    {previous[X], previous[Y], previous[I], previous[J]},
+                });
+            }
+            encoder.encode(nodes[index]);
+        }
+        bytes.shrink_to_fit();
+
+        // Source is needed only when some kept node borrows text from it.
+        if (source && literals.empty()) {
+            source.reset();
+        }
+    }
+
+    std::size_t CompactFile::size() const {
+        return count;
+    }
+
+    std::shared_ptr<Node> CompactFile::at(std::size_t index) const {
+        if (index >= count) {
+            throw std::out_of_range("Node index out of range");
+        }
+        const auto& checkpoint = checkpoints[index / checkpoint_interval];
+        Cursor      cursor(
+            bytes.data() + checkpoint.offset, literals, checkpoint.literal, checkpoint.previous
+        );
+        for (size_t skipped = index % checkpoint_interval; skipped > 0; skipped--) {
+            cursor.next<true>();
+        }
+        return cursor.next();
+    }
+
+    File CompactFile::decode() const {
+        std::vector<std::shared_ptr<Node>> nodes;
+        nodes.reserve(count);
+        if (count != 0) {
+            const auto& checkpoint = checkpoints.front();
+            Cursor      cursor(bytes.data(), literals, 0, checkpoint.previous);
+            for (size_t index = 0; index < count; index++) {
+                nodes.push_back(cursor.next());
+            }
+        }
+        return File(std::move(nodes), source);
+    }
+
+    void CompactFile::visit(Visitor& visitor) const {
+        if (count == 0) {
+            return;
+        }
+        const auto& checkpoint = checkpoints.front();
+        Cursor      cursor(bytes.data(), literals, 0, checkpoint.previous);
+        for (size_t index = 0; index < count; index++) {
+            cursor.next()->visit(visitor);
+        }
+    }
+
+    size_t CompactFile::memory_usage() const {
+        size_t usage = sizeof(CompactFile) + heap_usage(bytes) + heap_usage(checkpoints) +
+                       heap_usage(literals);
+        for (const auto& node : literals) {
+            usage += shared_usage(node);
+        }
+        if (source) {
+            usage += shared_control_block_size + sizeof(std::string) + heap_usage(*source);
+        }
+        return usage;
+    }
+} // namespace gerber
@@ -0,0 +1,78 @@
+#include "gerber/coordinate_format.hpp"
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+namespace gerber {
+    namespace {
+        constexpr int64_t powers_of_ten[] = {
+            1,
+            10,
+            100,
+            1000,
+            10000,
+            100000,
+            1000000,
+            10000000,
+            100000000,
+            1000000000,
+            10000000000,
+            100000000000,
+            1000000000000,
+            10000000000000,
+            100000000000000,
+            1000000000000000,
+            10000000000000000,
+            100000000000000000,
+        };
+        constexpr int max_digits = sizeof(powers_of_ten) / sizeof(powers_of_ten[0]) - 1;
+    } // namespace
+
+    CoordinateFormat::CoordinateFormat(Zeros zeros_, int integral_, int decimal_) :
+        zeros(zeros_),
+        integral(integral_),
+        decimal(decimal_) {}
+
+    CoordinateFormat CoordinateFormat::x(const FS& fs) {
+        return CoordinateFormat(fs.zeros, fs.x_integral, fs.x_decimal);
+    }
+
+    CoordinateFormat CoordinateFormat::y(const FS& fs) {
+        return CoordinateFormat(fs.zeros, fs.y_integral, fs.y_decimal);
+    }
+
+    int64_t CoordinateFormat::toInteger(const std::string_view& value) const {
+        std::string_view digits   = value;
+        bool             negative = false;
+
+        if (!digits.empty() && (digits[0] == '+' || digits[0] == '-')) {
+            negative = digits[0] == '-';
+            digits   = digits.substr(1);
+        }
+        if (digits.empty() || digits.size() > max_digits) {
+            throw std::invalid_argument("Invalid coordinate");
+        }
+
+        int64_t result = 0;
+        for (const char c : digits) {
+            if (c < '0' || c > '9') {
+                throw std::invalid_argument("Invalid coordinate");
+            }
+            result = result * 10 + (c - '0');
+        }
+
+        // With trailing zeros omitted, digits are aligned to the left of the format.
+        if (zeros == Zeros::SKIP_TRAILING) {
+            const int missing = integral + decimal - static_cast<int>(digits.size());
+            if (missing > 0 && missing <= max_digits) {
+                result *= powers_of_ten[missing];
+            }
+        }
+        return negative ? -result : result;
+    }
+
+    double CoordinateFormat::toDouble(const std::string_view& value) const {
+        const auto scale = (decimal >= 0 && decimal <= max_digits) ? powers_of_ten[decimal] : 1;
+        return static_cast<double>(toInteger(value)) / static_cast<double>(scale);
+    }
+} // namespace gerber
@@ -0,0 +1,338 @@
+#include "gerber/corpus.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <fmt/compile.h>
+#include <fmt/format.h>
+#include <iterator>
+#include <numbers>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gerber {
+
+    namespace {
+        /**
+         * SplitMix64, unlike standard distributions its output is the same on all
+         * platforms, which keeps generated files reproducible.
+         */
+        class Random {
+          private:
+            uint64_t state;
+
+          public:
+            Random(uint64_t seed_) :
+                state(seed_) {}
+
+            uint64_t next() {
+                uint64_t value = (state += 0x9e3779b97f4a7c15ULL);
+                value          = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+                value          = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+                return value ^ (value >> 31);
+            }
+
+            // Integer in [0, bound).
+            uint32_t below(uint32_t bound) {
+                return static_cast<uint32_t>(((next() >> 32) * bound) >> 32);
+            }
+
+            // Integer in [low, high].
+            uint32_t between(uint32_t low, uint32_t high) {
+                return low + below(high - low + 1);
+            }
+
+            // Real number in [low, high).
+            double real(double low, double high) {
+                return low + (high - low) * static_cast<double>(next() >> 11) * 0x1.0p-53;
+            }
+        };
+
+        class Emitter {
+          private:
+            const CorpusOptions&                   options;
+            std::string&                           out;
+            std::back_insert_iterator<std::string> it;
+            std::ostream*                          stream;
+            Random                                 random;
+            uint64_t                               flushed = 0;
+            // Aperture numbers, round ones can be used for draws and arcs.
+            std::vector<uint32_t>                  apertures;
+            std::vector<uint32_t>                  round_apertures;
+
+          public:
+            Emitter(const CorpusOptions& options_, std::string& out_, std::ostream* stream_) :
+                options(options_),
+                out(out_),
+                it(std::back_inserter(out_)),
+                stream(stream_),
+                random(options_.seed),
+                apertures(),
+                round_apertures() {}
+
+            void generate() {
+                header();
+
+                const uint32_t weights[] = {
+                    options.tracks,
+                    options.pads,
+                    options.pours,
+                    options.arcs,
+                    options.clears,
+                    options.comments,
+                };
+                uint32_t total = 0;
+                for (const auto weight : weights) {
+                    total += weight;
+                }
+
+                while (total != 0 && size() < options.target_bytes) {
+                    uint32_t pick = random.below(total);
+                    size_t   kind = 0;
+                    while (pick >= weights[kind]) {
+                        pick -= weights[kind++];
+                    }
+                    switch (kind) {
+                        case 0:
+                            track();
+                            break;
+                        case 1:
+                            pads();
+                            break;
+                        case 2:
+                            pour();
+                            break;
+                        case 3:
+                            arc_outline();
+                            break;
+                        case 4:
+                            clear();
+                            break;
+                        default:
+                            comment();
+                            break;
+                    }
+                }
+
+                out.append("M02*\n");
+                flush();
+            }
+
+          private:
+            uint64_t size() const {
+                return flushed + out.size();
+            }
+
+            void flush() {
+                if (stream != nullptr) {
+                    stream->write(out.data(), static_cast<std::streamsize>(out.size()));
+                    flushed += out.size();
+                    out.clear();
+                }
+            }
+
+            void command_written() {
+                if (out.size() >= CorpusGenerator::flush_threshold) {
+                    flush();
+                }
+            }
+
+            // Coordinate in 4.6 format, clamped to the board.
+            static int64_t coordinate(double value, double limit) {
+                return std::llround(std::clamp(value, 0.0, limit) * 1e6);
+            }
+
+            void point(double x, double y, const char* operation) {
+                fmt::format_to(
+                    it,
+                    FMT_COMPILE("X{}Y{}{}*\n"),
+                    coordinate(x, options.board_width),
+                    coordinate(y, options.board_height),
+                    operation
+                );
+                command_written();
+            }
+
+            void select(uint32_t aperture) {
+                fmt::format_to(it, FMT_COMPILE("D{}*\n"), aperture);
+            }
+
+            uint32_t any_aperture() {
+                return apertures[random.below(apertures.size())];
+            }
+
+            uint32_t round_aperture() {
+                return round_apertures[random.below(round_apertures.size())];
+            }
+
+            void header() {
+                fmt::format_to(it, FMT_COMPILE("G04 Synthetic corpus, seed {}*\n"), options.seed);
+                out.append("%FSLAX46Y46*%\n%MOMM*%\n");
+
+                // At least one round aperture is needed for draws.
+                const uint32_t count = std::max<uint32_t>(1, options.apertures);
+                for (uint32_t index = 0; index < count; index++) {
+                    const uint32_t number = 10 + index;
+                    const double   size   = random.real(0.1, 2.0);
+                    const auto     kind   = index == 0 ? 0 : random.below(4);
+                    switch (kind) {
+                        case 0:
+                            fmt::format_to(it, FMT_COMPILE("%ADD{}C,{:.3f}*%\n"), number, size);
+                            round_apertures.push_back(number);
+                            break;
+                        case 1:
+                            fmt::format_to(
+                                it,
+                                FMT_COMPILE("%ADD{}R,{:.3f}X{:.3f}*%\n"),
+                                number,
+                                size,
+                                random.real(0.1, 2.0)
+                            );
+                            break;
+                        case 2:
+                            fmt::format_to(
+                                it,
+                                FMT_COMPILE("%ADD{}O,{:.3f}X{:.3f}*%\n"),
+                                number,
+                                size,
+                                random.real(0.1, 2.0)
+                            );
+                            break;
+                        default:
+                            fmt::format_to(
+                                it,
+                                FMT_COMPILE("%ADD{}P,{:.3f}X{}X{:.1f}*%\n"),
+                                number,
+                                size,
+                                random.between(3, 12),
+                                random.real(0, 360)
+                            );
+                            break;
+                    }
+                    apertures.push_back(number);
+                    command_written();
+                }
+
+                // Parser accepts only macro templates without primitives.
+                for (uint32_t index = 0; index < options.macros; index++) {
+                    fmt::format_to(it, FMT_COMPILE("%AMMACRO{}*%\n"), index);
+                    command_written();
+                }
+            }
+
+            void track() {
+                select(round_aperture());
+                out.append("G01*\n");
+
+                double x = random.real(0, options.board_width);
+                double y = random.real(0, options.board_height);
+                point(x, y, "D02");
+
+                const uint32_t segments = random.between(20, 200);
+                for (uint32_t index = 0; index < segments; index++) {
+                    // Routing in multiples of 45 degrees.
+                    const double angle  = random.below(8) * std::numbers::pi / 4;
+                    const double length = random.real(0.1, 3.0);
+                    x = std::clamp(x + length * std::cos(angle), 0.0, options.board_width);
+                    y = std::clamp(y + length * std::sin(angle), 0.0, options.board_height);
+                    point(x, y, "D01");
+                }
+            }
+
+            void pads() {
+                select(any_aperture());
+
+                const uint32_t rows    = random.between(2, 20);
+                const uint32_t columns = random.between(2, 20);
+                const double   pitch   = random.real(0.5, 2.54);
+                const double   x       = random.real(0, options.board_width);
+                const double   y       = random.real(0, options.board_height);
+                for (uint32_t row = 0; row < rows; row++) {
+                    for (uint32_t column = 0; column < columns; column++) {
+                        point(x + column * pitch, y + row * pitch, "D03");
+                    }
+                }
+            }
+
+            void pour() {
+                out.append("G01*\nG36*\n");
+
+                const double   x        = random.real(0, options.board_width);
+                const double   y        = random.real(0, options.board_height);
+                const double   radius   = random.real(2, 20);
+                const uint32_t vertices = std::max<uint32_t>(3, options.pour_vertices);
+
+                const double first = radius * random.real(0.8, 1.0);
+                point(x + first, y, "D02");
+                for (uint32_t index = 1; index < vertices; index++) {
+                    const double angle    = 2 * std::numbers::pi * index / vertices;
+                    const double distance = radius * random.real(0.8, 1.0);
+                    point(x + distance * std::cos(angle), y + distance * std::sin(angle), "D01");
+                }
+                point(x + first, y, "D01");
+                out.append("G37*\n");
+            }
+
+            void arc_outline() {
+                select(round_aperture());
+
+                // Center is kept far enough from the edges for the arc to stay on board.
+                const double   limit     = std::min(options.board_width, options.board_height) / 2;
+                const double   radius    = std::min(random.real(1, 10), limit);
+                const double   x         = random.real(radius, options.board_width - radius);
+                const double   y         = random.real(radius, options.board_height - radius);
+                const uint32_t segments  = random.between(4, 16);
+                const bool     clockwise = random.below(2) == 0;
+                fmt::format_to(it, FMT_COMPILE("G75*\n{}*\n"), clockwise ? "G02" : "G03");
+
+                double start = random.real(0, 2 * std::numbers::pi);
+                point(x + radius * std::cos(start), y + radius * std::sin(start), "D02");
+                for (uint32_t index = 0; index < segments; index++) {
+                    const double sweep = 2 * std::numbers::pi / segments;
+                    const double end   = clockwise ? start - sweep : start + sweep;
+                    fmt::format_to(
+                        it,
+                        FMT_COMPILE("X{}Y{}I{}J{}D01*\n"),
+                        std::llround((x + radius * std::cos(end)) * 1e6),
+                        std::llround((y + radius * std::sin(end)) * 1e6),
+                        std::llround(-radius * std::cos(start) * 1e6),
+                        std::llround(-radius * std::sin(start) * 1e6)
+                    );
+                    command_written();
+                    start = end;
+                }
+            }
+
+            void clear() {
+                out.append("%LPC*%\n");
+                pads();
+                out.append("%LPD*%\n");
+            }
+
+            void comment() {
+                static constexpr std::string_view alphabet = "abcdefghijklmnopqrstuvwxyz  ,.-";
+                out.append("G04 ");
+                for (uint32_t index = 0; index < options.comment_bytes; index++) {
+                    out.push_back(alphabet[random.below(alphabet.size())]);
+                }
+                out.append("*\n");
+                command_written();
+            }
+        };
+    } // namespace
+
+    void CorpusGenerator::generate(const CorpusOptions& options, std::ostream& output) {
+        std::string out;
+        out.reserve(flush_threshold + 4096);
+        Emitter(options, out, &output).generate();
+    }
+
+    std::string CorpusGenerator::generate(const CorpusOptions& options) {
+        std::string out;
+        out.reserve(options.target_bytes + 4096);
+        Emitter(options, out, nullptr).generate();
+        return out;
+    }
+} // namespace gerber
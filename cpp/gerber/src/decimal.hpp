@@ -0,0 +1,30 @@
+#pragma once
+#include <algorithm>
+#include <cstdlib>
+#include <fmt/compile.h>
+#include <fmt/format.h>
+
+// Formatting of decimal numbers in Gerber output, not part of the public headers.
+namespace gerber {
+    /**
+     * Write value in fixed notation with the fewest digits which read back as the same
+     * double. Gerber has no exponent notation, which fmt picks for the shortest form of
+     * very small and very large values, so those keep their digits but not the exponent.
+     */
+    template <typename OutputIt>
+    OutputIt format_decimal(OutputIt out, double value) {
+        // Shortest form of a double is at most 24 characters, with room for terminator.
+        char       buffer[32];
+        const auto end = fmt::format_to_n(buffer, sizeof(buffer) - 1, FMT_COMPILE("{}"), value).out;
+        const auto exponent = std::find(buffer, end, 'e');
+        *end                = '\0';
+        if (exponent == end) {
+            return std::copy(buffer, end, out);
+        }
+        // Digits after decimal point of the mantissa, shifted by the exponent.
+        const auto point     = std::find(buffer, exponent, '.');
+        const int  fraction  = point == exponent ? 0 : static_cast<int>(exponent - point - 1);
+        const int  precision = std::max(0, fraction - std::atoi(exponent + 1));
+        return fmt::format_to(out, "{:.{}f}", value, precision);
+    }
+} // namespace gerber
@@ -0,0 +1,472 @@
+#include "gerber/diff.hpp"
+#include "gerber/interpreter.hpp"
+#include "gerber/thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace gerber {
+
+    namespace {
+        using grid_t = int64_t;
+
+        // Features hashed by one task.
+        constexpr size_t chunk_size = 16 * 1024;
+        // Shards per thread, more than one evens out uneven shard sizes.
+        constexpr size_t shards_per_thread = 4;
+
+        uint64_t finalize(uint64_t value) {
+            // splitmix64 finalizer, spreads every input bit over the whole output.
+            value ^= value >> 30;
+            value *= 0xbf58476d1ce4e5b9ULL;
+            value ^= value >> 27;
+            value *= 0x94d049bb133111ebULL;
+            value ^= value >> 31;
+            return value;
+        }
+
+        uint64_t combine(uint64_t seed, int64_t value) {
+            return finalize(seed ^ (static_cast<uint64_t>(value) + 0x9e3779b97f4a7c15ULL));
+        }
+
+        /**
+         * Feature reduced to what is compared. Shape doesn't depend on position, which
+         * is the anchor snapped to the grid.
+         */
+        class FeatureKey {
+          public:
+            uint64_t shape;
+            grid_t   x;
+            grid_t   y;
+            Point    anchor;
+
+            uint64_t hash() const {
+                return combine(combine(shape, x), y);
+            }
+
+            bool same_place(const FeatureKey& other) const {
+                return shape == other.shape && x == other.x && y == other.y;
+            }
+        };
+
+        class KeyBuilder {
+          private:
+            const Image& image;
+            double       scale;
+
+          public:
+            KeyBuilder(const Image& image_, double tolerance) :
+                image(image_),
+                scale(1.0 / tolerance) {}
+
+            FeatureKey key(const Feature& feature) const {
+                uint64_t shape = combine(feature.kind, feature.polarity);
+                if (feature.aperture >= 0) {
+                    shape = combine(shape, aperture_hash(image.apertures[feature.aperture]));
+                }
+
+                switch (feature.kind) {
+                    case Feature::FLASH:
+                        return anchored(shape, feature.segment.end);
+                    case Feature::DRAW:
+                        return draw_key(shape, feature.segment);
+                    case Feature::REGION:
+                        return region_key(shape, feature);
+                }
+                return anchored(shape, feature.segment.end);
+            }
+
+          private:
+            grid_t snap(double value) const {
+                return static_cast<grid_t>(std::llround(value * scale));
+            }
+
+            std::pair<grid_t, grid_t> snap(const Point& point) const {
+                return {snap(point.x), snap(point.y)};
+            }
+
+            FeatureKey anchored(uint64_t shape, const Point& anchor) const {
+                const auto [x, y] = snap(anchor);
+                return FeatureKey{shape, x, y, anchor};
+            }
+
+            uint64_t aperture_hash(const Aperture& aperture) const {
+                uint64_t hash = combine(aperture.shape, snap(aperture.width));
+                hash          = combine(hash, snap(aperture.height));
+                hash          = combine(hash, std::llround(aperture.vertices));
+                hash          = combine(hash, snap(aperture.rotation));
+                return combine(hash, snap(aperture.hole));
+            }
+
+            uint64_t
+            segment_hash(const Segment& segment, const std::pair<grid_t, grid_t>& anchor) const {
+                const auto start = snap(segment.start);
+                const auto end   = snap(segment.end);
+
+                uint64_t hash = combine(segment.kind, start.first - anchor.first);
+                hash          = combine(hash, start.second - anchor.second);
+                hash          = combine(hash, end.first - anchor.first);
+                hash          = combine(hash, end.second - anchor.second);
+                if (segment.kind != Segment::LINE) {
+                    const auto center = snap(segment.center);
+                    hash              = combine(hash, center.first - anchor.first);
+                    hash              = combine(hash, center.second - anchor.second);
+                    hash              = combine(hash, segment.multi_quadrant);
+                }
+                return hash;
+            }
+
+            static void reverse(Segment& segment) {
+                std::swap(segment.start, segment.end);
+                if (segment.kind == Segment::ARC_CW) {
+                    segment.kind = Segment::ARC_CCW;
+                } else if (segment.kind == Segment::ARC_CCW) {
+                    segment.kind = Segment::ARC_CW;
+                }
+            }
+
+            /**
+             * Draw traversed in the opposite direction is the same stroke, so draws are
+             * anchored at their lower end point and arcs flip direction when reversed.
+             */
+            FeatureKey draw_key(uint64_t shape, Segment segment) const {
+                if (snap(segment.end) < snap(segment.start)) {
+                    reverse(segment);
+                }
+                const auto hash = segment_hash(segment, snap(segment.start));
+                return anchored(combine(shape, hash), segment.start);
+            }
+
+            /**
+             * Contour starting at another vertex or traversed in the opposite direction
+             * is the same region. Contours are rotated to start at their lowest vertex,
+             * in both directions, and the smallest sequence of segment hashes is used.
+             * Lowest vertex may be visited more than once, every visit is tried.
+             */
+            FeatureKey region_key(uint64_t shape, const Feature& feature) const {
+                const auto first = image.contours.begin() + feature.contour_begin;
+                std::vector<Segment> segments(first, first + feature.contour_size);
+                if (segments.empty()) {
+                    return anchored(shape, feature.segment.end);
+                }
+
+                Point lowest = segments[0].start;
+                for (const auto& segment : segments) {
+                    if (snap(segment.start) < snap(lowest)) {
+                        lowest = segment.start;
+                    }
+                }
+                const auto anchor = snap(lowest);
+
+                std::vector<uint64_t> best;
+                std::vector<uint64_t> hashes(segments.size());
+                for (int direction = 0; direction < 2; direction++) {
+                    if (direction == 1) {
+                        std::reverse(segments.begin(), segments.end());
+                        std::for_each(segments.begin(), segments.end(), reverse);
+                    }
+                    for (size_t begin = 0; begin < segments.size(); begin++) {
+                        if (snap(segments[begin].start) != anchor) {
+                            continue;
+                        }
+                        for (size_t i = 0; i < segments.size(); i++) {
+                            hashes[i] = segment_hash(
+                                segments[(begin + i) % segments.size()], anchor
+                            );
+                        }
+                        if (best.empty() || hashes < best) {
+                            best = hashes;
+                        }
+                    }
+                }
+                for (const auto hash : best) {
+                    shape = combine(shape, hash);
+                }
+                return anchored(shape, lowest);
+            }
+        };
+
+        /**
+         * Run task(i) for i in [0, count) on the pool, rethrowing the first error.
+         */
+        void parallel_for(size_t threads, size_t count, const std::function<void(size_t)>& task) {
+            std::vector<std::exception_ptr> errors(count);
+            {
+                ThreadPool pool(std::max<size_t>(1, std::min(threads, count)));
+                for (size_t i = 0; i < count; i++) {
+                    pool.submit([&, i]() {
+                        try {
+                            task(i);
+                        } catch (...) {
+                            errors[i] = std::current_exception();
+                        }
+                    });
+                }
+            }
+            for (const auto& error : errors) {
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+            }
+        }
+
+        std::vector<FeatureKey>
+        build_keys(const Image& image, const DiffOptions& options, size_t threads) {
+            const KeyBuilder        builder(image, options.tolerance);
+            std::vector<FeatureKey> keys(image.features.size());
+            const size_t            chunks = (keys.size() + chunk_size - 1) / chunk_size;
+            parallel_for(threads, chunks, [&](size_t chunk) {
+                const size_t end = std::min(keys.size(), (chunk + 1) * chunk_size);
+                for (size_t i = chunk * chunk_size; i < end; i++) {
+                    keys[i] = builder.key(image.features[i]);
+                }
+            });
+            return keys;
+        }
+
+        /**
+         * Indices of features grouped by shard, stable within each shard.
+         */
+        std::vector<std::vector<uint32_t>> partition(
+            const std::vector<FeatureKey>& keys,
+            const std::vector<char>&       matched,
+            size_t                         shards,
+            bool                           by_shape
+        ) {
+            std::vector<std::vector<uint32_t>> result(shards);
+            for (uint32_t i = 0; i < keys.size(); i++) {
+                if (!matched[i]) {
+                    const uint64_t hash = by_shape ? finalize(keys[i].shape) : keys[i].hash();
+                    result[hash % shards].push_back(i);
+                }
+            }
+            return result;
+        }
+
+        /**
+         * Pair features with identical shape and position, duplicates are paired one
+         * by one in order of appearance.
+         */
+        size_t match_unchanged(
+            const std::vector<FeatureKey>& before_keys,
+            const std::vector<FeatureKey>& after_keys,
+            const std::vector<uint32_t>&   before,
+            const std::vector<uint32_t>&   after,
+            std::vector<char>&             before_matched,
+            std::vector<char>&             after_matched
+        ) {
+            std::unordered_map<uint64_t, std::vector<uint32_t>> buckets;
+            buckets.reserve(before.size());
+            for (auto it = before.rbegin(); it != before.rend(); ++it) {
+                buckets[before_keys[*it].hash()].push_back(*it);
+            }
+
+            size_t unchanged = 0;
+            for (const auto index : after) {
+                const auto& key   = after_keys[index];
+                auto        found = buckets.find(key.hash());
+                if (found == buckets.end()) {
+                    continue;
+                }
+                // Bucket is in reverse order, earliest candidate is at the back.
+                auto& candidates = found->second;
+                for (auto it = candidates.rbegin(); it != candidates.rend(); ++it) {
+                    if (before_keys[*it].same_place(key)) {
+                        before_matched[*it]  = 1;
+                        after_matched[index] = 1;
+                        candidates.erase(std::next(it).base());
+                        unchanged++;
+                        break;
+                    }
+                }
+            }
+            return unchanged;
+        }
+
+        /**
+         * Pair remaining features of equal shape with the nearest counterpart within
+         * radius. Candidates are looked up in cells of radius size around the feature.
+         */
+        std::vector<FeatureMove> match_moved(
+            const std::vector<FeatureKey>& before_keys,
+            const std::vector<FeatureKey>& after_keys,
+            const std::vector<uint32_t>&   before,
+            const std::vector<uint32_t>&   after,
+            double                         radius,
+            std::vector<char>&             before_matched,
+            std::vector<char>&             after_matched
+        ) {
+            const auto cell_of = [radius](const Point& point) {
+                return std::pair<grid_t, grid_t>{
+                    static_cast<grid_t>(std::floor(point.x / radius)),
+                    static_cast<grid_t>(std::floor(point.y / radius)),
+                };
+            };
+            const auto cell_hash = [](uint64_t shape, grid_t x, grid_t y) {
+                return combine(combine(shape, x), y);
+            };
+
+            std::unordered_map<uint64_t, std::vector<uint32_t>> cells;
+            for (const auto index : before) {
+                const auto& key  = before_keys[index];
+                const auto  cell = cell_of(key.anchor);
+                cells[cell_hash(key.shape, cell.first, cell.second)].push_back(index);
+            }
+
+            std::vector<FeatureMove> moves;
+            for (const auto index : after) {
+                const auto& key  = after_keys[index];
+                const auto  cell = cell_of(key.anchor);
+
+                uint32_t best          = std::numeric_limits<uint32_t>::max();
+                double   best_distance = radius;
+                for (grid_t dx = -1; dx <= 1; dx++) {
+                    for (grid_t dy = -1; dy <= 1; dy++) {
+                        const auto found =
+                            cells.find(cell_hash(key.shape, cell.first + dx, cell.second + dy));
+                        if (found == cells.end()) {
+                            continue;
+                        }
+                        for (const auto candidate : found->second) {
+                            const auto& other = before_keys[candidate];
+                            if (before_matched[candidate] || other.shape != key.shape) {
+                                continue;
+                            }
+                            const double distance = std::hypot(
+                                key.anchor.x - other.anchor.x, key.anchor.y - other.anchor.y
+                            );
+                            if (distance < best_distance ||
+                                (distance == best_distance && candidate < best)) {
+                                best          = candidate;
+                                best_distance = distance;
+                            }
+                        }
+                    }
+                }
+                if (best != std::numeric_limits<uint32_t>::max()) {
+                    before_matched[best] = 1;
+                    after_matched[index] = 1;
+                    moves.push_back(FeatureMove{
+                        best,
+                        index,
+                        Point{
+                            key.anchor.x - before_keys[best].anchor.x,
+                            key.anchor.y - before_keys[best].anchor.y,
+                        },
+                    });
+                }
+            }
+            return moves;
+        }
+
+        BoundingBox feature_bounds(const Image& image, const Feature& feature) {
+            BoundingBox bounds;
+            switch (feature.kind) {
+                case Feature::FLASH:
+                    bounds.include(feature.segment.end, image.apertures[feature.aperture].extent());
+                    break;
+                case Feature::DRAW:
+                    bounds.include(feature.segment, image.apertures[feature.aperture].extent());
+                    break;
+                case Feature::REGION:
+                    for (uint32_t i = 0; i < feature.contour_size; i++) {
+                        bounds.include(image.contours[feature.contour_begin + i]);
+                    }
+                    break;
+            }
+            return bounds;
+        }
+    } // namespace
+
+    bool ImageDiff::empty() const {
+        return removed.empty() && added.empty() && moved.empty();
+    }
+
+    ImageDiff Differ::diff(const Image& before, const Image& after, const DiffOptions& options) {
+        const size_t threads = options.threads == 0
+                                   ? std::max(1u, std::thread::hardware_concurrency())
+                                   : options.threads;
+        const size_t shards = threads * shards_per_thread;
+
+        const auto before_keys = build_keys(before, options, threads);
+        const auto after_keys  = build_keys(after, options, threads);
+
+        std::vector<char> before_matched(before_keys.size(), 0);
+        std::vector<char> after_matched(after_keys.size(), 0);
+
+        // Shards hold disjoint sets of features, so they can write matched flags
+        // without synchronization.
+        ImageDiff result;
+        {
+            const auto before_shards = partition(before_keys, before_matched, shards, false);
+            const auto after_shards  = partition(after_keys, after_matched, shards, false);
+
+            std::vector<size_t> unchanged(shards, 0);
+            parallel_for(threads, shards, [&](size_t shard) {
+                unchanged[shard] = match_unchanged(
+                    before_keys,
+                    after_keys,
+                    before_shards[shard],
+                    after_shards[shard],
+                    before_matched,
+                    after_matched
+                );
+            });
+            for (const auto count : unchanged) {
+                result.unchanged += count;
+            }
+        }
+
+        if (options.move_radius > 0) {
+            const auto before_shards = partition(before_keys, before_matched, shards, true);
+            const auto after_shards  = partition(after_keys, after_matched, shards, true);
+
+            std::vector<std::vector<FeatureMove>> moves(shards);
+            parallel_for(threads, shards, [&](size_t shard) {
+                moves[shard] = match_moved(
+                    before_keys,
+                    after_keys,
+                    before_shards[shard],
+                    after_shards[shard],
+                    options.move_radius,
+                    before_matched,
+                    after_matched
+                );
+            });
+            for (const auto& shard : moves) {
+                result.moved.insert(result.moved.end(), shard.begin(), shard.end());
+            }
+            std::sort(
+                result.moved.begin(),
+                result.moved.end(),
+                [](const FeatureMove& a, const FeatureMove& b) { return a.after < b.after; }
+            );
+        }
+
+        for (uint32_t i = 0; i < before_matched.size(); i++) {
+            if (!before_matched[i]) {
+                result.removed.push_back(i);
+                result.removed_bounds.include(feature_bounds(before, before.features[i]));
+            }
+        }
+        for (uint32_t i = 0; i < after_matched.size(); i++) {
+            if (!after_matched[i]) {
+                result.added.push_back(i);
+                result.added_bounds.include(feature_bounds(after, after.features[i]));
+            }
+        }
+        for (const auto& move : result.moved) {
+            result.moved_bounds.include(feature_bounds(before, before.features[move.before]));
+            result.moved_bounds.include(feature_bounds(after, after.features[move.after]));
+        }
+        return result;
+    }
+} // namespace gerber
@@ -3,4 +3,13 @@
 namespace gerber {
     SyntaxError::SyntaxError(const std::string& message) :
         std::runtime_error(message) {}
+
+    InterpreterError::InterpreterError(const std::string& message) :
+        std::runtime_error(message) {}
+
+    ArchiveError::ArchiveError(const std::string& message) :
+        std::runtime_error(message) {}
+
+    CancelledError::CancelledError(const std::string& message) :
+        std::runtime_error(message) {}
 } // namespace gerber
\ No newline at end of file
@@ -0,0 +1,895 @@
+#include "gerber/flatten.hpp"
+#include "gerber/interpreter.hpp"
+#include "gerber/tessellation.hpp"
+#include "gerber/thread_pool.hpp"
+#include "geometry.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fmt/format.h>
+#include <iterator>
+#include <limits>
+#include <numbers>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace gerber {
+
+    namespace {
+        using coord_t = int64_t;
+
+        class IPoint {
+          public:
+            coord_t x;
+            coord_t y;
+
+            bool operator==(const IPoint& other) const = default;
+            auto operator<=>(const IPoint& other) const = default;
+        };
+
+        using Ring = std::vector<IPoint>;
+        using geometry::cross;
+
+        double ring_area(const Ring& ring) {
+            double area = 0;
+            for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+                area += static_cast<double>(ring[j].x) * static_cast<double>(ring[i].y) -
+                        static_cast<double>(ring[i].x) * static_cast<double>(ring[j].y);
+            }
+            return area / 2;
+        }
+
+        /**
+         * Non-horizontal polygon edge, oriented bottom to top. Winding is +1 when the
+         * original edge went up and -1 when it went down.
+         */
+        class Edge {
+          public:
+            coord_t  y_bottom;
+            coord_t  y_top;
+            coord_t  x_bottom;
+            coord_t  x_top;
+            uint32_t feature;
+            int32_t  winding;
+
+            double x_exact(coord_t y) const {
+                return static_cast<double>(x_bottom) + static_cast<double>(x_top - x_bottom) *
+                                                           static_cast<double>(y - y_bottom) /
+                                                           static_cast<double>(y_top - y_bottom);
+            }
+
+            /**
+             * X rounded to the integer grid, same edge and y always give the same
+             * result, which is what keeps trapezoids of neighbouring beams and bands
+             * aligned.
+             */
+            coord_t x_at(coord_t y) const {
+                if (y <= y_bottom) {
+                    return x_bottom;
+                }
+                if (y >= y_top) {
+                    return x_top;
+                }
+                return static_cast<coord_t>(std::llround(x_exact(y)));
+            }
+        };
+
+        class Trapezoid {
+          public:
+            coord_t y_bottom;
+            coord_t y_top;
+            coord_t bottom_left;
+            coord_t bottom_right;
+            coord_t top_left;
+            coord_t top_right;
+        };
+
+        /**
+         * Directed boundary segment, covered area lies on its left side.
+         */
+        class BoundarySegment {
+          public:
+            IPoint start;
+            IPoint end;
+        };
+
+        /**
+         * Converts features of Image into edges of integer polygons.
+         */
+        class ShapeBuilder {
+          private:
+            const Image&       image;
+            double             scale;
+            ArcTessellator     tessellator;
+            // Outline of each aperture centered at origin, and of its hole.
+            std::vector<Ring>  outlines;
+            std::vector<Ring>  holes;
+            std::vector<Edge>& edges;
+
+          public:
+            ShapeBuilder(
+                const Image& image_, const FlattenOptions& options, std::vector<Edge>& edges_
+            ) :
+                image(image_),
+                scale(options.units_per_mm),
+                tessellator(options.tolerance),
+                outlines(),
+                holes(),
+                edges(edges_) {
+                for (const auto& aperture : image.apertures) {
+                    outlines.push_back(to_ring(aperture_outline(aperture)));
+                    holes.push_back(
+                        aperture.hole > 0 ? to_ring(circle(aperture.hole / 2, true)) : Ring{}
+                    );
+                }
+            }
+
+            void add_feature(uint32_t index) {
+                const auto& feature = image.features[index];
+                switch (feature.kind) {
+                    case Feature::FLASH:
+                        add_flash(index, feature);
+                        break;
+                    case Feature::DRAW:
+                        add_draw(index, feature);
+                        break;
+                    case Feature::REGION:
+                        add_region(index, feature);
+                        break;
+                }
+            }
+
+          private:
+            IPoint to_units(const Point& point) const {
+                return IPoint{
+                    static_cast<coord_t>(std::llround(point.x * scale)),
+                    static_cast<coord_t>(std::llround(point.y * scale)),
+                };
+            }
+
+            Ring to_ring(const std::vector<Point>& points) const {
+                Ring ring;
+                ring.reserve(points.size());
+                for (const auto& point : points) {
+                    ring.push_back(to_units(point));
+                }
+                return ring;
+            }
+
+            /**
+             * Polyline of a segment, including both end points.
+             */
+            std::vector<Point> polyline(const Segment& segment) const {
+                Polylines polylines;
+                tessellator.tessellate(segment, polylines);
+                return std::move(polylines.vertices);
+            }
+
+            std::vector<Point> circle(double radius, bool clockwise) const {
+                auto points = polyline(Segment{
+                    clockwise ? Segment::ARC_CW : Segment::ARC_CCW,
+                    true,
+                    {radius, 0},
+                    {radius, 0},
+                    {0, 0},
+                });
+                points.pop_back();
+                return points;
+            }
+
+            std::vector<Point> aperture_outline(const Aperture& aperture) const {
+                const double w = aperture.width / 2;
+                const double h = aperture.height / 2;
+                switch (aperture.shape) {
+                    case Aperture::CIRCLE:
+                        return circle(w, false);
+                    case Aperture::RECTANGLE:
+                        return {{-w, -h}, {w, -h}, {w, h}, {-w, h}};
+                    case Aperture::OBROUND:
+                        return obround(w, h);
+                    case Aperture::POLYGON: {
+                        const auto count = std::max<int64_t>(3, std::llround(aperture.vertices));
+                        std::vector<Point> points;
+                        for (int64_t i = 0; i < count; i++) {
+                            const double angle = aperture.rotation * std::numbers::pi / 180 +
+                                                 2 * std::numbers::pi * i / count;
+                            points.push_back({w * std::cos(angle), w * std::sin(angle)});
+                        }
+                        return points;
+                    }
+                }
+                return {};
+            }
+
+            std::vector<Point> obround(double w, double h) const {
+                if (w == h) {
+                    return circle(w, false);
+                }
+                Segment first;
+                Segment second;
+                if (w > h) {
+                    const double c = w - h;
+                    first  = Segment{Segment::ARC_CCW, true, {c, -h}, {c, h}, {c, 0}};
+                    second = Segment{Segment::ARC_CCW, true, {-c, h}, {-c, -h}, {-c, 0}};
+                } else {
+                    const double c = h - w;
+                    first  = Segment{Segment::ARC_CCW, true, {w, c}, {-w, c}, {0, c}};
+                    second = Segment{Segment::ARC_CCW, true, {-w, -c}, {w, -c}, {0, -c}};
+                }
+                auto points = polyline(first);
+                auto rest   = polyline(second);
+                points.insert(points.end(), rest.begin(), rest.end());
+                return points;
+            }
+
+            void add_ring(uint32_t feature, const Ring& ring, const IPoint& offset = {0, 0}) {
+                for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+                    const IPoint a{ring[j].x + offset.x, ring[j].y + offset.y};
+                    const IPoint b{ring[i].x + offset.x, ring[i].y + offset.y};
+                    if (a.y == b.y) {
+                        continue;
+                    }
+                    if (a.y < b.y) {
+                        edges.push_back(Edge{a.y, b.y, a.x, b.x, feature, 1});
+                    } else {
+                        edges.push_back(Edge{b.y, a.y, b.x, a.x, feature, -1});
+                    }
+                }
+            }
+
+            void add_flash(uint32_t index, const Feature& feature) {
+                const auto center = to_units(feature.segment.end);
+                add_ring(index, outlines[feature.aperture], center);
+                if (!holes[feature.aperture].empty()) {
+                    add_ring(index, holes[feature.aperture], center);
+                }
+            }
+
+            /**
+             * Stroke is a union of convex hulls of aperture placed at both ends of each
+             * chord, overlaps of one feature don't matter with nonzero winding.
+             */
+            void add_draw(uint32_t index, const Feature& feature) {
+                const auto& outline = outlines[feature.aperture];
+                const auto  points  = to_ring(polyline(feature.segment));
+
+                for (size_t i = 1; i < points.size(); i++) {
+                    Ring hull_points;
+                    hull_points.reserve(outline.size() * 2);
+                    for (const auto& vertex : outline) {
+                        const auto& a = points[i - 1];
+                        const auto& b = points[i];
+                        hull_points.push_back({vertex.x + a.x, vertex.y + a.y});
+                        hull_points.push_back({vertex.x + b.x, vertex.y + b.y});
+                    }
+                    add_ring(index, geometry::convex_hull(std::move(hull_points)));
+                }
+            }
+
+            void add_region(uint32_t index, const Feature& feature) {
+                Ring ring;
+                for (uint32_t i = 0; i < feature.contour_size; i++) {
+                    const auto points = polyline(image.contours[feature.contour_begin + i]);
+                    for (size_t j = 0; j + 1 < points.size(); j++) {
+                        ring.push_back(to_units(points[j]));
+                    }
+                }
+                if (ring.size() >= 3) {
+                    add_ring(index, ring);
+                }
+            }
+        };
+
+        /**
+         * Scanbeam sweep of one horizontal band. Beams are split at every vertex and
+         * at intersections of edges, inside a beam edges don't cross, so the area
+         * between each pair of neighbouring edges is a trapezoid with constant set of
+         * covering features.
+         *
+         * Order of active edges is kept from one beam to the next, where it changes
+         * only around new edges and intersections, so it is restored by insertion sort
+         * in time linear in the number of active edges.
+         */
+        class BandSweep {
+          private:
+            class Entry {
+              public:
+                const Edge* edge;
+                double      x0;
+                double      x1;
+            };
+
+            class Crossing {
+              public:
+                const Edge* edge;
+                coord_t     x_bottom;
+                coord_t     x_top;
+            };
+
+            /**
+             * Trapezoid which may still be extended upwards by the next part of the
+             * beam, when it is bounded by the same edges there.
+             */
+            class Piece {
+              public:
+                Trapezoid   trapezoid;
+                const Edge* left;
+                const Edge* right;
+            };
+
+            const std::vector<Edge>&           edges;
+            const std::vector<Polarity::Enum>& polarity;
+            std::vector<int32_t>               counts;
+            std::set<uint32_t>                 covering;
+            std::vector<Entry>                 entries;
+            std::vector<Crossing>              crossings;
+            std::vector<coord_t>               splits;
+            std::vector<Piece>                 pieces;
+            std::vector<Piece>                 extended;
+            std::vector<Trapezoid>&            output;
+
+          public:
+            BandSweep(
+                const std::vector<Edge>&           edges_,
+                const std::vector<Polarity::Enum>& polarity_,
+                std::vector<Trapezoid>&            output_
+            ) :
+                edges(edges_),
+                polarity(polarity_),
+                counts(polarity_.size(), 0),
+                covering(),
+                entries(),
+                crossings(),
+                splits(),
+                pieces(),
+                extended(),
+                output(output_) {}
+
+            /**
+             * Sweep between lo and hi, edges have to be sorted by y_bottom and ys must
+             * contain all distinct vertex y coordinates in sorted order.
+             */
+            void sweep(const std::vector<coord_t>& ys, coord_t lo, coord_t hi) {
+                std::vector<coord_t> events{lo};
+                for (auto it = std::upper_bound(ys.begin(), ys.end(), lo);
+                     it != ys.end() && *it < hi;
+                     ++it) {
+                    events.push_back(*it);
+                }
+                events.push_back(hi);
+
+                size_t next = 0;
+                for (size_t k = 0; k + 1 < events.size(); k++) {
+                    const coord_t y0 = events[k];
+                    const coord_t y1 = events[k + 1];
+
+                    std::erase_if(entries, [y0](const Entry& entry) {
+                        return entry.edge->y_top <= y0;
+                    });
+                    for (auto& entry : entries) {
+                        entry.x0 = entry.edge->x_exact(y0);
+                        entry.x1 = entry.edge->x_exact(y1);
+                    }
+                    // Left over order is sorted by x at y0 up to ties, new edges are
+                    // sorted separately and merged in.
+                    const auto old_size = static_cast<std::ptrdiff_t>(entries.size());
+                    for (; next < edges.size() && edges[next].y_bottom <= y0; next++) {
+                        if (edges[next].y_top > y0) {
+                            const auto& edge = edges[next];
+                            entries.push_back(Entry{&edge, edge.x_exact(y0), edge.x_exact(y1)});
+                        }
+                    }
+                    if (!entries.empty()) {
+                        const auto by_bottom = [](const Entry& a, const Entry& b) {
+                            return a.x0 < b.x0 || (a.x0 == b.x0 && a.x1 < b.x1);
+                        };
+                        insertion_sort(entries.begin(), entries.begin() + old_size, by_bottom);
+                        std::sort(entries.begin() + old_size, entries.end(), by_bottom);
+                        std::inplace_merge(
+                            entries.begin(), entries.begin() + old_size, entries.end(), by_bottom
+                        );
+                        sweep_beam(y0, y1);
+                    }
+                }
+                for (const auto& piece : pieces) {
+                    output.push_back(piece.trapezoid);
+                }
+                pieces.clear();
+            }
+
+          private:
+            template <typename It, typename Less>
+            static void insertion_sort(It begin, It end, Less less) {
+                for (auto it = begin; it != end; ++it) {
+                    for (auto j = it; j != begin && less(*j, *std::prev(j)); --j) {
+                        std::iter_swap(j, std::prev(j));
+                    }
+                }
+            }
+
+            /**
+             * Split beam at intersections of edges in entries, sorted by x at y0, and
+             * emit trapezoids of all parts. Leaves entries sorted by x at y1.
+             */
+            void sweep_beam(coord_t y0, coord_t y1) {
+                crossings.clear();
+                for (const auto& entry : entries) {
+                    crossings.push_back(Crossing{entry.edge, 0, 0});
+                }
+
+                // Every inversion of order at the top of the beam is an intersection.
+                splits.assign(1, y0);
+                for (size_t i = 1; i < entries.size(); i++) {
+                    for (size_t j = i; j > 0 && entries[j - 1].x1 > entries[j].x1; j--) {
+                        const auto&  a  = entries[j - 1];
+                        const auto&  b  = entries[j];
+                        const double d0 = b.x0 - a.x0;
+                        const double d1 = a.x1 - b.x1;
+                        const auto   y  = static_cast<coord_t>(
+                            std::llround(y0 + (y1 - y0) * d0 / (d0 + d1))
+                        );
+                        if (y > y0 && y < y1) {
+                            splits.push_back(y);
+                        }
+                        std::swap(entries[j - 1], entries[j]);
+                    }
+                }
+                std::sort(splits.begin(), splits.end());
+                splits.erase(std::unique(splits.begin(), splits.end()), splits.end());
+                splits.push_back(y1);
+
+                const auto by_middle = [](const Crossing& a, const Crossing& b) {
+                    const auto sum_a = a.x_bottom + a.x_top;
+                    const auto sum_b = b.x_bottom + b.x_top;
+                    return sum_a < sum_b || (sum_a == sum_b && a.x_bottom < b.x_bottom);
+                };
+                for (size_t k = 0; k + 1 < splits.size(); k++) {
+                    const coord_t ya = splits[k];
+                    const coord_t yb = splits[k + 1];
+                    for (auto& crossing : crossings) {
+                        crossing.x_bottom = crossing.edge->x_at(ya);
+                        crossing.x_top    = crossing.edge->x_at(yb);
+                    }
+                    // Order of the previous part differs only around intersections.
+                    insertion_sort(crossings.begin(), crossings.end(), by_middle);
+                    emit_trapezoids(ya, yb);
+                }
+            }
+
+            /**
+             * Emit dark runs of crossings as trapezoids. Rounding to the grid may leave
+             * neighbouring crossings swapped by a unit at one end, trapezoids are
+             * clipped so that they never twist or overlap. Trapezoids continuing one
+             * of the previous part between the same edges are merged with it, which
+             * moves their common corners by less than a unit.
+             */
+            void emit_trapezoids(coord_t ya, coord_t yb) {
+                bool     dark         = false;
+                Crossing left{};
+                coord_t  bottom_bound = std::numeric_limits<coord_t>::min();
+                coord_t  top_bound    = std::numeric_limits<coord_t>::min();
+                size_t   below        = 0;
+                for (size_t i = 0; i < crossings.size();) {
+                    // Coincident edges are applied together, so that touching shapes
+                    // don't produce zero width gaps.
+                    const auto& first = crossings[i];
+                    for (; i < crossings.size() && crossings[i].x_bottom == first.x_bottom &&
+                           crossings[i].x_top == first.x_top;
+                         i++) {
+                        const auto feature = crossings[i].edge->feature;
+                        const auto before  = counts[feature];
+                        counts[feature] += crossings[i].edge->winding;
+                        if (before == 0) {
+                            covering.insert(feature);
+                        } else if (counts[feature] == 0) {
+                            covering.erase(feature);
+                        }
+                    }
+
+                    const bool now_dark =
+                        !covering.empty() && polarity[*covering.rbegin()] == Polarity::DARK;
+                    if (now_dark && !dark) {
+                        left = first;
+                    } else if (!now_dark && dark) {
+                        const coord_t bottom_left  = std::max(left.x_bottom, bottom_bound);
+                        const coord_t top_left     = std::max(left.x_top, top_bound);
+                        const coord_t bottom_right = std::max(first.x_bottom, bottom_left);
+                        const coord_t top_right    = std::max(first.x_top, top_left);
+                        if (bottom_left != bottom_right || top_left != top_right) {
+                            // Pieces are ordered along x like the trapezoids.
+                            for (; below < pieces.size() &&
+                                   pieces[below].trapezoid.top_left < bottom_left;
+                                 below++) {
+                                output.push_back(pieces[below].trapezoid);
+                            }
+                            Piece piece{
+                                Trapezoid{ya, yb, bottom_left, bottom_right, top_left, top_right},
+                                left.edge,
+                                first.edge,
+                            };
+                            if (below < pieces.size()) {
+                                const auto& previous = pieces[below];
+                                if (previous.trapezoid.y_top == ya &&
+                                    previous.trapezoid.top_left == bottom_left &&
+                                    previous.trapezoid.top_right == bottom_right &&
+                                    previous.left == left.edge && previous.right == first.edge) {
+                                    piece.trapezoid.y_bottom     = previous.trapezoid.y_bottom;
+                                    piece.trapezoid.bottom_left  = previous.trapezoid.bottom_left;
+                                    piece.trapezoid.bottom_right = previous.trapezoid.bottom_right;
+                                    below++;
+                                }
+                            }
+                            extended.push_back(piece);
+                            bottom_bound = bottom_right;
+                            top_bound    = top_right;
+                        }
+                    }
+                    dark = now_dark;
+                }
+                // Every feature crosses a horizontal line as many times up as down, so
+                // counts are back at zero and covering is empty here.
+
+                for (; below < pieces.size(); below++) {
+                    output.push_back(pieces[below].trapezoid);
+                }
+                pieces.swap(extended);
+                extended.clear();
+            }
+        };
+
+        /**
+         * Boundary of union of trapezoids, which don't overlap. Each trapezoid adds its
+         * counterclockwise outline and sides traversed in both directions cancel out,
+         * so every vertex has as many segments ending as starting in it. Horizontal
+         * lines are split at all vertices on them before the counts are summed.
+         */
+        std::vector<BoundarySegment> trace_boundary(const std::vector<Trapezoid>& trapezoids) {
+            // Non horizontal sides with lower end first, counted +1 when going up.
+            std::vector<std::tuple<IPoint, IPoint, int32_t>> sides;
+            // Ends of horizontal sides as (y, x, delta), counted +1 when going right.
+            std::vector<std::tuple<coord_t, coord_t, int32_t>> lines;
+            sides.reserve(trapezoids.size() * 2);
+            lines.reserve(trapezoids.size() * 4);
+            for (const auto& t : trapezoids) {
+                sides.emplace_back(
+                    IPoint{t.bottom_left, t.y_bottom}, IPoint{t.top_left, t.y_top}, -1
+                );
+                sides.emplace_back(
+                    IPoint{t.bottom_right, t.y_bottom}, IPoint{t.top_right, t.y_top}, 1
+                );
+                lines.emplace_back(t.y_bottom, t.bottom_left, 1);
+                lines.emplace_back(t.y_bottom, t.bottom_right, -1);
+                lines.emplace_back(t.y_top, t.top_left, -1);
+                lines.emplace_back(t.y_top, t.top_right, 1);
+            }
+            std::sort(sides.begin(), sides.end());
+            std::sort(lines.begin(), lines.end());
+
+            std::vector<BoundarySegment> segments;
+            for (size_t i = 0; i < sides.size();) {
+                const auto bottom = std::get<0>(sides[i]);
+                const auto top    = std::get<1>(sides[i]);
+                int32_t    count  = 0;
+                for (; i < sides.size() && std::get<0>(sides[i]) == bottom &&
+                       std::get<1>(sides[i]) == top;
+                     i++) {
+                    count += std::get<2>(sides[i]);
+                }
+                for (; count > 0; count--) {
+                    segments.push_back({bottom, top});
+                }
+                for (; count < 0; count++) {
+                    segments.push_back({top, bottom});
+                }
+            }
+
+            int32_t count = 0;
+            for (size_t i = 0; i < lines.size();) {
+                const coord_t y = std::get<0>(lines[i]);
+                const coord_t x = std::get<1>(lines[i]);
+                for (; i < lines.size() && std::get<0>(lines[i]) == y && std::get<1>(lines[i]) == x;
+                     i++) {
+                    count += std::get<2>(lines[i]);
+                }
+                // Count of a line drops back to zero past its last vertex.
+                if (i == lines.size() || std::get<0>(lines[i]) != y) {
+                    continue;
+                }
+                const coord_t next = std::get<1>(lines[i]);
+                for (int32_t c = count; c > 0; c--) {
+                    segments.push_back({{x, y}, {next, y}});
+                }
+                for (int32_t c = count; c < 0; c++) {
+                    segments.push_back({{next, y}, {x, y}});
+                }
+            }
+            return segments;
+        }
+
+        /**
+         * Remove repeated and collinear vertices, including spikes.
+         */
+        Ring simplify(const Ring& ring) {
+            Ring result;
+            for (const auto& point : ring) {
+                if (!result.empty() && result.back() == point) {
+                    continue;
+                }
+                while (result.size() >= 2 &&
+                       cross(result[result.size() - 2], result.back(), point) == 0) {
+                    result.pop_back();
+                }
+                result.push_back(point);
+            }
+            // Same for vertices around the seam of the ring.
+            bool changed = true;
+            while (changed && result.size() >= 3) {
+                changed = false;
+                if (result.front() == result.back() ||
+                    cross(result[result.size() - 2], result.back(), result.front()) == 0) {
+                    result.pop_back();
+                    changed = true;
+                } else if (cross(result.back(), result.front(), result[1]) == 0) {
+                    result.erase(result.begin());
+                    changed = true;
+                }
+            }
+            return result.size() >= 3 ? result : Ring{};
+        }
+
+        /**
+         * Chain boundary segments into rings. Where more rings touch at a vertex, the
+         * sharpest left turn is taken, which keeps touching rings separate.
+         */
+        std::vector<Ring> chain_rings(const std::vector<BoundarySegment>& segments) {
+            // Segments ordered by start point, outgoing ones of a vertex are a range.
+            std::vector<size_t> outgoing(segments.size());
+            for (size_t i = 0; i < segments.size(); i++) {
+                outgoing[i] = i;
+            }
+            std::sort(outgoing.begin(), outgoing.end(), [&segments](size_t a, size_t b) {
+                return segments[a].start < segments[b].start;
+            });
+            const auto starts_before = [&segments](size_t index, const IPoint& point) {
+                return segments[index].start < point;
+            };
+
+            std::vector<bool> used(segments.size(), false);
+            std::vector<Ring> rings;
+            for (size_t first = 0; first < segments.size(); first++) {
+                if (used[first]) {
+                    continue;
+                }
+                Ring   ring;
+                size_t current = first;
+                bool   closed  = false;
+                while (true) {
+                    used[current] = true;
+                    const auto& segment = segments[current];
+                    ring.push_back(segment.start);
+                    if (segment.end == segments[first].start) {
+                        closed = true;
+                        break;
+                    }
+
+                    const double dx   = static_cast<double>(segment.end.x - segment.start.x);
+                    const double dy   = static_cast<double>(segment.end.y - segment.start.y);
+                    size_t       best = segments.size();
+                    double       best_turn = -std::numbers::pi * 2;
+                    for (auto it = std::lower_bound(
+                             outgoing.begin(), outgoing.end(), segment.end, starts_before
+                         );
+                         it != outgoing.end() && segments[*it].start == segment.end;
+                         ++it) {
+                        const auto candidate = *it;
+                        if (used[candidate]) {
+                            continue;
+                        }
+                        const auto&  next = segments[candidate];
+                        const double nx   = static_cast<double>(next.end.x - next.start.x);
+                        const double ny   = static_cast<double>(next.end.y - next.start.y);
+                        const double turn = std::atan2(dx * ny - dy * nx, dx * nx + dy * ny);
+                        if (turn > best_turn) {
+                            best_turn = turn;
+                            best      = candidate;
+                        }
+                    }
+                    if (best == segments.size()) {
+                        break;
+                    }
+                    current = best;
+                }
+                // Boundary is balanced by construction, open chain would lose copper.
+                if (!closed) {
+                    throw std::logic_error(fmt::format(
+                        "Boundary of flattened image is open at {}, {}",
+                        segments[current].end.x,
+                        segments[current].end.y
+                    ));
+                }
+                auto simple = simplify(ring);
+                if (!simple.empty()) {
+                    rings.push_back(std::move(simple));
+                }
+            }
+            return rings;
+        }
+
+        bool contains(const Ring& ring, double x, double y) {
+            bool inside = false;
+            for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+                const double xi = static_cast<double>(ring[i].x);
+                const double yi = static_cast<double>(ring[i].y);
+                const double xj = static_cast<double>(ring[j].x);
+                const double yj = static_cast<double>(ring[j].y);
+                if ((yi > y) != (yj > y) && x < (xj - xi) * (y - yi) / (yj - yi) + xi) {
+                    inside = !inside;
+                }
+            }
+            return inside;
+        }
+
+        std::vector<Point> to_points(const Ring& ring, double scale) {
+            std::vector<Point> points;
+            points.reserve(ring.size());
+            for (const auto& point : ring) {
+                points.push_back(
+                    {static_cast<double>(point.x) / scale, static_cast<double>(point.y) / scale}
+                );
+            }
+            return points;
+        }
+
+        /**
+         * Group counterclockwise outer rings with clockwise holes they contain.
+         */
+        std::vector<Polygon> assemble(const std::vector<Ring>& rings, double scale) {
+            std::vector<size_t> outers;
+            std::vector<double> areas(rings.size());
+            for (size_t i = 0; i < rings.size(); i++) {
+                areas[i] = ring_area(rings[i]);
+                if (areas[i] > 0) {
+                    outers.push_back(i);
+                }
+            }
+
+            std::vector<Polygon>                        polygons;
+            std::unordered_map<size_t, size_t>          polygon_of;
+            // Bounding box of each outer ring, skips most of the containment tests.
+            std::vector<std::pair<IPoint, IPoint>>      bounds(rings.size());
+            for (const auto outer : outers) {
+                polygon_of[outer] = polygons.size();
+                polygons.push_back(Polygon{to_points(rings[outer], scale), {}});
+                auto& [min, max] = bounds[outer];
+                min = max = rings[outer][0];
+                for (const auto& point : rings[outer]) {
+                    min = {std::min(min.x, point.x), std::min(min.y, point.y)};
+                    max = {std::max(max.x, point.x), std::max(max.y, point.y)};
+                }
+            }
+
+            for (size_t i = 0; i < rings.size(); i++) {
+                if (areas[i] >= 0) {
+                    continue;
+                }
+                // Probe point just right of the first edge lies in the hole itself.
+                const auto&  a      = rings[i][0];
+                const auto&  b      = rings[i][1];
+                const double dx     = static_cast<double>(b.x - a.x);
+                const double dy     = static_cast<double>(b.y - a.y);
+                const double length = std::hypot(dx, dy);
+                const double x      = (a.x + b.x) / 2.0 + dy / length / 2;
+                const double y      = (a.y + b.y) / 2.0 - dx / length / 2;
+
+                size_t best      = rings.size();
+                double best_area = 0;
+                for (const auto outer : outers) {
+                    const auto& [min, max] = bounds[outer];
+                    if (x < min.x || x > max.x || y < min.y || y > max.y) {
+                        continue;
+                    }
+                    if ((best == rings.size() || areas[outer] < best_area) &&
+                        contains(rings[outer], x, y)) {
+                        best      = outer;
+                        best_area = areas[outer];
+                    }
+                }
+                if (best != rings.size()) {
+                    polygons[polygon_of[best]].holes.push_back(to_points(rings[i], scale));
+                }
+            }
+            return polygons;
+        }
+    } // namespace
+
+    double Polygon::area() const {
+        const auto shoelace = [](const std::vector<Point>& ring) {
+            double area = 0;
+            for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+                area += ring[j].x * ring[i].y - ring[i].x * ring[j].y;
+            }
+            return area / 2;
+        };
+        double result = shoelace(outer);
+        for (const auto& hole : holes) {
+            result += shoelace(hole);
+        }
+        return result;
+    }
+
+    std::vector<Polygon> Flattener::flatten(const Image& image, const FlattenOptions& options) {
+        std::vector<Edge> edges;
+        {
+            ShapeBuilder builder(image, options, edges);
+            for (uint32_t i = 0; i < image.features.size(); i++) {
+                builder.add_feature(i);
+            }
+        }
+        if (edges.empty()) {
+            return {};
+        }
+        std::sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) {
+            return a.y_bottom < b.y_bottom;
+        });
+
+        std::vector<Polarity::Enum> polarity;
+        polarity.reserve(image.features.size());
+        for (const auto& feature : image.features) {
+            polarity.push_back(feature.polarity);
+        }
+
+        std::vector<coord_t> ys;
+        ys.reserve(edges.size() * 2);
+        for (const auto& edge : edges) {
+            ys.push_back(edge.y_bottom);
+            ys.push_back(edge.y_top);
+        }
+        std::sort(ys.begin(), ys.end());
+        ys.erase(std::unique(ys.begin(), ys.end()), ys.end());
+
+        // Bands are split evenly along y, seams are stitched when tracing boundary.
+        const size_t threads = options.threads == 0 ? std::thread::hardware_concurrency()
+                                                    : options.threads;
+        const coord_t bottom = ys.front();
+        const coord_t top    = ys.back();
+        const auto    tiles  = static_cast<coord_t>(std::clamp<size_t>(
+            options.tiles == 0 ? threads : options.tiles, 1, static_cast<size_t>(top - bottom)
+        ));
+
+        std::vector<std::vector<Trapezoid>> bands(tiles);
+        std::vector<std::exception_ptr>     errors(tiles);
+        {
+            ThreadPool pool(std::max<size_t>(1, std::min<size_t>(threads, tiles)));
+            for (coord_t i = 0; i < tiles; i++) {
+                const coord_t lo = bottom + (top - bottom) * i / tiles;
+                const coord_t hi = bottom + (top - bottom) * (i + 1) / tiles;
+                pool.submit([&, i, lo, hi]() {
+                    try {
+                        BandSweep sweep(edges, polarity, bands[i]);
+                        sweep.sweep(ys, lo, hi);
+                    } catch (...) {
+                        errors[i] = std::current_exception();
+                    }
+                });
+            }
+        }
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+        std::vector<Trapezoid> trapezoids;
+        for (auto& band : bands) {
+            trapezoids.insert(trapezoids.end(), band.begin(), band.end());
+        }
+        return assemble(chain_rings(trace_boundary(trapezoids)), options.units_per_mm);
+    }
+} // namespace gerber
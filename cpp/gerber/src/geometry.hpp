@@ -0,0 +1,81 @@
+#pragma once
+#include "gerber/interpreter.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <vector>
+
+// Geometry helpers shared by SVG exporter, tessellator and flattener, not part of
+// the public headers.
+namespace gerber::geometry {
+    /**
+     * Cross product of (b - a) and (c - a), positive when a, b, c turn left. Works
+     * for any point type with x and y members, computed in double.
+     */
+    template <typename P>
+    double cross(const P& a, const P& b, const P& c) {
+        return static_cast<double>(b.x - a.x) * static_cast<double>(c.y - a.y) -
+               static_cast<double>(b.y - a.y) * static_cast<double>(c.x - a.x);
+    }
+
+    /**
+     * Counterclockwise convex hull without collinear points, monotone chain algorithm.
+     * Fewer than 3 distinct points are returned as they are, sorted.
+     */
+    template <typename P>
+    std::vector<P> convex_hull(std::vector<P> points) {
+        const auto less = [](const P& a, const P& b) {
+            return a.x < b.x || (a.x == b.x && a.y < b.y);
+        };
+        const auto equal = [](const P& a, const P& b) { return a.x == b.x && a.y == b.y; };
+        std::sort(points.begin(), points.end(), less);
+        points.erase(std::unique(points.begin(), points.end(), equal), points.end());
+        if (points.size() < 3) {
+            return points;
+        }
+
+        std::vector<P> hull(points.size() * 2);
+        std::size_t    k = 0;
+        for (std::size_t i = 0; i < points.size(); i++) {
+            while (k >= 2 && cross(hull[k - 2], hull[k - 1], points[i]) <= 0) {
+                k--;
+            }
+            hull[k++] = points[i];
+        }
+        for (std::size_t i = points.size() - 1, lower = k + 1; i > 0; i--) {
+            while (k >= lower && cross(hull[k - 2], hull[k - 1], points[i - 1]) <= 0) {
+                k--;
+            }
+            hull[k++] = points[i - 1];
+        }
+        hull.resize(k - 1);
+        return hull;
+    }
+
+    /**
+     * Sweep of arc in radians, following Gerber rules for full circles and for
+     * single quadrant mode.
+     */
+    inline double arc_sweep(const Segment& segment) {
+        const bool cw = segment.kind == Segment::ARC_CW;
+        if (segment.start == segment.end) {
+            // Full circle in multi quadrant mode, zero length arc in single quadrant.
+            return segment.multi_quadrant ? 2 * std::numbers::pi : 0.0;
+        }
+        const double a0 =
+            std::atan2(segment.start.y - segment.center.y, segment.start.x - segment.center.x);
+        const double a1 =
+            std::atan2(segment.end.y - segment.center.y, segment.end.x - segment.center.x);
+        double sweep = cw ? a0 - a1 : a1 - a0;
+        if (sweep < 0) {
+            sweep += 2 * std::numbers::pi;
+        }
+        // Single quadrant arcs span at most 90 degrees, sweep close to full turn is
+        // a tiny arc which came out negative due to rounding.
+        if (!segment.multi_quadrant && sweep > std::numbers::pi) {
+            return 0.0;
+        }
+        return sweep;
+    }
+} // namespace gerber::geometry
@@ -0,0 +1,471 @@
+#include "gerber/interpreter.hpp"
+#include "gerber/ast/ast.hpp"
+#include "gerber/coordinate_format.hpp"
+#include "gerber/errors.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fmt/format.h>
+#include <limits>
+#include <numbers>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace gerber {
+
+    namespace {
+        constexpr double inch_to_millimeters = 25.4;
+        // Tolerance of quadrant test for single quadrant arcs, in radians.
+        constexpr double quadrant_tolerance  = 1e-9;
+
+        /**
+         * Angle swept when moving from start to end around center in given direction,
+         * in range [0, 2pi).
+         */
+        double sweep_angle(const Point& center, const Point& start, const Point& end, bool cw) {
+            const double a0    = std::atan2(start.y - center.y, start.x - center.x);
+            const double a1    = std::atan2(end.y - center.y, end.x - center.x);
+            double       sweep = cw ? a0 - a1 : a1 - a0;
+            while (sweep < 0) {
+                sweep += 2 * std::numbers::pi;
+            }
+            while (sweep >= 2 * std::numbers::pi) {
+                sweep -= 2 * std::numbers::pi;
+            }
+            return sweep;
+        }
+    } // namespace
+
+    void BoundingBox::include(const Point& point, double margin) {
+        if (empty) {
+            min   = point;
+            max   = point;
+            empty = false;
+        }
+        min.x = std::min(min.x, point.x - margin);
+        min.y = std::min(min.y, point.y - margin);
+        max.x = std::max(max.x, point.x + margin);
+        max.y = std::max(max.y, point.y + margin);
+    }
+
+    void BoundingBox::include(const Segment& segment, double margin) {
+        include(segment.start, margin);
+        include(segment.end, margin);
+        if (segment.kind != Segment::LINE) {
+            const double radius =
+                std::hypot(segment.start.x - segment.center.x, segment.start.y - segment.center.y);
+            include(segment.center, radius + margin);
+        }
+    }
+
+    void BoundingBox::include(const BoundingBox& other) {
+        if (!other.empty) {
+            include(other.min);
+            include(other.max);
+        }
+    }
+
+    double Aperture::extent() const {
+        if (shape == RECTANGLE || shape == OBROUND) {
+            return std::hypot(width, height) / 2;
+        }
+        return width / 2;
+    }
+
+    Interpreter::Interpreter(Image& image_, FeatureSink* sink_) :
+        image(image_),
+        sink(sink_),
+        aperture_ids(),
+        x_format(std::nullopt),
+        y_format(std::nullopt),
+        unit_scale(1.0),
+        incremental(false),
+        interpolation(LINEAR),
+        multi_quadrant(true),
+        region_mode(false),
+        polarity(Polarity::DARK),
+        aperture(-1),
+        contour_begin(0),
+        current_point{0.0, 0.0},
+        pending_x(std::nullopt),
+        pending_y(std::nullopt),
+        pending_i(std::nullopt),
+        pending_j(std::nullopt) {}
+
+    Image Interpreter::interpret(const File& file) {
+        Image       image;
+        Interpreter interpreter(image);
+
+        file.visit(interpreter);
+        interpreter.finish();
+
+        return image;
+    }
+
+    // Aperture
+
+    void Interpreter::define_aperture(const std::string_view& id, const Aperture& aperture_) {
+        const auto found = std::find(image.apertures.begin(), image.apertures.end(), aperture_);
+        if (found != image.apertures.end()) {
+            aperture_ids[std::string(id)] = static_cast<int32_t>(found - image.apertures.begin());
+            return;
+        }
+        aperture_ids[std::string(id)] = static_cast<int32_t>(image.apertures.size());
+        image.apertures.push_back(aperture_);
+    }
+
+    void Interpreter::on_adc(const ADC& node) {
+        const double diameter = node.getDiameter() * unit_scale;
+        define_aperture(
+            node.getApertureIdView(),
+            Aperture{
+                Aperture::CIRCLE,
+                diameter,
+                diameter,
+                0.0,
+                0.0,
+                node.getHoleDiameter().value_or(0.0) * unit_scale,
+            }
+        );
+    }
+
+    void Interpreter::on_ado(const ADO& node) {
+        define_aperture(
+            node.getApertureIdView(),
+            Aperture{
+                Aperture::OBROUND,
+                node.getWidth() * unit_scale,
+                node.getHeight() * unit_scale,
+                0.0,
+                0.0,
+                node.getHoleDiameter().value_or(0.0) * unit_scale,
+            }
+        );
+    }
+
+    void Interpreter::on_adp(const ADP& node) {
+        const double diameter = node.getOuterDiameter() * unit_scale;
+        define_aperture(
+            node.getApertureIdView(),
+            Aperture{
+                Aperture::POLYGON,
+                diameter,
+                diameter,
+                node.getVerticesCount(),
+                node.getRotation().value_or(0.0),
+                node.getHoleDiameter().value_or(0.0) * unit_scale,
+            }
+        );
+    }
+
+    void Interpreter::on_adr(const ADR& node) {
+        define_aperture(
+            node.getApertureIdView(),
+            Aperture{
+                Aperture::RECTANGLE,
+                node.getWidth() * unit_scale,
+                node.getHeight() * unit_scale,
+                0.0,
+                0.0,
+                node.getHoleDiameter().value_or(0.0) * unit_scale,
+            }
+        );
+    }
+
+    // D codes
+
+    void Interpreter::on_d01(const D01&) {
+        interpolate();
+    }
+
+    void Interpreter::on_d02(const D02&) {
+        move();
+    }
+
+    void Interpreter::on_d03(const D03&) {
+        flash();
+    }
+
+    void Interpreter::on_operation(const Operation& node) {
+        const auto x = node.getXView();
+        const auto y = node.getYView();
+        const auto i = node.getIView();
+        const auto j = node.getJView();
+
+        if (x.has_value()) {
+            pending_x = to_millimeters(x_format, *x);
+        }
+        if (y.has_value()) {
+            pending_y = to_millimeters(y_format, *y);
+        }
+        if (i.has_value()) {
+            pending_i = to_millimeters(x_format, *i);
+        }
+        if (j.has_value()) {
+            pending_j = to_millimeters(y_format, *j);
+        }
+
+        switch (node.getKind()) {
+            case Operation::INTERPOLATE:
+                interpolate();
+                break;
+            case Operation::MOVE:
+                move();
+                break;
+            case Operation::FLASH:
+                flash();
+                break;
+        }
+    }
+
+    void Interpreter::interpolate() {
+        const Point target = consume_target();
+
+        if (region_mode) {
+            image.contours.push_back(make_segment(target));
+        } else {
+            if (aperture < 0) {
+                throw InterpreterError("D01 used before selecting an aperture");
+            }
+            emit(Feature{Feature::DRAW, polarity, aperture, make_segment(target), 0, 0});
+        }
+        current_point = target;
+        pending_i     = std::nullopt;
+        pending_j     = std::nullopt;
+    }
+
+    void Interpreter::move() {
+        const Point target = consume_target();
+
+        if (region_mode) {
+            close_contour();
+        }
+        current_point = target;
+        pending_i     = std::nullopt;
+        pending_j     = std::nullopt;
+    }
+
+    void Interpreter::flash() {
+        const Point target = consume_target();
+
+        if (region_mode) {
+            throw InterpreterError("D03 is not allowed in region mode");
+        }
+        if (aperture < 0) {
+            throw InterpreterError("D03 used before selecting an aperture");
+        }
+        emit(Feature{
+            Feature::FLASH,
+            polarity,
+            aperture,
+            Segment{Segment::LINE, multi_quadrant, target, target, target},
+            0,
+            0,
+        });
+        current_point = target;
+        pending_i     = std::nullopt;
+        pending_j     = std::nullopt;
+    }
+
+    void Interpreter::on_dnn(const Dnn& node) {
+        const auto found = aperture_ids.find(node.getApertureIdView());
+        if (found == aperture_ids.end()) {
+            throw InterpreterError(fmt::format("Aperture D{} is not defined", node.getApertureIdView()));
+        }
+        aperture = found->second;
+    }
+
+    // G codes
+
+    void Interpreter::on_g01(const G01&) {
+        interpolation = LINEAR;
+    }
+
+    void Interpreter::on_g02(const G02&) {
+        interpolation = CLOCKWISE;
+    }
+
+    void Interpreter::on_g03(const G03&) {
+        interpolation = COUNTERCLOCKWISE;
+    }
+
+    void Interpreter::on_g36(const G36&) {
+        region_mode   = true;
+        contour_begin = static_cast<uint32_t>(image.contours.size());
+    }
+
+    void Interpreter::on_g37(const G37&) {
+        close_contour();
+        region_mode = false;
+    }
+
+    void Interpreter::on_g70(const G70&) {
+        unit_scale = inch_to_millimeters;
+    }
+
+    void Interpreter::on_g71(const G71&) {
+        unit_scale = 1.0;
+    }
+
+    void Interpreter::on_g74(const G74&) {
+        multi_quadrant = false;
+    }
+
+    void Interpreter::on_g75(const G75&) {
+        multi_quadrant = true;
+    }
+
+    void Interpreter::on_g90(const G90&) {
+        incremental = false;
+    }
+
+    void Interpreter::on_g91(const G91&) {
+        incremental = true;
+    }
+
+    // Load
+
+    void Interpreter::on_lp(const LP& node) {
+        polarity = node.polarity.value;
+    }
+
+    // Other
+
+    double Interpreter::to_millimeters(
+        const std::optional<CoordinateFormat>& format, const std::string_view& value
+    ) const {
+        if (!format.has_value()) {
+            throw InterpreterError("Coordinate data used before FS command");
+        }
+        try {
+            return format->toDouble(value) * unit_scale;
+        } catch (const std::invalid_argument&) {
+            throw InterpreterError(fmt::format("Invalid coordinate data '{}'", value));
+        }
+    }
+
+    void Interpreter::on_coordinate_i(const CoordinateI& node) {
+        pending_i = to_millimeters(x_format, node.getValueView());
+    }
+
+    void Interpreter::on_coordinate_j(const CoordinateJ& node) {
+        pending_j = to_millimeters(y_format, node.getValueView());
+    }
+
+    void Interpreter::on_coordinate_x(const CoordinateX& node) {
+        pending_x = to_millimeters(x_format, node.getValueView());
+    }
+
+    void Interpreter::on_coordinate_y(const CoordinateY& node) {
+        pending_y = to_millimeters(y_format, node.getValueView());
+    }
+
+    // Properties
+
+    void Interpreter::on_fs(const FS& node) {
+        x_format    = CoordinateFormat::x(node);
+        y_format    = CoordinateFormat::y(node);
+        incremental = node.coordinate_mode == CoordinateNotation::INCREMENTAL;
+    }
+
+    void Interpreter::on_mo(const MO& node) {
+        unit_scale = node.unit_mode == UnitMode::INCHES ? inch_to_millimeters : 1.0;
+    }
+
+    void Interpreter::finish() {
+        if (region_mode) {
+            close_contour();
+            region_mode = false;
+        }
+    }
+
+    Point Interpreter::consume_target() {
+        Point target = current_point;
+        if (pending_x.has_value()) {
+            target.x = incremental ? current_point.x + *pending_x : *pending_x;
+        }
+        if (pending_y.has_value()) {
+            target.y = incremental ? current_point.y + *pending_y : *pending_y;
+        }
+        pending_x = std::nullopt;
+        pending_y = std::nullopt;
+        return target;
+    }
+
+    Segment Interpreter::make_segment(const Point& target) {
+        if (interpolation == LINEAR) {
+            return Segment{Segment::LINE, multi_quadrant, current_point, target, current_point};
+        }
+        const double i = pending_i.value_or(0.0);
+        const double j = pending_j.value_or(0.0);
+
+        Segment segment{
+            interpolation == CLOCKWISE ? Segment::ARC_CW : Segment::ARC_CCW,
+            multi_quadrant,
+            current_point,
+            target,
+            Point{current_point.x + i, current_point.y + j},
+        };
+        if (!multi_quadrant) {
+            segment.center = resolve_single_quadrant_center(segment, i, j);
+        }
+        return segment;
+    }
+
+    Point Interpreter::resolve_single_quadrant_center(
+        const Segment& segment, double i, double j
+    ) const {
+        // In single quadrant mode offsets are unsigned, center is the candidate for which
+        // arc spans at most 90 degrees, with the smallest difference of start and end radius.
+        const bool cw            = segment.kind == Segment::ARC_CW;
+        Point      best          = segment.center;
+        double     best_mismatch = std::numeric_limits<double>::infinity();
+
+        for (const double si : {1.0, -1.0}) {
+            for (const double sj : {1.0, -1.0}) {
+                const Point center{segment.start.x + si * std::abs(i),
+                                   segment.start.y + sj * std::abs(j)};
+                const double sweep = sweep_angle(center, segment.start, segment.end, cw);
+                if (sweep > std::numbers::pi / 2 + quadrant_tolerance) {
+                    continue;
+                }
+                const double r0 = std::hypot(segment.start.x - center.x, segment.start.y - center.y);
+                const double r1 = std::hypot(segment.end.x - center.x, segment.end.y - center.y);
+                const double mismatch = std::abs(r0 - r1);
+                if (mismatch < best_mismatch) {
+                    best_mismatch = mismatch;
+                    best          = center;
+                }
+            }
+        }
+        return best;
+    }
+
+    void Interpreter::close_contour() {
+        const auto end = static_cast<uint32_t>(image.contours.size());
+        if (end > contour_begin) {
+            emit(Feature{
+                Feature::REGION,
+                polarity,
+                -1,
+                Segment{Segment::LINE, multi_quadrant, current_point, current_point, current_point},
+                contour_begin,
+                end - contour_begin,
+            });
+        }
+        if (sink != nullptr) {
+            image.contours.clear();
+        }
+        contour_begin = static_cast<uint32_t>(image.contours.size());
+    }
+
+    void Interpreter::emit(const Feature& feature) {
+        if (sink != nullptr) {
+            sink->on_feature(image, feature);
+        } else {
+            image.features.push_back(feature);
+        }
+    }
+} // namespace gerber
@@ -0,0 +1,132 @@
+#include "gerber/lazy.hpp"
+#include "gerber/ast/ast.hpp"
+#include "gerber/parser.hpp"
+#include "gerber/scanner.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace gerber {
+
+    namespace {
+        bool is_whitespace(char c) {
+            return c == ' ' || c == '\n' || c == '\r';
+        }
+
+        bool is_digit(char c) {
+            return c >= '0' && c <= '9';
+        }
+
+        /**
+         * Length of code at the beginning of command, two letters after '%', code
+         * letter with its number or just the first letter.
+         */
+        uint8_t code_length(const std::string_view& command) {
+            if (command[0] == '%') {
+                return static_cast<uint8_t>(std::min<size_t>(2, command.size() - 1));
+            }
+            if (command[0] != 'G' && command[0] != 'D' && command[0] != 'M') {
+                return 1;
+            }
+            size_t length = 1;
+            while (length < command.size() && length < UINT8_MAX && is_digit(command[length])) {
+                length++;
+            }
+            return static_cast<uint8_t>(length);
+        }
+    } // namespace
+
+    LazyFile::LazyFile(std::shared_ptr<const std::string> source_, const ParserOptions& options_) :
+        options(options_),
+        source(std::move(source_)),
+        commands(),
+        slots() {
+        const std::string_view text  = *source;
+        const auto             index = Scanner::scan(text);
+        commands.reserve(index.delimiters.size());
+
+        auto       delimiter = index.delimiters.cbegin();
+        const auto end       = index.delimiters.cend();
+
+        location_t position = 0;
+        while (position < text.size()) {
+            if (is_whitespace(text[position])) {
+                position++;
+                continue;
+            }
+            // Extended commands end with the next '%', which may follow many '*', other
+            // commands with the first delimiter.
+            const bool extended = text[position] == '%';
+            while (delimiter != end &&
+                   (*delimiter <= position || (extended && text[*delimiter] != '%'))) {
+                ++delimiter;
+            }
+            const location_t command_end = delimiter == end ? text.size() : *delimiter + 1;
+            commands.push_back(CommandEntry{
+                Span{position, command_end},
+                code_length(text.substr(position, command_end - position)),
+            });
+            position = command_end;
+        }
+
+        commands.shrink_to_fit();
+        slots = std::make_unique<Slot[]>(commands.size());
+    }
+
+    std::size_t LazyFile::size() const {
+        return commands.size();
+    }
+
+    const Span& LazyFile::getSpan(std::size_t index) const {
+        return commands.at(index).span;
+    }
+
+    std::string_view LazyFile::getCode(std::size_t index) const {
+        const auto& command  = commands.at(index);
+        const bool  extended = (*source)[command.span.begin] == '%';
+        return std::string_view(*source).substr(
+            command.span.begin + (extended ? 1 : 0), command.code_length
+        );
+    }
+
+    bool LazyFile::isDecoded(std::size_t index) const {
+        if (index >= commands.size()) {
+            throw std::out_of_range("Command index out of range");
+        }
+        return slots[index].decoded.load(std::memory_order_acquire);
+    }
+
+    const std::vector<std::shared_ptr<Node>>& LazyFile::getNodes(std::size_t index) const {
+        const auto& command = commands.at(index);
+        auto&       slot    = slots[index];
+        std::call_once(slot.once, [&]() {
+            // Command may be split into several nodes, eg. coordinates of operation
+            // interrupted by whitespace, so parse until its end.
+            ParseContext context(options, *source, {}, nullptr, source);
+            auto         file = context.parse_until(command.span.begin, [&](location_t position) {
+                return position >= command.span.end;
+            });
+            slot.nodes = std::move(file.getNodes());
+            slot.decoded.store(true, std::memory_order_release);
+        });
+        return slot.nodes;
+    }
+
+    File LazyFile::decode() const {
+        std::vector<std::shared_ptr<Node>> nodes;
+        nodes.reserve(commands.size());
+        for (std::size_t index = 0; index < commands.size(); index++) {
+            for (const auto& node : getNodes(index)) {
+                nodes.push_back(node);
+            }
+        }
+        return File(std::move(nodes), source);
+    }
+} // namespace gerber
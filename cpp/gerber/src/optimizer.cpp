@@ -0,0 +1,441 @@
+#include "gerber/optimizer.hpp"
+#include "gerber/ast/ast.hpp"
+#include "gerber/ast/visitor.hpp"
+#include "gerber/coordinate_format.hpp"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace gerber {
+
+    namespace {
+        // Shape letter, dimensions and unit of aperture definition.
+        using aperture_key_t = std::tuple<char, double, double, double, double, double, bool>;
+
+        class OptimizerVisitor : public Visitor {
+          private:
+            std::vector<std::shared_ptr<Node>>& output;
+            std::shared_ptr<Node>               current;
+
+            bool merge_apertures;
+            bool inches;
+
+            std::optional<FS>       format;
+            std::optional<UnitMode> unit_mode;
+            std::optional<char>     interpolation;
+            std::optional<bool>     multi_quadrant;
+            Polarity::Enum          polarity;
+            bool                    incremental;
+            bool                    region_mode;
+
+            std::map<aperture_key_t, std::string>        aperture_keys;
+            std::unordered_map<std::string, std::string> aperture_aliases;
+            std::optional<std::string>                   aperture;
+
+            std::optional<CoordinateFormat> x_format;
+            std::optional<CoordinateFormat> y_format;
+            std::optional<int64_t>          current_x;
+            std::optional<int64_t>          current_y;
+            std::optional<int64_t>          pending_x;
+            std::optional<int64_t>          pending_y;
+            bool                            statement_has_coordinates;
+
+          public:
+            OptimizerVisitor(std::vector<std::shared_ptr<Node>>& output_, bool merge_apertures_) :
+                output(output_),
+                current(),
+                merge_apertures(merge_apertures_),
+                inches(false),
+                format(std::nullopt),
+                unit_mode(std::nullopt),
+                interpolation(std::nullopt),
+                multi_quadrant(std::nullopt),
+                polarity(Polarity::DARK),
+                incremental(false),
+                region_mode(false),
+                aperture_keys(),
+                aperture_aliases(),
+                aperture(std::nullopt),
+                x_format(std::nullopt),
+                y_format(std::nullopt),
+                current_x(std::nullopt),
+                current_y(std::nullopt),
+                pending_x(std::nullopt),
+                pending_y(std::nullopt),
+                statement_has_coordinates(false) {}
+
+            void on_file(const File& file) override {
+                for (const auto& node : file.getNodes()) {
+                    current = node;
+                    node->visit(*this);
+                }
+            }
+
+            void on_node(const Node&) override {
+                output.push_back(current);
+            }
+
+            // Aperture
+
+            void define_aperture(const std::string& id, const aperture_key_t& key) {
+                if (aperture == id) {
+                    aperture = std::nullopt;
+                }
+                if (merge_apertures) {
+                    const auto found = aperture_keys.find(key);
+                    if (found != aperture_keys.end()) {
+                        aperture_aliases[id] = found->second;
+                        return;
+                    }
+                    aperture_keys.emplace(key, id);
+                    aperture_aliases[id] = id;
+                }
+                output.push_back(current);
+            }
+
+            void on_adc(const ADC& node) override {
+                define_aperture(
+                    node.getApertureId(),
+                    {'C',
+                     node.getDiameter(),
+                     0.0,
+                     0.0,
+                     0.0,
+                     node.getHoleDiameter().value_or(0.0),
+                     inches}
+                );
+            }
+
+            void on_ado(const ADO& node) override {
+                define_aperture(
+                    node.getApertureId(),
+                    {'O',
+                     node.getWidth(),
+                     node.getHeight(),
+                     0.0,
+                     0.0,
+                     node.getHoleDiameter().value_or(0.0),
+                     inches}
+                );
+            }
+
+            void on_adp(const ADP& node) override {
+                define_aperture(
+                    node.getApertureId(),
+                    {'P',
+                     node.getOuterDiameter(),
+                     0.0,
+                     node.getVerticesCount(),
+                     node.getRotation().value_or(0.0),
+                     node.getHoleDiameter().value_or(0.0),
+                     inches}
+                );
+            }
+
+            void on_adr(const ADR& node) override {
+                define_aperture(
+                    node.getApertureId(),
+                    {'R',
+                     node.getWidth(),
+                     node.getHeight(),
+                     0.0,
+                     0.0,
+                     node.getHoleDiameter().value_or(0.0),
+                     inches}
+                );
+            }
+
+            // D codes
+
+            void finish_operation(bool drop) {
+                if (pending_x.has_value()) {
+                    current_x = pending_x;
+                }
+                if (pending_y.has_value()) {
+                    current_y = pending_y;
+                }
+                pending_x                 = std::nullopt;
+                pending_y                 = std::nullopt;
+                statement_has_coordinates = false;
+
+                if (!drop) {
+                    output.push_back(current);
+                }
+            }
+
+            void on_d01(const D01&) override {
+                finish_operation(false);
+            }
+
+            void on_d02(const D02&) override {
+                // Outside of regions move to the current point does nothing.
+                const bool noop =
+                    !region_mode && !incremental && !statement_has_coordinates &&
+                    current_x.has_value() && current_y.has_value();
+                finish_operation(noop);
+            }
+
+            void on_d03(const D03&) override {
+                finish_operation(false);
+            }
+
+            /**
+             * Drops coordinate equal to the current one on the same axis and moves
+             * current point to the kept one.
+             */
+            std::optional<std::string_view> fold_coordinate(
+                const std::optional<CoordinateFormat>& axis_format,
+                const std::optional<std::string_view>& value,
+                std::optional<int64_t>&                axis_current
+            ) {
+                if (!value.has_value()) {
+                    return std::nullopt;
+                }
+                const auto integer = to_integer(axis_format, *value);
+                if (integer.has_value() && integer == axis_current) {
+                    return std::nullopt;
+                }
+                axis_current = integer;
+                return value;
+            }
+
+            void on_operation(const Operation& node) override {
+                const auto original_x = node.getXView();
+                const auto original_y = node.getYView();
+                const auto x          = fold_coordinate(x_format, original_x, current_x);
+                const auto y          = fold_coordinate(y_format, original_y, current_y);
+                const auto i          = node.getIView();
+                const auto j          = node.getJView();
+
+                if (node.getKind() == Operation::MOVE && !region_mode && !incremental &&
+                    !x.has_value() && !y.has_value() && !i.has_value() && !j.has_value() &&
+                    current_x.has_value() && current_y.has_value()) {
+                    return;
+                }
+                if (x == original_x && y == original_y) {
+                    output.push_back(current);
+                    return;
+                }
+
+                output.push_back(std::make_shared<Operation>(node.getKind(), x, y, i, j));
+            }
+
+            void on_dnn(const Dnn& node) override {
+                auto       id    = node.getApertureId();
+                const auto alias = aperture_aliases.find(id);
+                if (alias != aperture_aliases.end()) {
+                    id = alias->second;
+                }
+                if (aperture == id) {
+                    return;
+                }
+                aperture = id;
+
+                if (id == node.getApertureId()) {
+                    output.push_back(current);
+                } else {
+                    output.push_back(std::make_shared<Dnn>(id));
+                }
+            }
+
+            // G codes
+
+            void set_interpolation(char mode) {
+                if (interpolation == mode) {
+                    return;
+                }
+                interpolation = mode;
+                output.push_back(current);
+            }
+
+            void on_g01(const G01&) override {
+                set_interpolation(1);
+            }
+
+            void on_g02(const G02&) override {
+                set_interpolation(2);
+            }
+
+            void on_g03(const G03&) override {
+                set_interpolation(3);
+            }
+
+            void on_g36(const G36&) override {
+                region_mode = true;
+                output.push_back(current);
+            }
+
+            void on_g37(const G37&) override {
+                region_mode = false;
+                output.push_back(current);
+            }
+
+            void on_g70(const G70&) override {
+                // Same units as MOIN, a later MO is redundant only if it matches them.
+                unit_mode = UnitMode(UnitMode::INCHES);
+                inches    = true;
+                reset_current_point();
+                output.push_back(current);
+            }
+
+            void on_g71(const G71&) override {
+                unit_mode = UnitMode(UnitMode::MILLIMETERS);
+                inches    = false;
+                reset_current_point();
+                output.push_back(current);
+            }
+
+            void set_quadrant_mode(bool multi) {
+                if (multi_quadrant == multi) {
+                    return;
+                }
+                multi_quadrant = multi;
+                output.push_back(current);
+            }
+
+            void on_g74(const G74&) override {
+                set_quadrant_mode(false);
+            }
+
+            void on_g75(const G75&) override {
+                set_quadrant_mode(true);
+            }
+
+            void on_g90(const G90&) override {
+                incremental = false;
+                reset_current_point();
+                output.push_back(current);
+            }
+
+            void on_g91(const G91&) override {
+                incremental = true;
+                reset_current_point();
+                output.push_back(current);
+            }
+
+            // Load
+
+            void on_lp(const LP& node) override {
+                if (polarity == node.polarity.value) {
+                    return;
+                }
+                polarity = node.polarity.value;
+                output.push_back(current);
+            }
+
+            // Other
+
+            void on_coordinate(const Coordinate&) override {
+                statement_has_coordinates = true;
+                output.push_back(current);
+            }
+
+            std::optional<int64_t> to_integer(
+                const std::optional<CoordinateFormat>& axis_format, const std::string_view& value
+            ) {
+                if (!axis_format.has_value() || incremental) {
+                    return std::nullopt;
+                }
+                try {
+                    return axis_format->toInteger(value);
+                } catch (const std::invalid_argument&) {
+                    return std::nullopt;
+                }
+            }
+
+            void on_coordinate_x(const CoordinateX& node) override {
+                pending_x = to_integer(x_format, node.getValueView());
+                if (pending_x.has_value() && pending_x == current_x) {
+                    return;
+                }
+                if (!pending_x.has_value()) {
+                    current_x = std::nullopt;
+                }
+                on_coordinate(node);
+            }
+
+            void on_coordinate_y(const CoordinateY& node) override {
+                pending_y = to_integer(y_format, node.getValueView());
+                if (pending_y.has_value() && pending_y == current_y) {
+                    return;
+                }
+                if (!pending_y.has_value()) {
+                    current_y = std::nullopt;
+                }
+                on_coordinate(node);
+            }
+
+            void reset_current_point() {
+                current_x = std::nullopt;
+                current_y = std::nullopt;
+            }
+
+            // Properties
+
+            void on_fs(const FS& node) override {
+                if (format.has_value() && format->zeros == node.zeros &&
+                    format->coordinate_mode == node.coordinate_mode &&
+                    format->x_integral == node.x_integral && format->x_decimal == node.x_decimal &&
+                    format->y_integral == node.y_integral && format->y_decimal == node.y_decimal) {
+                    return;
+                }
+                format      = node;
+                x_format    = CoordinateFormat::x(node);
+                y_format    = CoordinateFormat::y(node);
+                incremental = node.coordinate_mode == CoordinateNotation::INCREMENTAL;
+                reset_current_point();
+                output.push_back(current);
+            }
+
+            void on_mo(const MO& node) override {
+                if (unit_mode == node.unit_mode) {
+                    return;
+                }
+                unit_mode = node.unit_mode;
+                inches    = node.unit_mode == UnitMode::INCHES;
+                reset_current_point();
+                output.push_back(current);
+            }
+        };
+
+        /**
+         * Merging apertures is only safe when no aperture is redefined, otherwise
+         * aliases could point to a definition which changed meaning later on.
+         */
+        bool has_redefined_apertures(const File& file) {
+            class Collector : public Visitor {
+              public:
+                std::unordered_set<std::string> ids;
+                bool                            redefined = false;
+
+                void on_ad(const AD& node) override {
+                    redefined |= !ids.insert(node.getApertureId()).second;
+                }
+            };
+
+            Collector collector;
+            file.visit(collector);
+            return collector.redefined;
+        }
+    } // namespace
+
+    File Optimizer::optimize(const File& file) const {
+        std::vector<std::shared_ptr<Node>> nodes;
+        nodes.reserve(file.getNodes().size());
+
+        OptimizerVisitor visitor(nodes, !has_redefined_apertures(file));
+        file.visit(visitor);
+
+        nodes.shrink_to_fit();
+        // Kept nodes may borrow their text from source of the input.
+        return File(std::move(nodes), file.getSource());
+    }
+} // namespace gerber
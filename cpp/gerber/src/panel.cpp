@@ -0,0 +1,475 @@
+#include "gerber/panel.hpp"
+#include "gerber/ast/ast.hpp"
+#include "gerber/errors.hpp"
+#include "gerber/writer.hpp"
+#include "decimal.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <fmt/format.h>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace gerber {
+
+    namespace {
+        // Instances closer than this are at the same grid position, in millimeters.
+        constexpr double grid_tolerance = 1e-6;
+
+        // Layer and linear part of transform, instances with the same key differ only
+        // by translation and share aperture definitions.
+        using block_key_t = std::tuple<std::size_t, double, double, double, double>;
+
+        block_key_t block_key(const PanelInstance& instance) {
+            const auto& transform = instance.transform;
+            return {instance.layer, transform.xx, transform.xy, transform.yx, transform.yy};
+        }
+
+        /**
+         * Regular grid of instances, which can be written as a single %SR block.
+         */
+        class Grid {
+          public:
+            std::size_t columns;
+            std::size_t rows;
+            double      step_x;
+            double      step_y;
+            // Instance in the first column and row.
+            std::size_t origin;
+        };
+
+        /**
+         * Sorted distinct values, equally spaced, or nothing when they are not.
+         */
+        std::optional<std::vector<double>> grid_lines(std::vector<double> values) {
+            std::sort(values.begin(), values.end());
+            std::vector<double> lines;
+            for (const double value : values) {
+                if (lines.empty() || value - lines.back() > grid_tolerance) {
+                    lines.push_back(value);
+                }
+            }
+            for (std::size_t index = 2; index < lines.size(); index++) {
+                const double step = lines[1] - lines[0];
+                if (std::abs(lines[index] - lines[0] - step * index) > grid_tolerance) {
+                    return std::nullopt;
+                }
+            }
+            return lines;
+        }
+
+        std::optional<Grid>
+        find_grid(const std::vector<PanelInstance>& instances, const std::vector<size_t>& members) {
+            std::vector<double> xs;
+            std::vector<double> ys;
+            for (const auto member : members) {
+                xs.push_back(instances[member].transform.dx);
+                ys.push_back(instances[member].transform.dy);
+            }
+            const auto columns = grid_lines(std::move(xs));
+            const auto rows    = grid_lines(std::move(ys));
+            if (!columns.has_value() || !rows.has_value() ||
+                columns->size() * rows->size() != members.size()) {
+                return std::nullopt;
+            }
+
+            Grid grid{
+                columns->size(),
+                rows->size(),
+                columns->size() > 1 ? (*columns)[1] - (*columns)[0] : 0.0,
+                rows->size() > 1 ? (*rows)[1] - (*rows)[0] : 0.0,
+                members[0],
+            };
+            // Every cell has to be taken exactly once.
+            std::vector<bool> taken(members.size());
+            for (const auto member : members) {
+                const auto&       transform = instances[member].transform;
+                const std::size_t column =
+                    grid.columns > 1 ? std::lround((transform.dx - (*columns)[0]) / grid.step_x)
+                                     : 0;
+                const std::size_t row =
+                    grid.rows > 1 ? std::lround((transform.dy - (*rows)[0]) / grid.step_y) : 0;
+                const std::size_t cell = row * grid.columns + column;
+                if (cell >= taken.size() || taken[cell]) {
+                    return std::nullopt;
+                }
+                taken[cell] = true;
+                if (cell == 0) {
+                    grid.origin = member;
+                }
+            }
+            return grid;
+        }
+
+        Text number_text(uint32_t value) {
+            const fmt::format_int text(value);
+            return Text(std::string_view(text.data(), text.size()));
+        }
+
+        std::shared_ptr<Node> renumbered(const AD& node, Text id) {
+            if (const auto* circle = dynamic_cast<const ADC*>(&node)) {
+                return std::make_shared<ADC>(
+                    std::move(id), circle->getDiameter(), circle->getHoleDiameter()
+                );
+            }
+            if (const auto* rectangle = dynamic_cast<const ADR*>(&node)) {
+                return std::make_shared<ADR>(
+                    std::move(id),
+                    rectangle->getWidth(),
+                    rectangle->getHeight(),
+                    rectangle->getHoleDiameter()
+                );
+            }
+            if (const auto* obround = dynamic_cast<const ADO*>(&node)) {
+                return std::make_shared<ADO>(
+                    std::move(id),
+                    obround->getWidth(),
+                    obround->getHeight(),
+                    obround->getHoleDiameter()
+                );
+            }
+            if (const auto* polygon = dynamic_cast<const ADP*>(&node)) {
+                return std::make_shared<ADP>(
+                    std::move(id),
+                    polygon->getOuterDiameter(),
+                    polygon->getVerticesCount(),
+                    polygon->getRotation(),
+                    polygon->getHoleDiameter()
+                );
+            }
+            throw std::invalid_argument(
+                fmt::format("Unsupported aperture D{}", node.getApertureIdView())
+            );
+        }
+
+        /**
+         * Writes blocks of the panel one after another, reassigning aperture numbers.
+         */
+        class BlockWriter {
+          private:
+            std::ostream&            output;
+            const PanelWriteOptions& options;
+            uint32_t                 next_aperture;
+            bool                     first_block;
+
+            std::map<block_key_t, std::unordered_map<std::string, Text>> apertures;
+
+          public:
+            BlockWriter(std::ostream& output_, const PanelWriteOptions& options_) :
+                output(output_),
+                options(options_),
+                next_aperture(10),
+                first_block(true),
+                apertures() {}
+
+            void write_header() {
+                std::vector<std::shared_ptr<Node>> header;
+                const auto&                        format = options.format;
+                header.push_back(std::make_shared<FS>(
+                    "L", "A", format.integral, format.decimal, format.integral, format.decimal
+                ));
+                header.push_back(std::make_shared<MO>(UnitMode(format.units).toString()));
+                Writer().write(File(std::move(header)), output);
+            }
+
+            /**
+             * Write instance, repeated by grid when given.
+             */
+            void write_block(
+                const File& layer, const PanelInstance& instance, const std::optional<Grid>& grid
+            ) {
+                const auto transformed =
+                    Transformer::transform(layer, instance.transform, options.format);
+                const auto key         = block_key(instance);
+                const bool defined     = apertures.contains(key);
+                auto&      numbers     = apertures[key];
+
+                std::vector<std::shared_ptr<Node>> definitions;
+                std::vector<std::shared_ptr<Node>> body;
+                if (!first_block) {
+                    // Modal state left by the previous block.
+                    body.push_back(std::make_shared<LP>('D'));
+                    body.push_back(std::make_shared<G01>());
+                    body.push_back(std::make_shared<G75>());
+                }
+                first_block = false;
+
+                for (const auto& node : transformed.getNodes()) {
+                    if (dynamic_cast<const FS*>(node.get()) != nullptr ||
+                        dynamic_cast<const MO*>(node.get()) != nullptr ||
+                        dynamic_cast<const M02*>(node.get()) != nullptr) {
+                        continue;
+                    }
+                    if (const auto* aperture = dynamic_cast<const AD*>(node.get())) {
+                        if (!defined) {
+                            Text id = number_text(next_aperture++);
+                            definitions.push_back(renumbered(*aperture, id));
+                            numbers.insert_or_assign(aperture->getApertureId(), std::move(id));
+                        }
+                        continue;
+                    }
+                    if (dynamic_cast<const AM*>(node.get()) != nullptr) {
+                        if (!defined) {
+                            definitions.push_back(node);
+                        }
+                        continue;
+                    }
+                    if (const auto* select = dynamic_cast<const Dnn*>(node.get())) {
+                        const auto found = numbers.find(select->getApertureId());
+                        if (found == numbers.end()) {
+                            throw InterpreterError(fmt::format(
+                                "Aperture D{} is not defined", select->getApertureIdView()
+                            ));
+                        }
+                        body.push_back(std::make_shared<Dnn>(found->second));
+                        continue;
+                    }
+                    body.push_back(node);
+                }
+
+                Writer().write(File(std::move(definitions)), output);
+                const bool repeated = grid.has_value() && grid->columns * grid->rows > 1;
+                if (repeated) {
+                    const double scale = std::pow(10.0, options.format.decimal);
+                    const double unit =
+                        options.format.units == UnitMode::INCHES ? 25.4 : 1.0;
+                    std::string step_repeat =
+                        fmt::format("%SRX{}Y{}I", grid->columns, grid->rows);
+                    auto it = std::back_inserter(step_repeat);
+                    format_decimal(it, std::round(grid->step_x / unit * scale) / scale);
+                    step_repeat.push_back('J');
+                    format_decimal(it, std::round(grid->step_y / unit * scale) / scale);
+                    output << step_repeat << "*%\n";
+                }
+                Writer().write(File(std::move(body), transformed.getSource()), output);
+                if (repeated) {
+                    output << "%SR*%\n";
+                }
+            }
+
+            void write_end() {
+                output << "M02*\n";
+            }
+        };
+
+        BoundingBox image_bounds(const Image& image) {
+            BoundingBox bounds;
+            for (const auto& feature : image.features) {
+                switch (feature.kind) {
+                    case Feature::FLASH:
+                        bounds.include(
+                            feature.segment.end, image.apertures[feature.aperture].extent()
+                        );
+                        break;
+                    case Feature::DRAW:
+                        bounds.include(
+                            feature.segment, image.apertures[feature.aperture].extent()
+                        );
+                        break;
+                    case Feature::REGION:
+                        for (uint32_t i = 0; i < feature.contour_size; i++) {
+                            bounds.include(image.contours[feature.contour_begin + i]);
+                        }
+                        break;
+                }
+            }
+            return bounds;
+        }
+
+        std::vector<Point>
+        transformed_ring(const std::vector<Point>& ring, const AffineTransform& transform) {
+            std::vector<Point> result;
+            result.reserve(ring.size());
+            for (const auto& point : ring) {
+                result.push_back(transform.apply(point));
+            }
+            // Mirroring flips orientation, restore counterclockwise outer boundaries.
+            if (transform.mirrors()) {
+                std::reverse(result.begin(), result.end());
+            }
+            return result;
+        }
+    } // namespace
+
+    Panel::Layer::Layer(std::shared_ptr<const File> file_) :
+        file(std::move(file_)),
+        interpreted(),
+        image(),
+        bounds() {}
+
+    const Panel::Layer& Panel::interpreted_layer(std::size_t layer) const {
+        auto& entry = *layers.at(layer);
+        std::call_once(entry.interpreted, [&]() {
+            entry.image  = Interpreter::interpret(*entry.file);
+            entry.bounds = image_bounds(entry.image);
+        });
+        return entry;
+    }
+
+    std::size_t Panel::addLayer(std::shared_ptr<const File> file) {
+        if (file == nullptr) {
+            throw std::invalid_argument("Layer can't be null");
+        }
+        layers.push_back(std::make_unique<Layer>(std::move(file)));
+        return layers.size() - 1;
+    }
+
+    void Panel::place(std::size_t layer, const AffineTransform& transform) {
+        if (layer >= layers.size()) {
+            throw std::out_of_range("Layer index out of range");
+        }
+        if (!transform.conformal()) {
+            throw std::invalid_argument("Transform has to keep angles to keep arcs circular");
+        }
+        instances.push_back(PanelInstance{layer, transform});
+    }
+
+    void Panel::placeGrid(
+        std::size_t            layer,
+        std::size_t            columns,
+        std::size_t            rows,
+        double                 step_x,
+        double                 step_y,
+        const AffineTransform& origin
+    ) {
+        for (std::size_t row = 0; row < rows; row++) {
+            for (std::size_t column = 0; column < columns; column++) {
+                place(
+                    layer,
+                    origin.then(AffineTransform::translate(
+                        static_cast<double>(column) * step_x, static_cast<double>(row) * step_y
+                    ))
+                );
+            }
+        }
+    }
+
+    std::size_t Panel::getLayerCount() const {
+        return layers.size();
+    }
+
+    const File& Panel::getLayer(std::size_t layer) const {
+        return *layers.at(layer)->file;
+    }
+
+    const std::vector<PanelInstance>& Panel::getInstances() const {
+        return instances;
+    }
+
+    const Image& Panel::getImage(std::size_t layer) const {
+        return interpreted_layer(layer).image;
+    }
+
+    BoundingBox Panel::getBounds(std::size_t instance) const {
+        const auto& placement = instances.at(instance);
+        const auto& bounds    = interpreted_layer(placement.layer).bounds;
+
+        BoundingBox result;
+        if (!bounds.empty) {
+            for (const auto& corner : {
+                     bounds.min,
+                     Point{bounds.max.x, bounds.min.y},
+                     bounds.max,
+                     Point{bounds.min.x, bounds.max.y},
+                 }) {
+                result.include(placement.transform.apply(corner));
+            }
+        }
+        return result;
+    }
+
+    BoundingBox Panel::getBounds() const {
+        BoundingBox result;
+        for (std::size_t instance = 0; instance < instances.size(); instance++) {
+            result.include(getBounds(instance));
+        }
+        return result;
+    }
+
+    std::vector<std::size_t> Panel::query(const BoundingBox& area) const {
+        std::vector<std::size_t> result;
+        if (area.empty) {
+            return result;
+        }
+        for (std::size_t instance = 0; instance < instances.size(); instance++) {
+            const auto bounds = getBounds(instance);
+            if (!bounds.empty && bounds.min.x <= area.max.x && area.min.x <= bounds.max.x &&
+                bounds.min.y <= area.max.y && area.min.y <= bounds.max.y) {
+                result.push_back(instance);
+            }
+        }
+        return result;
+    }
+
+    std::vector<Polygon> Panel::flatten(const FlattenOptions& options) const {
+        // Each layer is flattened once, its instances copy the polygons.
+        std::vector<std::optional<std::vector<Polygon>>> flattened(layers.size());
+        std::vector<Polygon>                             result;
+        for (const auto& instance : instances) {
+            auto& polygons = flattened[instance.layer];
+            if (!polygons.has_value()) {
+                polygons = Flattener::flatten(getImage(instance.layer), options);
+            }
+            for (const auto& polygon : *polygons) {
+                Polygon copy;
+                copy.outer = transformed_ring(polygon.outer, instance.transform);
+                for (const auto& hole : polygon.holes) {
+                    copy.holes.push_back(transformed_ring(hole, instance.transform));
+                }
+                result.push_back(std::move(copy));
+            }
+        }
+        return result;
+    }
+
+    void Panel::write(std::ostream& output, const PanelWriteOptions& options) const {
+        // Group instances by layer and linear part of transform, in order of the first
+        // instance of each group.
+        std::map<block_key_t, std::size_t>    group_index;
+        std::vector<std::vector<std::size_t>> groups;
+        for (std::size_t instance = 0; instance < instances.size(); instance++) {
+            const auto [found, inserted] =
+                group_index.emplace(block_key(instances[instance]), groups.size());
+            if (inserted) {
+                groups.emplace_back();
+            }
+            groups[found->second].push_back(instance);
+        }
+
+        BlockWriter writer(output, options);
+        writer.write_header();
+        for (const auto& members : groups) {
+            const auto& layer = getLayer(instances[members[0]].layer);
+            const auto  grid  = options.step_repeat && members.size() > 1
+                                    ? find_grid(instances, members)
+                                    : std::nullopt;
+            if (grid.has_value()) {
+                writer.write_block(layer, instances[grid->origin], grid);
+                continue;
+            }
+            for (const auto member : members) {
+                writer.write_block(layer, instances[member], std::nullopt);
+            }
+        }
+        writer.write_end();
+    }
+
+    std::string Panel::write(const PanelWriteOptions& options) const {
+        std::ostringstream output;
+        write(output, options);
+        return std::move(output).str();
+    }
+} // namespace gerber
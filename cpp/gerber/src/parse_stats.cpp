@@ -0,0 +1,97 @@
+#include "gerber/parse_stats.hpp"
+#include "gerber/ast/ast.hpp"
+#include "gerber/ast/visitor.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+
+namespace gerber {
+
+    namespace {
+        class StatsCollector : public Visitor {
+          private:
+            ParseStats& stats;
+            bool        region_mode;
+            uint64_t    region_size;
+
+          public:
+            StatsCollector(ParseStats& stats_) :
+                stats(stats_),
+                region_mode(false),
+                region_size(0) {}
+
+            void on_node(const Node& node) override {
+                stats.nodes[node.getNodeName()]++;
+            }
+
+            void on_ad(const AD& node) override {
+                stats.aperture_count++;
+                Visitor::on_ad(node);
+            }
+
+            void on_d01(const D01& node) override {
+                region_size += region_mode;
+                Visitor::on_d01(node);
+            }
+
+            void on_operation(const Operation& node) override {
+                region_size += region_mode && node.getKind() == Operation::INTERPOLATE;
+                Visitor::on_operation(node);
+            }
+
+            void on_g04(const G04& node) override {
+                stats.comment_bytes += node.getCommentView().size();
+                Visitor::on_g04(node);
+            }
+
+            void on_g36(const G36& node) override {
+                region_mode = true;
+                region_size = 0;
+                Visitor::on_g36(node);
+            }
+
+            void on_g37(const G37& node) override {
+                region_mode          = false;
+                stats.largest_region = std::max(stats.largest_region, region_size);
+                Visitor::on_g37(node);
+            }
+        };
+    } // namespace
+
+    ParseStats::Family ParseStats::family_of(char first_character) {
+        switch (first_character) {
+            case 'G':
+                return G_CODE;
+            case 'D':
+                return D_CODE;
+            case 'M':
+                return M_CODE;
+            case '%':
+                return EXTENDED;
+            default:
+                return OPERATION;
+        }
+    }
+
+    std::string_view ParseStats::family_name(Family family) {
+        switch (family) {
+            case G_CODE:
+                return "g_code";
+            case D_CODE:
+                return "d_code";
+            case M_CODE:
+                return "m_code";
+            case OPERATION:
+                return "operation";
+            case EXTENDED:
+                return "extended";
+            default:
+                return "unknown";
+        }
+    }
+
+    void ParseStats::collect(const File& file) {
+        StatsCollector collector(*this);
+        file.visit(collector);
+    }
+} // namespace gerber
@@ -1,16 +1,28 @@
 #include "gerber/parser.hpp"
+#include "gerber/archive.hpp"
 #include "gerber/ast/ast.hpp"
 #include "gerber/ast/command.hpp"
 #include "gerber/ast/m_codes/M02.hpp"
+#include "gerber/code_table.hpp"
+#include "gerber/parse_stats.hpp"
+#include "gerber/scanner.hpp"
 #include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <fmt/format.h>
+#include <functional>
+#include <iterator>
 #include <memory>
 #include <optional>
 #include <regex>
+#include <stdexcept>
+#include <stop_token>
 #include <string>
 #include <string_view>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 namespace gerber {
@@ -22,41 +34,286 @@ namespace gerber {
         return std::make_tuple(line_number, index - line_start);
     }
 
+    namespace {
+        // Number of commands parsed between checks of stop token.
+        constexpr uint32_t cancellation_check_interval = 1024;
+    } // namespace
+
+    const std::regex ParseContext::ad_header_regex{"^%ADD([1-9][0-9]*)([a-zA-Z0-9_]+),"};
+    const std::regex ParseContext::fs_regex{
+        "^%FS([TL])([IA])X([0-9])([0-9])Y([0-9])([0-9])\\*%"
+    };
+    const std::regex ParseContext::mo_regex{"^%MO(IN|MM)\\*%"};
+    const std::regex ParseContext::float_regex{"([+-]?((([0-9]+)(\\.[0-9]*)?)|(\\.[0-9]+)))"};
+    const std::regex ParseContext::name_regex{"([._a-zA-Z$][._a-zA-Z0-9]*)"};
+
     Parser::Parser() :
+        options() {}
+
+    Parser::Parser(const ParserOptions& options_) :
+        options(options_) {}
+
+    namespace {
+        File parse_source(
+            const ParserOptions& options,
+            const std::string&   source,
+            std::stop_token      stop_token,
+            ParseStats*          stats
+        ) {
+            if (options.borrow_source && !options.incremental) {
+                // Single copy of the whole source instead of one per text field.
+                auto         buffer = std::make_shared<const std::string>(source);
+                ParseContext context(options, *buffer, std::move(stop_token), stats, buffer);
+                return context.parse();
+            }
+            ParseContext context(options, source, std::move(stop_token), stats);
+            return context.parse();
+        }
+    } // namespace
+
+    File Parser::parse(const std::string& source) const {
+        return parse_source(options, source, {}, nullptr);
+    }
+
+    File Parser::parse(std::string&& source) const {
+        if (options.borrow_source) {
+            return parse(std::make_shared<const std::string>(std::move(source)));
+        }
+        return parse_source(options, source, {}, nullptr);
+    }
+
+    File Parser::parse(const std::string& source, std::stop_token stop_token) const {
+        return parse_source(options, source, std::move(stop_token), nullptr);
+    }
+
+    File Parser::parse(const std::string& source, ParseStats& stats) const {
+        return parse_source(options, source, {}, &stats);
+    }
+
+    File Parser::parse(std::shared_ptr<const std::string> source) const {
+        const std::string_view view = *source;
+        ParseContext           context(options, view, {}, nullptr, std::move(source));
+        return context.parse();
+    }
+
+    File Parser::parse_file(const std::string& path) const {
+        return parse(read_source_file(path));
+    }
+
+    void Parser::stream(const std::string_view& source, Visitor& visitor) const {
+        ParseContext context(options, source, {}, nullptr, nullptr, &visitor);
+        context.stream();
+    }
+
+    NodeSplice
+    Parser::reparse(File& file, const Span& edited, const std::string_view& text) const {
+        auto& nodes = file.getNodes();
+        auto& spans = file.getSpans();
+        if (!file.getSource() || spans.size() != nodes.size()) {
+            throw std::invalid_argument("File wasn't parsed with ParserOptions::incremental");
+        }
+        const auto& previous = *file.getSource();
+        if (edited.begin > edited.end || edited.end > previous.size()) {
+            throw std::invalid_argument("Edited range is outside of the source");
+        }
+
+        std::string updated;
+        updated.reserve(previous.size() - (edited.end - edited.begin) + text.size());
+        updated.append(previous, 0, edited.begin);
+        updated.append(text);
+        updated.append(previous, edited.end);
+        auto source = std::make_shared<const std::string>(std::move(updated));
+
+        // Position in the updated source of a position past the edit.
+        const auto shifted = [&](location_t position) {
+            return position - edited.end + edited.begin + text.size();
+        };
+
+        // Node ending right where the edit begins is reparsed too, the edit may extend
+        // it, eg. by appending digits to a coordinate.
+        auto first = std::lower_bound(
+            spans.begin(),
+            spans.end(),
+            edited.begin,
+            [](const Span& span, location_t position) { return span.end < position; }
+        );
+        // Where nodes of a statement begin depends on all of it, X1Y2D01* is a single
+        // operation, but X1Y2Y3D01* is split into coordinates, so parsing starts after
+        // the end of the previous statement.
+        while (first != spans.begin()) {
+            const char last = previous[std::prev(first)->end - 1];
+            if (last == '*' || last == '%') {
+                break;
+            }
+            --first;
+        }
+        // Candidates to resume at, nodes which begin after the edit.
+        auto next = std::lower_bound(
+            first,
+            spans.end(),
+            edited.end,
+            [](const Span& span, location_t position) { return span.begin < position; }
+        );
+        const location_t begin =
+            first == spans.end() ? edited.begin : std::min(first->begin, edited.begin);
+
+        ParserOptions incremental = options;
+        incremental.incremental   = true;
+        ParseContext context(incremental, *source);
+        auto         parsed = context.parse_until(begin, [&](location_t position) {
+            while (next != spans.end() && shifted(next->begin) < position) {
+                ++next;
+            }
+            return next != spans.end() && shifted(next->begin) == position;
+        });
+
+        const auto first_index = static_cast<std::size_t>(first - spans.begin());
+        const auto next_index  = static_cast<std::size_t>(next - spans.begin());
+        auto&      new_nodes   = parsed.getNodes();
+        auto&      new_spans   = parsed.getSpans();
+
+        for (auto span = next; span != spans.end(); ++span) {
+            span->begin = shifted(span->begin);
+            span->end   = shifted(span->end);
+        }
+        nodes.erase(nodes.begin() + first_index, nodes.begin() + next_index);
+        nodes.insert(
+            nodes.begin() + first_index,
+            std::make_move_iterator(new_nodes.begin()),
+            std::make_move_iterator(new_nodes.end())
+        );
+        spans.erase(spans.begin() + first_index, spans.begin() + next_index);
+        spans.insert(spans.begin() + first_index, new_spans.begin(), new_spans.end());
+        file.setSource(std::move(source));
+
+        return NodeSplice{first_index, next_index - first_index, new_nodes.size()};
+    }
+
+    ParseContext::ParseContext(
+        const ParserOptions&    options_,
+        const std::string_view& source,
+        std::stop_token                    stop_token_,
+        ParseStats*                        stats_,
+        std::shared_ptr<const std::string> buffer_,
+        Visitor*                           visitor_
+    ) :
+        options(options_),
         commands(0),
-        full_source(""),
-        global_index(0) {}
+        full_source(source),
+        global_index(0),
+        stop_token(std::move(stop_token_)),
+        stats(stats_),
+        buffer(std::move(buffer_)),
+        visitor(visitor_),
+        spans() {}
+
+    File ParseContext::parse() {
+        using clock = std::chrono::steady_clock;
+
+        const auto start = clock::now();
+
+        // Stage 1: count delimiters in a single vectorized sweep. Almost every command
+        // is terminated with '*', so their number is a good guess for our initial size
+        // of a vector. Positions aren't kept, parse_global() finds the end of each
+        // command by itself, so an index would only take memory proportional to source.
+        commands.reserve(Scanner::count_delimiters(full_source));
+
+        // Stage 2: parse commands, skipping whitespace between them.
+        if (stats == nullptr) {
+            parse_commands<false>();
+            return make_file();
+        }
 
-    File Parser::parse(const std::string& source) {
-        full_source = source;
+        const auto scanned = clock::now();
+        parse_commands<true>();
 
-        // In gerber usually each command is in a new line, so this can be
-        // a good guess for our initial size of a vector.
-        auto line_count = std::count(full_source.begin(), full_source.end(), '\n');
-        commands.clear();
-        commands.reserve(line_count);
+        File file = make_file();
+        stats->collect(file);
+        stats->bytes_scanned = full_source.size();
+        stats->peak_bytes    = file.memory_usage();
+        stats->scan_time     = scanned - start;
+        stats->total_time    = clock::now() - start;
+        return file;
+    }
 
-        global_index = 0;
+    File ParseContext::make_file() {
+        if (options.incremental) {
+            auto source = buffer ? buffer : std::make_shared<const std::string>(full_source);
+            return File(std::move(commands), std::move(source), std::move(spans));
+        }
+        return File(std::move(commands), std::move(buffer));
+    }
 
-        while (global_index < (full_source.size() - 1)) {
+    File ParseContext::parse_until(
+        location_t begin, const std::function<bool(location_t)>& resume
+    ) {
+        global_index = begin;
+        while (global_index < full_source.size()) {
+            global_index = Scanner::skip_whitespace(full_source, global_index);
+            if (global_index == full_source.size() || resume(global_index)) {
+                break;
+            }
+            const auto start = global_index;
             global_index += parse_global(full_source.substr(global_index), global_index);
+            record_spans(start);
         }
+        return File(std::move(commands), nullptr, std::move(spans));
+    }
 
-        return File(std::move(commands));
+    void ParseContext::stream() {
+        // Nodes aren't collected, so unlike parse() there is no vector to reserve.
+        parse_commands<false>();
     }
 
-    location_t Parser::parse_global(const std::string_view& source, const location_t& index) {
+    template <bool with_stats>
+    void ParseContext::parse_commands() {
+        global_index = 0;
+
+        const bool stop_possible = stop_token.stop_possible();
+        uint32_t   iteration     = 0;
+
+        while (global_index < full_source.size()) {
+            global_index = Scanner::skip_whitespace(full_source, global_index);
+            if (global_index == full_source.size()) {
+                break;
+            }
+            if (stop_possible && (++iteration % cancellation_check_interval) == 0 &&
+                stop_token.stop_requested()) {
+                throw CancelledError("Parsing was cancelled");
+            }
+
+            if constexpr (with_stats) {
+                const auto family = ParseStats::family_of(full_source[global_index]);
+                stats->family_commands[family]++;
+
+                if constexpr (ParseStats::timing_enabled) {
+                    const auto start = std::chrono::steady_clock::now();
+                    const auto begin = global_index;
+                    global_index += parse_global(full_source.substr(global_index), global_index);
+                    stats->family_time[family] += std::chrono::steady_clock::now() - start;
+                    record_spans(begin);
+                    continue;
+                }
+            }
+            const auto begin = global_index;
+            global_index += parse_global(full_source.substr(global_index), global_index);
+            record_spans(begin);
+
+            if (visitor != nullptr) {
+                for (const auto& command : commands) {
+                    command->visit(*visitor);
+                }
+                commands.clear();
+            }
+        }
+    }
+
+    location_t ParseContext::parse_global(const std::string_view& source, const location_t& index) {
         if (source.empty()) {
             return 0;
         }
 
         switch (source[0]) {
-            case ' ':
-            case '\n':
-            case '\r':
-                return 1;
-                break;
-
             case 'G':
                 return parse_g_code(source, index);
                 break;
@@ -66,13 +323,13 @@ namespace gerber {
                 break;
 
             case 'X':
-                return parse_coordinate<CoordinateX>(source, index);
+                return parse_operation_or_coordinate<CoordinateX>(source, index);
             case 'Y':
-                return parse_coordinate<CoordinateY>(source, index);
+                return parse_operation_or_coordinate<CoordinateY>(source, index);
             case 'I':
-                return parse_coordinate<CoordinateI>(source, index);
+                return parse_operation_or_coordinate<CoordinateI>(source, index);
             case 'J':
-                return parse_coordinate<CoordinateJ>(source, index);
+                return parse_operation_or_coordinate<CoordinateJ>(source, index);
 
             case '%':
                 return parse_extended_command(source, index);
@@ -88,7 +345,7 @@ namespace gerber {
         throw_syntax_error();
     }
 
-    [[noreturn]] void Parser::throw_syntax_error() {
+    [[noreturn]] void ParseContext::throw_syntax_error() {
         const auto [line, column]  = get_line_column(full_source, global_index);
         const auto next_endl_index = full_source.find("\n", global_index);
         const auto next_endl_or_end_index =
@@ -109,7 +366,7 @@ namespace gerber {
         throw SyntaxError(message);
     }
 
-    offset_t Parser::parse_aperture(const std::string_view& source) {
+    offset_t ParseContext::parse_aperture(const std::string_view& source) {
         // Shortest possible aperture related node is %AB*%, so 5 chars at least.
         if (source.length() < 5) {
             throw_syntax_error();
@@ -131,7 +388,7 @@ namespace gerber {
         throw_syntax_error();
     }
 
-    offset_t Parser::parse_aperture_definition(const std::string_view& source) {
+    offset_t ParseContext::parse_aperture_definition(const std::string_view& source) {
         std::cmatch match;
 
         const auto result = std::regex_search(
@@ -145,7 +402,7 @@ namespace gerber {
         auto offset = 0;
 
         if (result && match.size() == 3) {
-            const auto aperture_id   = match[1].str();
+            const auto aperture_id   = std::string_view(match[1].first, match[1].length());
             const auto template_name = match[2].str();
             offset += match.length();
 
@@ -181,8 +438,8 @@ namespace gerber {
         throw_syntax_error();
     }
 
-    offset_t Parser::parse_standard_aperture_c_tail(
-        const std::string_view& source, const std::string& aperture_id
+    offset_t ParseContext::parse_standard_aperture_c_tail(
+        const std::string_view& source, const std::string_view& aperture_id
     ) {
         std::string_view rest   = source;
         offset_t         offset = 0;
@@ -197,12 +454,12 @@ namespace gerber {
         consume_char(rest, offset, '*');
         consume_char(rest, offset, '%');
 
-        commands.push_back(std::make_shared<ADC>(aperture_id, diameter, holeDiameter));
+        commands.push_back(std::make_shared<ADC>(text(aperture_id), diameter, holeDiameter));
         return offset;
     }
 
-    offset_t Parser::parse_standard_aperture_p_tail(
-        const std::string_view& source, const std::string& aperture_id
+    offset_t ParseContext::parse_standard_aperture_p_tail(
+        const std::string_view& source, const std::string_view& aperture_id
     ) {
         std::string_view rest   = source;
         offset_t         offset = 0;
@@ -224,12 +481,14 @@ namespace gerber {
         consume_char(rest, offset, '%');
 
         commands.push_back(
-            std::make_shared<ADP>(aperture_id, outerDiameter, verticesCount, rotation, holeDiameter)
+            std::make_shared<ADP>(
+                text(aperture_id), outerDiameter, verticesCount, rotation, holeDiameter
+            )
         );
         return offset;
     }
 
-    [[nodiscard]] double Parser::consume_float(std::string_view& source, offset_t& offset) {
+    [[nodiscard]] double ParseContext::consume_float(std::string_view& source, offset_t& offset) {
         auto float_str = match_float(source);
 
         offset += float_str.length();
@@ -238,7 +497,7 @@ namespace gerber {
         return std::stod(float_str);
     }
 
-    char Parser::consume_char(std::string_view& source, offset_t& offset, char expected) {
+    char ParseContext::consume_char(std::string_view& source, offset_t& offset, char expected) {
         match_char(source, expected);
 
         offset += 1;
@@ -247,7 +506,7 @@ namespace gerber {
         return expected;
     }
 
-    bool Parser::try_consume_char(std::string_view& source, offset_t& offset, char expected) {
+    bool ParseContext::try_consume_char(std::string_view& source, offset_t& offset, char expected) {
         if (source.empty() || source[0] != expected) {
             return false;
         }
@@ -258,8 +517,10 @@ namespace gerber {
         return true;
     }
 
-    std::string
-    Parser::consume_regex(std::string_view& source, offset_t& offset, std::regex& expected) {
+    std::string_view
+    ParseContext::consume_regex(
+        std::string_view& source, offset_t& offset, const std::regex& expected
+    ) {
         std::cmatch match;
 
         const auto result = std::regex_search(
@@ -270,22 +531,23 @@ namespace gerber {
             std::regex_constants::match_continuous
         );
         if (result && match.size() >= 1) {
-            auto match_length = match.length();
+            auto       match_length = match.length();
+            const auto matched      = source.substr(0, match_length);
             offset += match_length;
             source = source.substr(match_length);
-            return match[0].str();
+            return matched;
         }
         throw_syntax_error();
     }
 
-    offset_t Parser::match_char(const std::string_view& source, char expected) {
+    offset_t ParseContext::match_char(const std::string_view& source, char expected) {
         if (source.empty() || source[0] != expected) {
             throw_syntax_error();
         }
         return 1;
     }
 
-    std::string Parser::match_float(const std::string_view& source) {
+    std::string ParseContext::match_float(const std::string_view& source) {
         std::cmatch match;
 
         const auto result = std::regex_search(
@@ -301,7 +563,7 @@ namespace gerber {
         throw_syntax_error();
     }
 
-    offset_t Parser::parse_aperture_macro(const std::string_view& source) {
+    offset_t ParseContext::parse_aperture_macro(const std::string_view& source) {
         std::shared_ptr<AMopen>    amOpen;
         AM::primitives_container_t primitives;
         std::shared_ptr<AMclose>   amClose;
@@ -323,7 +585,7 @@ namespace gerber {
         return offset;
     }
 
-    void Parser::parse_aperture_macro_open(
+    void ParseContext::parse_aperture_macro_open(
         std::string_view& source, offset_t& offset, std::shared_ptr<AMopen>& amOpen
     ) {
         consume_char(source, offset, '%');
@@ -332,23 +594,23 @@ namespace gerber {
         auto name = consume_regex(source, offset, name_regex);
         consume_char(source, offset, '*');
 
-        amOpen = std::make_shared<AMopen>(name);
+        amOpen = std::make_shared<AMopen>(text(name));
     }
 
-    offset_t Parser::parse_aperture_macro_primitive(
+    offset_t ParseContext::parse_aperture_macro_primitive(
         const std::string_view& source, AM::primitives_container_t& primitives
     ) {
         return 0;
     }
 
-    void Parser::parse_aperture_macro_close(
+    void ParseContext::parse_aperture_macro_close(
         std::string_view& source, offset_t& offset, std::shared_ptr<AMclose>& amClose
     ) {
         consume_char(source, offset, '%');
         amClose = std::make_shared<AMclose>();
     }
 
-    void Parser::skip_whitespace(std::string_view& source, offset_t& offset) {
+    void ParseContext::skip_whitespace(std::string_view& source, offset_t& offset) {
         offset_t local_offset = 0;
         while (local_offset < source.length() && std::isspace(source[local_offset])) {
             local_offset++;
@@ -357,138 +619,129 @@ namespace gerber {
         offset += local_offset;
     }
 
-    offset_t Parser::parse_g_code(const std::string_view& gerber, const location_t& index) {
-        std::cmatch match;
+    offset_t ParseContext::parse_code(const std::string_view& source, CodeNumber& number) {
+        // Leading zeros are allowed, but code number itself can't be zero.
+        offset_t offset = 1;
+        while (offset < source.size() && source[offset] == '0') {
+            offset++;
+        }
+        number = scan_code_number(source.substr(offset));
+        if (number.length == 0) {
+            throw_syntax_error();
+        }
+        return offset;
+    }
 
-        bool result = std::regex_search(
-            gerber.data(),
-            gerber.data() + gerber.size(),
-            match,
-            g_code_regex,
-            std::regex_constants::match_continuous
-        );
-        if (result && match.size() > 1) {
-            auto       match_string = match[1].str();
-            const auto g_code_value = std::stoi(match_string);
-
-            switch (g_code_value) {
-                case 1:
-                    commands.push_back(std::make_shared<G01>());
-                    return match.length();
-                case 2:
-                    commands.push_back(std::make_shared<G02>());
-                    return match.length();
-                case 3:
-                    commands.push_back(std::make_shared<G03>());
-                    return match.length();
-                case 4:
-                    commands.push_back(std::make_shared<G04>(""));
-                    return match.length();
-                case 36:
-                    commands.push_back(std::make_shared<G36>());
-                    return match.length();
-                case 37:
-                    commands.push_back(std::make_shared<G37>());
-                    return match.length();
-                case 54:
-                    commands.push_back(std::make_shared<G54>());
-                    return match.length();
-                case 55:
-                    commands.push_back(std::make_shared<G55>());
-                    return match.length();
-                case 70:
-                    commands.push_back(std::make_shared<G70>());
-                    return match.length();
-                case 71:
-                    commands.push_back(std::make_shared<G71>());
-                    return match.length();
-                case 74:
-                    commands.push_back(std::make_shared<G74>());
-                    return match.length();
-                case 75:
-                    commands.push_back(std::make_shared<G75>());
-                    return match.length();
-                case 90:
-                    commands.push_back(std::make_shared<G90>());
-                    return match.length();
-                case 91:
-                    commands.push_back(std::make_shared<G91>());
-                    return match.length();
+    offset_t ParseContext::parse_g_code(const std::string_view& source, const location_t& index) {
+        CodeNumber     number;
+        const auto     begin = parse_code(source, number);
+        const offset_t end   = begin + number.length;
+
+        if (end < source.size() && source[end] == '*') {
+            const auto factory = g_code_table.find(number.value);
+            if (factory != nullptr) {
+                commands.push_back(factory(text(source.substr(begin, number.length))));
+                return end + 1;
             }
         }
-        result = std::regex_search(
-            gerber.data(),
-            gerber.data() + gerber.size(),
-            match,
-            g04_regex,
-            std::regex_constants::match_continuous
-        );
-        if (result && match.size() > 1) {
-            commands.push_back(std::make_shared<G04>(match[1].str()));
-            return match.length();
+        // Anything else after G04 is a comment, including digits, so G041st layer* is
+        // a comment "1st layer" and not G41.
+        if (source[begin] == '4') {
+            const auto comment_begin = begin + 1;
+            const auto comment_end   = source.find_first_of("%*", comment_begin);
+            if (comment_end != std::string_view::npos && comment_end > comment_begin &&
+                source[comment_end] == '*') {
+                const auto comment = source.substr(comment_begin, comment_end - comment_begin);
+                commands.push_back(std::make_shared<G04>(text(comment)));
+                return comment_end + 1;
+            }
         }
-
         throw_syntax_error();
     }
 
-    offset_t Parser::parse_m_code(const std::string_view& gerber) {
-        std::cmatch match;
+    offset_t ParseContext::parse_m_code(const std::string_view& source) {
+        CodeNumber     number;
+        const auto     begin = parse_code(source, number);
+        const offset_t end   = begin + number.length;
 
-        bool result = std::regex_search(
-            gerber.data(),
-            gerber.data() + gerber.size(),
-            match,
-            m_code_regex,
-            std::regex_constants::match_continuous
-        );
-        if (result && match.size() > 1) {
-            auto       match_string = match[1].str();
-            const auto m_code_value = std::stoi(match_string);
-
-            switch (m_code_value) {
-                case 2:
-                    commands.push_back(std::make_shared<M02>());
-                    return match.length();
+        if (end < source.size() && source[end] == '*') {
+            const auto factory = m_code_table.find(number.value);
+            if (factory != nullptr) {
+                commands.push_back(factory(text(source.substr(begin, number.length))));
+                return end + 1;
             }
         }
+        throw_syntax_error();
+    }
+
+    offset_t ParseContext::parse_d_code(const std::string_view& source, const location_t& index) {
+        CodeNumber     number;
+        const auto     begin = parse_code(source, number);
+        const offset_t end   = begin + number.length;
 
+        if (end < source.size() && source[end] == '*') {
+            const auto factory = d_code_table.find(number.value);
+            commands.push_back(factory(text(source.substr(begin, number.length))));
+            return end + 1;
+        }
         throw_syntax_error();
     }
 
-    offset_t Parser::parse_d_code(const std::string_view& gerber, const location_t& index) {
-        std::cmatch match;
+    offset_t ParseContext::parse_operation(const std::string_view& source) {
+        constexpr char                  axes[] = {'X', 'Y', 'I', 'J'};
+        std::optional<std::string_view> coordinates[4];
 
-        bool result = std::regex_search(
-            gerber.data(),
-            gerber.data() + gerber.size(),
-            match,
-            d_code_regex,
-            std::regex_constants::match_continuous
-        );
-        if (result && match.size() > 1) {
-            auto       match_string = match[1].str();
-            const auto d_code_value = std::stoi(match_string);
-
-            switch (d_code_value) {
-                case 1:
-                    commands.push_back(std::make_shared<D01>());
-                    return match.length();
-                case 2:
-                    commands.push_back(std::make_shared<D02>());
-                    return match.length();
-                case 3:
-                    commands.push_back(std::make_shared<D03>());
-                    return match.length();
-                default:
-                    commands.push_back(std::make_shared<Dnn>(match_string));
-                    return match.length();
+        const auto size   = source.size();
+        offset_t   offset = 0;
+
+        for (int axis = 0; axis < 4; axis++) {
+            if (offset >= size || source[offset] != axes[axis]) {
+                continue;
+            }
+            offset_t begin = offset + 1;
+            offset_t end   = begin;
+            if (end < size && (source[end] == '+' || source[end] == '-')) {
+                end++;
+            }
+            const offset_t digits = end;
+            while (end < size && std::isdigit(static_cast<unsigned char>(source[end]))) {
+                end++;
+            }
+            if (end == digits) {
+                return 0;
             }
+            coordinates[axis] = source.substr(begin, end - begin);
+            offset            = end;
         }
 
-        throw_syntax_error();
+        // Operation code, D01, D02 or D03 with any number of leading zeros.
+        if (offset >= size || source[offset] != 'D') {
+            return 0;
+        }
+        offset++;
+        while (offset < size && source[offset] == '0') {
+            offset++;
+        }
+        if (offset + 1 >= size || source[offset] < '1' || source[offset] > '3' ||
+            source[offset + 1] != '*') {
+            return 0;
+        }
+        const auto kind = static_cast<Operation::Kind>(source[offset] - '0');
+
+        const auto optional_text = [this](const std::optional<std::string_view>& slice) {
+            return slice.has_value() ? std::optional<Text>(text(*slice)) : std::nullopt;
+        };
+        commands.push_back(std::make_shared<Operation>(
+            kind,
+            optional_text(coordinates[0]),
+            optional_text(coordinates[1]),
+            optional_text(coordinates[2]),
+            optional_text(coordinates[3])
+        ));
+        return offset + 2;
     }
 
-    offset_t Parser::parse_integer(const std::string_view& source) {
+    offset_t ParseContext::parse_integer(const std::string_view& source) {
         // Shortest possible integer is 0* or alike.
         if (source.empty()) {
             throw_syntax_error();
@@ -508,7 +761,7 @@ namespace gerber {
     }
 
     offset_t
-    Parser::parse_extended_command(const std::string_view& source, const location_t& index) {
+    ParseContext::parse_extended_command(const std::string_view& source, const location_t& index) {
         // Shortest possible extended command is probably %TD*%, so 5 chars at least.
         if (source.length() < 5) {
             throw_syntax_error();
@@ -538,7 +791,7 @@ namespace gerber {
         throw_syntax_error();
     }
 
-    offset_t Parser::parse_load_command(const std::string_view& source, const location_t& index) {
+    offset_t ParseContext::parse_load_command(const std::string_view& source, const location_t& index) {
         // Shortest possible load command is %LPD*%, so 6 chars at least.
         if (source.length() < 6) {
             throw_syntax_error();
@@ -566,7 +819,7 @@ namespace gerber {
         throw_syntax_error();
     }
 
-    offset_t Parser::parse_fs_command(const std::string_view& source, const location_t& index) {
+    offset_t ParseContext::parse_fs_command(const std::string_view& source, const location_t& index) {
         if (source.length() < 13) {
             throw_syntax_error();
         }
@@ -593,7 +846,7 @@ namespace gerber {
         throw_syntax_error();
     }
 
-    offset_t Parser::parse_mo_command(const std::string_view& source, const location_t& index) {
+    offset_t ParseContext::parse_mo_command(const std::string_view& source, const location_t& index) {
         if (source.length() < 6) {
             throw_syntax_error();
         }
@@ -0,0 +1,359 @@
+#include "gerber/raster.hpp"
+#include "gerber/ast/ast.hpp"
+#include "gerber/flatten.hpp"
+#include "gerber/interpreter.hpp"
+#include "gerber/thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace gerber {
+
+    namespace {
+        /**
+         * Polygon edge in pixel coordinates, oriented bottom to top.
+         */
+        class PixelEdge {
+          public:
+            double y0;
+            double y1;
+            double x0;
+            double slope;
+        };
+
+        /**
+         * Half-open range of set pixels of a row.
+         */
+        class PixelSpan {
+          public:
+            int64_t begin;
+            int64_t end;
+        };
+
+        using Row = std::vector<PixelSpan>;
+
+        uint64_t mix(uint64_t hash, int64_t value) {
+            hash ^= static_cast<uint64_t>(value);
+            hash *= 0x100000001b3ULL;
+            return hash ^ (hash >> 29);
+        }
+
+        /**
+         * Area covered by polygons, in pixels, with origin at the bottom left corner.
+         */
+        class Grid {
+          public:
+            Point   origin;
+            double  resolution;
+            int64_t width;
+            int64_t height;
+        };
+
+        std::vector<PixelEdge>
+        pixel_edges(const std::vector<Polygon>& polygons, const Grid& grid) {
+            std::vector<PixelEdge> edges;
+            const auto add_ring = [&](const std::vector<Point>& ring) {
+                for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+                    const double ax = (ring[j].x - grid.origin.x) / grid.resolution;
+                    const double ay = (ring[j].y - grid.origin.y) / grid.resolution;
+                    const double bx = (ring[i].x - grid.origin.x) / grid.resolution;
+                    const double by = (ring[i].y - grid.origin.y) / grid.resolution;
+                    if (ay == by) {
+                        continue;
+                    }
+                    if (ay < by) {
+                        edges.push_back(PixelEdge{ay, by, ax, (bx - ax) / (by - ay)});
+                    } else {
+                        edges.push_back(PixelEdge{by, ay, bx, (ax - bx) / (ay - by)});
+                    }
+                }
+            };
+            for (const auto& polygon : polygons) {
+                add_ring(polygon.outer);
+                for (const auto& hole : polygon.holes) {
+                    add_ring(hole);
+                }
+            }
+            std::sort(edges.begin(), edges.end(), [](const PixelEdge& a, const PixelEdge& b) {
+                return a.y0 < b.y0;
+            });
+            return edges;
+        }
+
+        /**
+         * Scan convert rows [row_begin, row_end) into spans with even-odd rule, which
+         * is exact for flattened polygons as they don't overlap.
+         */
+        std::vector<Row> scan_rows(
+            const std::vector<PixelEdge>& edges,
+            const Grid&                   grid,
+            int64_t                       row_begin,
+            int64_t                       row_end
+        ) {
+            std::vector<Row>              rows(row_end - row_begin);
+            std::vector<const PixelEdge*> active;
+            std::vector<double>           crossings;
+
+            // Edges are sorted by y0, they become active once the scanline reaches them.
+            auto next = edges.begin();
+            for (int64_t row = row_begin; row < row_end; row++) {
+                const double y = row + 0.5;
+                for (; next != edges.end() && next->y0 <= y; ++next) {
+                    if (next->y1 > y) {
+                        active.push_back(&*next);
+                    }
+                }
+                std::erase_if(active, [y](const PixelEdge* edge) { return edge->y1 <= y; });
+
+                crossings.clear();
+                for (const auto* edge : active) {
+                    crossings.push_back(edge->x0 + (y - edge->y0) * edge->slope);
+                }
+                std::sort(crossings.begin(), crossings.end());
+
+                auto& spans = rows[row - row_begin];
+                for (size_t i = 0; i + 1 < crossings.size(); i += 2) {
+                    // Pixel is set when its center lies in [left, right).
+                    const auto begin = std::clamp<int64_t>(
+                        static_cast<int64_t>(std::ceil(crossings[i] - 0.5)), 0, grid.width
+                    );
+                    const auto end = std::clamp<int64_t>(
+                        static_cast<int64_t>(std::ceil(crossings[i + 1] - 0.5)), 0, grid.width
+                    );
+                    if (begin >= end) {
+                        continue;
+                    }
+                    if (!spans.empty() && spans.back().end >= begin) {
+                        spans.back().end = std::max(spans.back().end, end);
+                    } else {
+                        spans.push_back(PixelSpan{begin, end});
+                    }
+                }
+            }
+            return rows;
+        }
+
+        std::vector<uint64_t>
+        tile_hashes(const std::vector<Row>& rows, int64_t tile_size, int64_t columns) {
+            std::vector<uint64_t> hashes(columns, 0xcbf29ce484222325ULL);
+            for (size_t row = 0; row < rows.size(); row++) {
+                for (const auto& span : rows[row]) {
+                    for (int64_t column = span.begin / tile_size;
+                         column * tile_size < span.end;
+                         column++) {
+                        const int64_t begin = std::max(span.begin, column * tile_size);
+                        const int64_t end   = std::min(span.end, (column + 1) * tile_size);
+                        auto&         hash  = hashes[column];
+                        hash = mix(mix(mix(hash, static_cast<int64_t>(row)), begin), end);
+                    }
+                }
+            }
+            return hashes;
+        }
+
+        /**
+         * Pixels set in exactly one of the rows.
+         */
+        Row symmetric_difference(const Row& a, const Row& b) {
+            std::vector<std::pair<int64_t, int>> bounds;
+            for (const auto* row : {&a, &b}) {
+                for (const auto& span : *row) {
+                    bounds.push_back({span.begin, 1});
+                    bounds.push_back({span.end, -1});
+                }
+            }
+            std::sort(bounds.begin(), bounds.end());
+
+            Row     result;
+            int     depth    = 0;
+            int64_t previous = 0;
+            for (size_t i = 0; i < bounds.size();) {
+                const int64_t x = bounds[i].first;
+                if (depth == 1 && previous < x) {
+                    if (!result.empty() && result.back().end == previous) {
+                        result.back().end = x;
+                    } else {
+                        result.push_back(PixelSpan{previous, x});
+                    }
+                }
+                for (; i < bounds.size() && bounds[i].first == x; i++) {
+                    depth += bounds[i].second;
+                }
+                previous = x;
+            }
+            return result;
+        }
+
+        BoundingBox polygons_bounds(const std::vector<Polygon>& polygons) {
+            BoundingBox bounds;
+            for (const auto& polygon : polygons) {
+                for (const auto& point : polygon.outer) {
+                    bounds.include(point);
+                }
+            }
+            return bounds;
+        }
+    } // namespace
+
+    bool RasterComparison::identical() const {
+        return different_pixels == 0;
+    }
+
+    RasterComparison RasterComparator::compare(
+        const File& before, const File& after, const RasterOptions& options
+    ) {
+        FlattenOptions flatten_options;
+        // Chord error well below a pixel doesn't change any pixel center.
+        flatten_options.tolerance = options.resolution / 4;
+        flatten_options.threads   = options.threads;
+
+        const auto before_polygons =
+            Flattener::flatten(Interpreter::interpret(before), flatten_options);
+        const auto after_polygons =
+            Flattener::flatten(Interpreter::interpret(after), flatten_options);
+        return compare(before_polygons, after_polygons, options);
+    }
+
+    RasterComparison RasterComparator::compare(
+        const std::vector<Polygon>& before,
+        const std::vector<Polygon>& after,
+        const RasterOptions&        options
+    ) {
+        if (!(options.resolution > 0)) {
+            throw std::invalid_argument("Raster resolution must be positive");
+        }
+        if (options.tile_size == 0) {
+            throw std::invalid_argument("Raster tile size must be positive");
+        }
+
+        BoundingBox bounds = polygons_bounds(before);
+        bounds.include(polygons_bounds(after));
+        RasterComparison result;
+        if (bounds.empty) {
+            return result;
+        }
+
+        const double res = options.resolution;
+        Grid         grid{
+            Point{std::floor(bounds.min.x / res) * res, std::floor(bounds.min.y / res) * res},
+            res,
+            0,
+            0,
+        };
+        grid.width  = static_cast<int64_t>(std::ceil((bounds.max.x - grid.origin.x) / res)) + 1;
+        grid.height = static_cast<int64_t>(std::ceil((bounds.max.y - grid.origin.y) / res)) + 1;
+
+        const auto    before_edges = pixel_edges(before, grid);
+        const auto    after_edges  = pixel_edges(after, grid);
+        const int64_t tile         = options.tile_size;
+        const int64_t columns      = (grid.width + tile - 1) / tile;
+        const int64_t bands        = (grid.height + tile - 1) / tile;
+
+        class BandResult {
+          public:
+            std::vector<RasterDifference> regions;
+            uint64_t                      identical_tiles = 0;
+        };
+        std::vector<BandResult>         band_results(bands);
+        std::vector<std::exception_ptr> errors(bands);
+        {
+            const size_t threads = options.threads == 0
+                                       ? std::max(1u, std::thread::hardware_concurrency())
+                                       : options.threads;
+            ThreadPool   pool(std::max<size_t>(1, std::min<size_t>(threads, bands)));
+            for (int64_t band = 0; band < bands; band++) {
+                pool.submit([&, band]() {
+                    try {
+                        const int64_t row_begin = band * tile;
+                        const int64_t row_end   = std::min(grid.height, row_begin + tile);
+                        const auto before_rows = scan_rows(before_edges, grid, row_begin, row_end);
+                        const auto after_rows  = scan_rows(after_edges, grid, row_begin, row_end);
+                        const auto before_hashes = tile_hashes(before_rows, tile, columns);
+                        const auto after_hashes  = tile_hashes(after_rows, tile, columns);
+
+                        // Per differing tile: pixel count and extent of differing pixels.
+                        class TileDifference {
+                          public:
+                            uint64_t pixels  = 0;
+                            int64_t  min_col = std::numeric_limits<int64_t>::max();
+                            int64_t  max_col = std::numeric_limits<int64_t>::min();
+                            int64_t  min_row = std::numeric_limits<int64_t>::max();
+                            int64_t  max_row = std::numeric_limits<int64_t>::min();
+                        };
+                        std::vector<TileDifference> tiles(columns);
+                        auto& band_result = band_results[band];
+                        for (int64_t column = 0; column < columns; column++) {
+                            if (before_hashes[column] == after_hashes[column]) {
+                                band_result.identical_tiles++;
+                            }
+                        }
+                        if (band_result.identical_tiles == static_cast<uint64_t>(columns)) {
+                            return;
+                        }
+
+                        for (int64_t row = row_begin; row < row_end; row++) {
+                            const auto difference = symmetric_difference(
+                                before_rows[row - row_begin], after_rows[row - row_begin]
+                            );
+                            for (const auto& span : difference) {
+                                for (int64_t column = span.begin / tile;
+                                     column * tile < span.end;
+                                     column++) {
+                                    if (before_hashes[column] == after_hashes[column]) {
+                                        continue;
+                                    }
+                                    const int64_t begin = std::max(span.begin, column * tile);
+                                    const int64_t end = std::min(span.end, (column + 1) * tile);
+                                    auto&         t   = tiles[column];
+                                    t.pixels += end - begin;
+                                    t.min_col = std::min(t.min_col, begin);
+                                    t.max_col = std::max(t.max_col, end);
+                                    t.min_row = std::min(t.min_row, row);
+                                    t.max_row = std::max(t.max_row, row + 1);
+                                }
+                            }
+                        }
+
+                        for (const auto& t : tiles) {
+                            if (t.pixels == 0) {
+                                continue;
+                            }
+                            RasterDifference difference{BoundingBox(), t.pixels};
+                            difference.bounds.include(Point{
+                                grid.origin.x + t.min_col * res, grid.origin.y + t.min_row * res
+                            });
+                            difference.bounds.include(Point{
+                                grid.origin.x + t.max_col * res, grid.origin.y + t.max_row * res
+                            });
+                            band_result.regions.push_back(difference);
+                        }
+                    } catch (...) {
+                        errors[band] = std::current_exception();
+                    }
+                });
+            }
+        }
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+        result.tiles = static_cast<uint64_t>(columns * bands);
+        for (const auto& band : band_results) {
+            result.identical_tiles += band.identical_tiles;
+            for (const auto& region : band.regions) {
+                result.different_pixels += region.pixels;
+                result.regions.push_back(region);
+            }
+        }
+        return result;
+    }
+} // namespace gerber
@@ -0,0 +1,325 @@
+#include "gerber/scanner.hpp"
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define GERBER_SCANNER_X86_64 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+    #endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define GERBER_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+    #define GERBER_TARGET_AVX2
+#endif
+
+namespace gerber {
+
+    namespace {
+        constexpr location_t block_size = 64;
+
+        class BlockMasks {
+          public:
+            uint64_t delimiters;
+            uint64_t whitespace;
+        };
+
+        inline BlockMasks scan_block_scalar(const char* block) {
+            uint64_t delimiters = 0;
+            uint64_t whitespace = 0;
+
+            for (location_t i = 0; i < block_size; i++) {
+                const char c = block[i];
+                delimiters |= static_cast<uint64_t>(c == '*' || c == '%') << i;
+                whitespace |= static_cast<uint64_t>(c == ' ' || c == '\n' || c == '\r') << i;
+            }
+            return {delimiters, whitespace};
+        }
+
+#ifdef GERBER_SCANNER_X86_64
+        inline BlockMasks scan_block_sse2(const char* block) {
+            const __m128i star   = _mm_set1_epi8('*');
+            const __m128i pct    = _mm_set1_epi8('%');
+            const __m128i space  = _mm_set1_epi8(' ');
+            const __m128i lf     = _mm_set1_epi8('\n');
+            const __m128i cr     = _mm_set1_epi8('\r');
+            uint64_t      delims = 0;
+            uint64_t      spaces = 0;
+
+            for (int i = 0; i < 4; i++) {
+                const __m128i chunk =
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i * 16));
+
+                const __m128i d =
+                    _mm_or_si128(_mm_cmpeq_epi8(chunk, star), _mm_cmpeq_epi8(chunk, pct));
+                const __m128i w = _mm_or_si128(
+                    _mm_cmpeq_epi8(chunk, space),
+                    _mm_or_si128(_mm_cmpeq_epi8(chunk, lf), _mm_cmpeq_epi8(chunk, cr))
+                );
+                delims |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(d)))
+                       << (i * 16);
+                spaces |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(w)))
+                       << (i * 16);
+            }
+            return {delims, spaces};
+        }
+
+        GERBER_TARGET_AVX2 inline BlockMasks scan_block_avx2(const char* block) {
+            const __m256i star   = _mm256_set1_epi8('*');
+            const __m256i pct    = _mm256_set1_epi8('%');
+            const __m256i space  = _mm256_set1_epi8(' ');
+            const __m256i lf     = _mm256_set1_epi8('\n');
+            const __m256i cr     = _mm256_set1_epi8('\r');
+            uint64_t      delims = 0;
+            uint64_t      spaces = 0;
+
+            for (int i = 0; i < 2; i++) {
+                const __m256i chunk =
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i * 32));
+
+                const __m256i d =
+                    _mm256_or_si256(_mm256_cmpeq_epi8(chunk, star), _mm256_cmpeq_epi8(chunk, pct));
+                const __m256i w = _mm256_or_si256(
+                    _mm256_cmpeq_epi8(chunk, space),
+                    _mm256_or_si256(_mm256_cmpeq_epi8(chunk, lf), _mm256_cmpeq_epi8(chunk, cr))
+                );
+                delims |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(d)))
+                       << (i * 32);
+                spaces |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(w)))
+                       << (i * 32);
+            }
+            return {delims, spaces};
+        }
+#endif
+
+        /**
+         * Turns block bitmasks into index entries. Whitespace runs are tracked with
+         * transition masks, run which is still open at the end of the block is carried
+         * over to the next one.
+         */
+        class IndexBuilder {
+          public:
+            StructuralIndex index;
+            uint64_t        carry      = 0;
+            size_t          first_open = 0;
+
+            inline void consume(location_t base, BlockMasks masks) {
+                uint64_t delimiters = masks.delimiters;
+                while (delimiters) {
+                    index.delimiters.push_back(base + std::countr_zero(delimiters));
+                    delimiters &= delimiters - 1;
+                }
+
+                const uint64_t previous = (masks.whitespace << 1) | carry;
+                uint64_t       starts   = masks.whitespace & ~previous;
+                uint64_t       ends     = ~masks.whitespace & previous;
+                carry                   = masks.whitespace >> 63;
+
+                // Starts and ends alternate, so every end closes the oldest open run.
+                while (starts) {
+                    const location_t begin = base + std::countr_zero(starts);
+                    index.whitespace.push_back(Span{begin, begin});
+                    starts &= starts - 1;
+                }
+                while (ends) {
+                    index.whitespace[first_open++].end = base + std::countr_zero(ends);
+                    ends &= ends - 1;
+                }
+            }
+
+            inline StructuralIndex finish(location_t size) {
+                if (first_open < index.whitespace.size()) {
+                    index.whitespace[first_open++].end = size;
+                }
+                return std::move(index);
+            }
+        };
+
+        inline IndexBuilder make_builder(const std::string_view& source) {
+            IndexBuilder builder;
+            // Gerber commands are short, usually there is a delimiter every 8-16 bytes.
+            builder.index.delimiters.reserve(source.size() / 8);
+            builder.index.whitespace.reserve(source.size() / 16);
+            return builder;
+        }
+
+        /**
+         * Copy the incomplete last block into a padded buffer. Padding is neither
+         * delimiter nor whitespace, so it can't produce entries past the end of source.
+         */
+        inline void pad_tail(const std::string_view& source, location_t offset, char* tail) {
+            std::memset(tail, 'G', block_size);
+            std::memcpy(tail, source.data() + offset, source.size() - offset);
+        }
+
+        template <BlockMasks (*scan_block)(const char*)>
+        StructuralIndex scan_with(const std::string_view& source) {
+            IndexBuilder     builder = make_builder(source);
+            const location_t size    = source.size();
+            location_t       offset  = 0;
+
+            for (; offset + block_size <= size; offset += block_size) {
+                builder.consume(offset, scan_block(source.data() + offset));
+            }
+            if (offset < size) {
+                char tail[block_size];
+                pad_tail(source, offset, tail);
+                builder.consume(offset, scan_block(tail));
+            }
+            return builder.finish(size);
+        }
+
+#ifdef GERBER_SCANNER_X86_64
+        // Spelled out separately from scan_with, as template instantiations do not
+        // inherit target attributes and block scanning would not get inlined.
+        GERBER_TARGET_AVX2 StructuralIndex scan_avx2(const std::string_view& source) {
+            IndexBuilder     builder = make_builder(source);
+            const location_t size    = source.size();
+            location_t       offset  = 0;
+
+            for (; offset + block_size <= size; offset += block_size) {
+                builder.consume(offset, scan_block_avx2(source.data() + offset));
+            }
+            if (offset < size) {
+                char tail[block_size];
+                pad_tail(source, offset, tail);
+                builder.consume(offset, scan_block_avx2(tail));
+            }
+            return builder.finish(size);
+        }
+#endif
+
+        template <BlockMasks (*scan_block)(const char*)>
+        location_t count_with(const std::string_view& source) {
+            const location_t size   = source.size();
+            location_t       count  = 0;
+            location_t       offset = 0;
+
+            for (; offset + block_size <= size; offset += block_size) {
+                count += std::popcount(scan_block(source.data() + offset).delimiters);
+            }
+            if (offset < size) {
+                char tail[block_size];
+                pad_tail(source, offset, tail);
+                count += std::popcount(scan_block(tail).delimiters);
+            }
+            return count;
+        }
+
+#ifdef GERBER_SCANNER_X86_64
+        GERBER_TARGET_AVX2 location_t count_avx2(const std::string_view& source) {
+            const location_t size   = source.size();
+            location_t       count  = 0;
+            location_t       offset = 0;
+
+            for (; offset + block_size <= size; offset += block_size) {
+                count += std::popcount(scan_block_avx2(source.data() + offset).delimiters);
+            }
+            if (offset < size) {
+                char tail[block_size];
+                pad_tail(source, offset, tail);
+                count += std::popcount(scan_block_avx2(tail).delimiters);
+            }
+            return count;
+        }
+#endif
+
+        inline bool is_whitespace(char c) {
+            return c == ' ' || c == '\n' || c == '\r';
+        }
+
+        bool cpu_supports_avx2() {
+#if defined(GERBER_SCANNER_X86_64) && (defined(__GNUC__) || defined(__clang__))
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#elif defined(GERBER_SCANNER_X86_64) && defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 1);
+            const bool osxsave = (info[2] & (1 << 27)) != 0;
+            const bool avx     = (info[2] & (1 << 28)) != 0;
+            if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+                return false;
+            }
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+#else
+            return false;
+#endif
+        }
+    } // namespace
+
+    Scanner::Backend Scanner::detect_backend() {
+        static const Backend detected = []() {
+#ifdef GERBER_SCANNER_X86_64
+            return cpu_supports_avx2() ? Backend::AVX2 : Backend::SSE2;
+#else
+            return Backend::SCALAR;
+#endif
+        }();
+        return detected;
+    }
+
+    Scanner::Backend Scanner::resolve_backend(Backend backend) {
+        const auto best = detect_backend();
+        return (backend == Backend::AUTO || backend > best) ? best : backend;
+    }
+
+    StructuralIndex Scanner::scan(const std::string_view& source, Backend backend) {
+        switch (resolve_backend(backend)) {
+#ifdef GERBER_SCANNER_X86_64
+            case Backend::AVX2:
+                return scan_avx2(source);
+            case Backend::SSE2:
+                return scan_with<scan_block_sse2>(source);
+#endif
+            default:
+                return scan_with<scan_block_scalar>(source);
+        }
+    }
+
+    location_t Scanner::count_delimiters(const std::string_view& source, Backend backend) {
+        switch (resolve_backend(backend)) {
+#ifdef GERBER_SCANNER_X86_64
+            case Backend::AVX2:
+                return count_avx2(source);
+            case Backend::SSE2:
+                return count_with<scan_block_sse2>(source);
+#endif
+            default:
+                return count_with<scan_block_scalar>(source);
+        }
+    }
+
+    location_t Scanner::skip_whitespace(const std::string_view& source, location_t position) {
+        const location_t size = source.size();
+#ifdef GERBER_SCANNER_X86_64
+        // SSE2 is part of x86-64, so unlike block scanning it needs no dispatch.
+        const __m128i space = _mm_set1_epi8(' ');
+        const __m128i lf    = _mm_set1_epi8('\n');
+        const __m128i cr    = _mm_set1_epi8('\r');
+        while (position + 16 <= size) {
+            const __m128i chunk =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(source.data() + position));
+            const __m128i w = _mm_or_si128(
+                _mm_cmpeq_epi8(chunk, space),
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, lf), _mm_cmpeq_epi8(chunk, cr))
+            );
+            const auto run = std::countr_one(static_cast<uint32_t>(_mm_movemask_epi8(w)));
+            position += run;
+            if (run < 16) {
+                return position;
+            }
+        }
+#endif
+        while (position < size && is_whitespace(source[position])) {
+            position++;
+        }
+        return position;
+    }
+} // namespace gerber
@@ -0,0 +1,399 @@
+#include "gerber/svg.hpp"
+#include "gerber/interpreter.hpp"
+#include "gerber/parser.hpp"
+#include "geometry.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fmt/compile.h>
+#include <fmt/format.h>
+#include <numbers>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gerber {
+
+    SvgExporter::SvgExporter(std::ostream& output_, const SvgOptions& options_) :
+        output(output_),
+        options(options_),
+        out(),
+        it(std::back_inserter(out)),
+        defined_apertures(),
+        layer(0),
+        masking(false),
+        path(NONE),
+        path_aperture(-1),
+        path_end{0.0, 0.0},
+        bounds() {
+        out.reserve(flush_threshold + flush_threshold / 4);
+        out.append("<svg xmlns=\"http://www.w3.org/2000/svg\">\n<defs>\n<g id=\"l0\">\n");
+    }
+
+    void SvgExporter::render(
+        const std::string_view& source,
+        std::ostream&           output,
+        const SvgOptions&       options,
+        const ParserOptions&    parser_options
+    ) {
+        Image       image;
+        SvgExporter exporter(output, options);
+        Interpreter interpreter(image, &exporter);
+
+        Parser(parser_options).stream(source, interpreter);
+        interpreter.finish();
+        exporter.finish();
+    }
+
+    std::string SvgExporter::render(
+        const std::string_view& source,
+        const SvgOptions&       options,
+        const ParserOptions&    parser_options
+    ) {
+        std::ostringstream output;
+        render(source, output, options, parser_options);
+        return std::move(output).str();
+    }
+
+    void SvgExporter::on_feature(const Image& image, const Feature& feature) {
+        set_polarity(feature.polarity);
+        // Clear polarity before anything dark was drawn has nothing to erase.
+        if (feature.polarity == Polarity::CLEAR && !masking) {
+            return;
+        }
+        switch (feature.kind) {
+            case Feature::FLASH:
+                flash(image, feature);
+                break;
+            case Feature::DRAW:
+                draw(image, feature);
+                break;
+            case Feature::REGION:
+                region(image, feature);
+                break;
+        }
+        if (out.size() >= flush_threshold) {
+            flush();
+        }
+    }
+
+    void SvgExporter::finish() {
+        close_path();
+        if (masking) {
+            close_mask();
+        }
+        out.append("</g>\n</defs>\n");
+
+        if (!bounds.empty) {
+            // Gerber y axis points up, the image is flipped and so is its viewBox.
+            out.append("<svg viewBox=\"");
+            write_number(bounds.min.x);
+            out.push_back(' ');
+            write_number(-bounds.max.y);
+            out.push_back(' ');
+            write_number(bounds.max.x - bounds.min.x);
+            out.push_back(' ');
+            write_number(bounds.max.y - bounds.min.y);
+            out.append("\" width=\"");
+            write_number(bounds.max.x - bounds.min.x);
+            out.append("mm\" height=\"");
+            write_number(bounds.max.y - bounds.min.y);
+            fmt::format_to(
+                it,
+                FMT_COMPILE("mm\">\n<use href=\"#l{}\" fill=\"{}\" color=\"{}\" "
+                            "transform=\"scale(1,-1)\"/>\n</svg>\n"),
+                layer,
+                options.color,
+                options.color
+            );
+        }
+        out.append("</svg>\n");
+        flush();
+    }
+
+    void SvgExporter::write_number(double value) {
+        char buffer[64];
+        auto end =
+            fmt::format_to_n(buffer, sizeof(buffer), "{:.{}f}", value, options.precision).out;
+        // Shortest form, trailing zeros and zero before decimal point are redundant.
+        if (std::find(buffer, end, '.') != end) {
+            while (end[-1] == '0') {
+                end--;
+            }
+            if (end[-1] == '.') {
+                end--;
+            }
+        }
+        char* begin = buffer;
+        if (end - begin == 2 && begin[0] == '-' && begin[1] == '0') {
+            begin++;
+        }
+        if (end - begin > 2 && begin[0] == '0' && begin[1] == '.') {
+            begin++;
+        } else if (end - begin > 3 && begin[0] == '-' && begin[1] == '0' && begin[2] == '.') {
+            begin[1] = '-';
+            begin++;
+        }
+        out.append(begin, end);
+    }
+
+    void SvgExporter::write_point(const Point& point) {
+        write_number(point.x);
+        out.push_back(' ');
+        write_number(point.y);
+    }
+
+    void SvgExporter::write_arc(const Segment& segment) {
+        const double radius =
+            std::hypot(segment.start.x - segment.center.x, segment.start.y - segment.center.y);
+        const double sweep = geometry::arc_sweep(segment);
+        // SVG arcs are positive angle direction with sweep flag 1, which is counterclockwise
+        // before the image is flipped.
+        const char direction = segment.kind == Segment::ARC_CCW ? '1' : '0';
+
+        const auto write_part = [&](const Point& end, bool large) {
+            out.push_back('A');
+            write_number(radius);
+            out.push_back(' ');
+            write_number(radius);
+            fmt::format_to(it, FMT_COMPILE(" 0 {} {} "), large ? '1' : '0', direction);
+            write_point(end);
+        };
+
+        if (sweep >= 2 * std::numbers::pi) {
+            // Single SVG arc can't be a full circle, split it at the opposite point.
+            const Point opposite{
+                2 * segment.center.x - segment.start.x, 2 * segment.center.y - segment.start.y
+            };
+            write_part(opposite, false);
+            write_part(segment.end, false);
+        } else {
+            write_part(segment.end, sweep > std::numbers::pi);
+        }
+    }
+
+    void SvgExporter::write_segment(const Segment& segment) {
+        if (segment.kind == Segment::LINE) {
+            out.push_back('L');
+            write_point(segment.end);
+        } else {
+            write_arc(segment);
+        }
+    }
+
+    void SvgExporter::write_aperture(const Aperture& aperture) {
+        const double w = aperture.width / 2;
+        const double h = aperture.height / 2;
+
+        const auto write_circle = [this](double radius) {
+            const Segment circle{Segment::ARC_CCW, true, {radius, 0}, {radius, 0}, {0, 0}};
+            out.push_back('M');
+            write_point(circle.start);
+            write_arc(circle);
+            out.push_back('Z');
+        };
+
+        switch (aperture.shape) {
+            case Aperture::CIRCLE:
+                write_circle(w);
+                break;
+            case Aperture::RECTANGLE:
+                out.push_back('M');
+                write_point({-w, -h});
+                out.push_back('H');
+                write_number(w);
+                out.push_back('V');
+                write_number(h);
+                out.push_back('H');
+                write_number(-w);
+                out.push_back('Z');
+                break;
+            case Aperture::OBROUND: {
+                const double r = std::min(w, h);
+                const double c = std::abs(w - h);
+                // Straight sides along the longer axis, caps at its ends.
+                const Point  a = w > h ? Point{-c, -r} : Point{r, -c};
+                const Point  b = w > h ? Point{c, -r} : Point{r, c};
+                const Point  d = w > h ? Point{c, r} : Point{-r, c};
+                const Point  e = w > h ? Point{-c, r} : Point{-r, -c};
+                out.push_back('M');
+                write_point(a);
+                out.push_back('L');
+                write_point(b);
+                write_arc({Segment::ARC_CCW, true, b, d, {(b.x + d.x) / 2, (b.y + d.y) / 2}});
+                out.push_back('L');
+                write_point(e);
+                write_arc({Segment::ARC_CCW, true, e, a, {(e.x + a.x) / 2, (e.y + a.y) / 2}});
+                out.push_back('Z');
+                break;
+            }
+            case Aperture::POLYGON: {
+                const auto count = std::max<int64_t>(3, std::llround(aperture.vertices));
+                for (int64_t i = 0; i < count; i++) {
+                    const double angle = aperture.rotation * std::numbers::pi / 180 +
+                                         2 * std::numbers::pi * i / count;
+                    out.push_back(i == 0 ? 'M' : 'L');
+                    write_point({w * std::cos(angle), w * std::sin(angle)});
+                }
+                out.push_back('Z');
+                break;
+            }
+        }
+        if (aperture.hole > 0) {
+            write_circle(aperture.hole / 2);
+        }
+    }
+
+    void SvgExporter::define_aperture(const Image& image, int32_t aperture) {
+        if (defined_apertures.size() <= static_cast<size_t>(aperture)) {
+            defined_apertures.resize(image.apertures.size(), false);
+        }
+        if (defined_apertures[aperture]) {
+            return;
+        }
+        defined_apertures[aperture] = true;
+        fmt::format_to(
+            it, FMT_COMPILE("<defs><path id=\"a{}\" fill-rule=\"evenodd\" d=\""), aperture
+        );
+        write_aperture(image.apertures[aperture]);
+        out.append("\"/></defs>\n");
+    }
+
+    void SvgExporter::flash(const Image& image, const Feature& feature) {
+        close_path();
+        define_aperture(image, feature.aperture);
+
+        fmt::format_to(it, FMT_COMPILE("<use href=\"#a{}\" x=\""), feature.aperture);
+        write_number(feature.segment.end.x);
+        out.append("\" y=\"");
+        write_number(feature.segment.end.y);
+        out.append("\"/>\n");
+
+        if (feature.polarity == Polarity::DARK) {
+            bounds.include(feature.segment.end, image.apertures[feature.aperture].extent());
+        }
+    }
+
+    void SvgExporter::draw(const Image& image, const Feature& feature) {
+        const auto& aperture = image.apertures[feature.aperture];
+        const auto& segment  = feature.segment;
+
+        if (aperture.shape == Aperture::RECTANGLE && segment.kind == Segment::LINE) {
+            // Rectangle swept along a line is the convex hull of its two placements.
+            close_path();
+            const double       w = aperture.width / 2;
+            const double       h = aperture.height / 2;
+            std::vector<Point> corners;
+            for (const auto& point : {segment.start, segment.end}) {
+                corners.push_back({point.x - w, point.y - h});
+                corners.push_back({point.x + w, point.y - h});
+                corners.push_back({point.x + w, point.y + h});
+                corners.push_back({point.x - w, point.y + h});
+            }
+            const auto hull = geometry::convex_hull(std::move(corners));
+            out.append("<path d=\"");
+            for (size_t i = 0; i < hull.size(); i++) {
+                out.push_back(i == 0 ? 'M' : 'L');
+                write_point(hull[i]);
+            }
+            out.append("Z\"/>\n");
+        } else {
+            // Other apertures are stroked as circles of their width, only circular
+            // apertures are allowed to draw by the specification.
+            if (path != STROKE || path_aperture != feature.aperture) {
+                close_path();
+                out.append("<path fill=\"none\" stroke=\"currentColor\" stroke-linecap=\"round\" "
+                           "stroke-linejoin=\"round\" stroke-width=\"");
+                write_number(aperture.width);
+                out.append("\" d=\"M");
+                write_point(segment.start);
+                path          = STROKE;
+                path_aperture = feature.aperture;
+            } else if (!(path_end == segment.start)) {
+                out.push_back('M');
+                write_point(segment.start);
+            }
+            write_segment(segment);
+            path_end = segment.end;
+        }
+
+        if (feature.polarity == Polarity::DARK) {
+            bounds.include(segment, aperture.extent());
+        }
+    }
+
+    void SvgExporter::region(const Image& image, const Feature& feature) {
+        close_path();
+        out.append("<path d=\"M");
+        write_point(image.contours[feature.contour_begin].start);
+        for (uint32_t i = 0; i < feature.contour_size; i++) {
+            const auto& segment = image.contours[feature.contour_begin + i];
+            write_segment(segment);
+            if (feature.polarity == Polarity::DARK) {
+                bounds.include(segment);
+            }
+        }
+        out.append("Z\"/>\n");
+    }
+
+    void SvgExporter::set_polarity(Polarity::Enum polarity) {
+        if (polarity == Polarity::CLEAR && !masking && !bounds.empty) {
+            // Everything so far is masked by clear features which follow, mask covers
+            // whole content of the group.
+            close_path();
+            fmt::format_to(
+                it,
+                FMT_COMPILE("</g>\n<mask id=\"m{}\" maskUnits=\"userSpaceOnUse\" x=\""),
+                layer
+            );
+            write_number(bounds.min.x);
+            out.append("\" y=\"");
+            write_number(bounds.min.y);
+            out.append("\" width=\"");
+            write_number(bounds.max.x - bounds.min.x);
+            out.append("\" height=\"");
+            write_number(bounds.max.y - bounds.min.y);
+            out.append("\">\n<rect x=\"");
+            write_number(bounds.min.x);
+            out.append("\" y=\"");
+            write_number(bounds.min.y);
+            out.append("\" width=\"");
+            write_number(bounds.max.x - bounds.min.x);
+            out.append("\" height=\"");
+            write_number(bounds.max.y - bounds.min.y);
+            out.append("\" fill=\"white\"/>\n<g fill=\"black\" color=\"black\">\n");
+            masking = true;
+        } else if (polarity == Polarity::DARK && masking) {
+            close_path();
+            close_mask();
+        }
+    }
+
+    void SvgExporter::close_mask() {
+        // Next group starts with the previous one, masked.
+        fmt::format_to(
+            it,
+            FMT_COMPILE("</g>\n</mask>\n<g id=\"l{}\">\n<use href=\"#l{}\" mask=\"url(#m{})\"/>\n"),
+            layer + 1,
+            layer,
+            layer
+        );
+        layer++;
+        masking = false;
+    }
+
+    void SvgExporter::close_path() {
+        if (path != NONE) {
+            out.append("\"/>\n");
+            path          = NONE;
+            path_aperture = -1;
+        }
+    }
+
+    void SvgExporter::flush() {
+        output.write(out.data(), static_cast<std::streamsize>(out.size()));
+        out.clear();
+    }
+} // namespace gerber
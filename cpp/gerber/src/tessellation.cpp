@@ -0,0 +1,180 @@
+#include "gerber/tessellation.hpp"
+#include "gerber/interpreter.hpp"
+#include "geometry.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+#include <stdexcept>
+#include <vector>
+
+namespace gerber {
+
+    namespace {
+        // Vertices computed together by the inner loop, wide enough for AVX-512.
+        constexpr uint32_t lanes = 8;
+
+        /**
+         * Arc reduced to what is needed to generate its vertices.
+         */
+        class ArcPlan {
+          public:
+            Point    start;
+            Point    end;
+            Point    center;
+            // Unit vector from center to start.
+            double   ux;
+            double   uy;
+            // Start radius and its change per chord, end radius may slightly differ.
+            double   radius;
+            double   radius_step;
+            // Signed angle per chord, negative for clockwise arcs.
+            double   angle_step;
+            uint32_t chords;
+        };
+
+        ArcPlan plan_line(const Segment& segment) {
+            return ArcPlan{segment.start, segment.end, segment.center, 0, 0, 0, 0, 0, 1};
+        }
+
+        ArcPlan plan_arc(const Segment& segment, double tolerance, uint32_t max_chords) {
+            if (segment.kind == Segment::LINE) {
+                return plan_line(segment);
+            }
+            const double dx0 = segment.start.x - segment.center.x;
+            const double dy0 = segment.start.y - segment.center.y;
+            const double r0  = std::hypot(dx0, dy0);
+            const double r1 =
+                std::hypot(segment.end.x - segment.center.x, segment.end.y - segment.center.y);
+            const double sweep = geometry::arc_sweep(segment);
+            if (r0 == 0.0 || sweep == 0.0) {
+                return plan_line(segment);
+            }
+
+            // Chord spanning angle a deviates from the arc by r * (1 - cos(a / 2)), chords
+            // are limited to 90 degrees so that coarse tolerances still produce arcs.
+            const double radius    = std::max(r0, r1);
+            double       max_angle = std::numbers::pi / 2;
+            if (tolerance < radius) {
+                max_angle = std::min(max_angle, 2 * std::acos(1 - tolerance / radius));
+            }
+            const double chords_needed = std::ceil(sweep / max_angle);
+            const auto   chords        = static_cast<uint32_t>(
+                std::clamp(chords_needed, 1.0, static_cast<double>(max_chords))
+            );
+
+            const double direction = segment.kind == Segment::ARC_CW ? -1.0 : 1.0;
+            return ArcPlan{
+                segment.start,
+                segment.end,
+                segment.center,
+                dx0 / r0,
+                dy0 / r0,
+                r0,
+                (r1 - r0) / chords,
+                direction * sweep / chords,
+                chords,
+            };
+        }
+
+        /**
+         * Write plan.chords + 1 vertices to output. Instead of evaluating sin and cos
+         * per vertex, a block of lanes consecutive vertices is rotated as a whole,
+         * which keeps the inner loops free of dependencies and vectorizable.
+         */
+        void generate(const ArcPlan& plan, Point* output) {
+            output[0]           = plan.start;
+            output[plan.chords] = plan.end;
+            if (plan.chords == 1) {
+                return;
+            }
+
+            double lane_x[lanes];
+            double lane_y[lanes];
+            for (uint32_t j = 0; j < lanes; j++) {
+                const double c = std::cos(j * plan.angle_step);
+                const double s = std::sin(j * plan.angle_step);
+                lane_x[j]      = plan.ux * c - plan.uy * s;
+                lane_y[j]      = plan.ux * s + plan.uy * c;
+            }
+            const double block_c = std::cos(lanes * plan.angle_step);
+            const double block_s = std::sin(lanes * plan.angle_step);
+
+            // Start and end are written exactly, only vertices in between are generated.
+            for (uint32_t base = 0; base < plan.chords; base += lanes) {
+                double xs[lanes];
+                double ys[lanes];
+                for (uint32_t j = 0; j < lanes; j++) {
+                    const double radius = plan.radius + plan.radius_step * (base + j);
+                    xs[j]               = plan.center.x + lane_x[j] * radius;
+                    ys[j]               = plan.center.y + lane_y[j] * radius;
+                }
+                const uint32_t first = base == 0 ? 1 : 0;
+                const uint32_t count = std::min(lanes, plan.chords - base);
+                for (uint32_t j = first; j < count; j++) {
+                    output[base + j] = Point{xs[j], ys[j]};
+                }
+                for (uint32_t j = 0; j < lanes; j++) {
+                    const double x = lane_x[j] * block_c - lane_y[j] * block_s;
+                    lane_y[j]      = lane_x[j] * block_s + lane_y[j] * block_c;
+                    lane_x[j]      = x;
+                }
+            }
+        }
+    } // namespace
+
+    std::size_t Polylines::size() const {
+        return offsets.size() - 1;
+    }
+
+    void Polylines::clear() {
+        vertices.clear();
+        offsets.assign(1, 0);
+    }
+
+    ArcTessellator::ArcTessellator(double tolerance_) :
+        tolerance(tolerance_) {
+        if (!(tolerance > 0)) {
+            throw std::invalid_argument("Tessellation tolerance must be positive");
+        }
+    }
+
+    double ArcTessellator::getTolerance() const {
+        return tolerance;
+    }
+
+    uint32_t ArcTessellator::chord_count(const Segment& segment) const {
+        return plan_arc(segment, tolerance, max_chords).chords;
+    }
+
+    void ArcTessellator::tessellate(const Segment& segment, Polylines& output) const {
+        const auto plan  = plan_arc(segment, tolerance, max_chords);
+        const auto begin = output.vertices.size();
+        output.vertices.resize(begin + plan.chords + 1);
+        generate(plan, output.vertices.data() + begin);
+        output.offsets.push_back(output.vertices.size());
+    }
+
+    Polylines ArcTessellator::tessellate(const std::vector<Segment>& segments) const {
+        // First pass sizes all polylines, so vertices are allocated once and the
+        // second pass only fills them.
+        std::vector<ArcPlan> plans;
+        plans.reserve(segments.size());
+
+        Polylines output;
+        output.offsets.reserve(segments.size() + 1);
+        std::size_t total = 0;
+        for (const auto& segment : segments) {
+            plans.push_back(plan_arc(segment, tolerance, max_chords));
+            total += plans.back().chords + 1;
+            output.offsets.push_back(total);
+        }
+
+        output.vertices.resize(total);
+        for (size_t i = 0; i < plans.size(); i++) {
+            generate(plans[i], output.vertices.data() + output.offsets[i]);
+        }
+        return output;
+    }
+} // namespace gerber
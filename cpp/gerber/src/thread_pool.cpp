@@ -0,0 +1,67 @@
+#include "gerber/thread_pool.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace gerber {
+    ThreadPool::ThreadPool(std::size_t size) :
+        mutex(),
+        condition(),
+        tasks(),
+        workers(),
+        stopping(false) {
+        if (size == 0) {
+            size = std::max(1u, std::thread::hardware_concurrency());
+        }
+        workers.reserve(size);
+        for (std::size_t i = 0; i < size; i++) {
+            workers.emplace_back([this]() {
+                run();
+            });
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        condition.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    std::size_t ThreadPool::size() const {
+        return workers.size();
+    }
+
+    void ThreadPool::submit(std::function<void()> task) {
+        {
+            std::lock_guard lock(mutex);
+            tasks.push(std::move(task));
+        }
+        condition.notify_one();
+    }
+
+    void ThreadPool::run() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock lock(mutex);
+                condition.wait(lock, [this]() {
+                    return stopping || !tasks.empty();
+                });
+                if (tasks.empty()) {
+                    return;
+                }
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+        }
+    }
+} // namespace gerber
@@ -0,0 +1,650 @@
+#include "gerber/transform.hpp"
+#include "gerber/ast/ast.hpp"
+#include "gerber/ast/visitor.hpp"
+#include "gerber/coordinate_format.hpp"
+#include "gerber/errors.hpp"
+#include "gerber/scanner.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <fmt/format.h>
+#include <memory>
+#include <numbers>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define GERBER_TRANSFORM_X86_64 1
+    #include <immintrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define GERBER_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+    #define GERBER_TARGET_AVX2
+#endif
+
+namespace gerber {
+
+    namespace {
+        constexpr double inch_to_millimeters = 25.4;
+        // Relative tolerance of conformal and axis aligned tests.
+        constexpr double tolerance           = 1e-9;
+        constexpr double degrees_per_radian  = 180 / std::numbers::pi;
+
+        double unit_millimeters(UnitMode::Enum units) {
+            return units == UnitMode::INCHES ? inch_to_millimeters : 1.0;
+        }
+
+        /**
+         * Operation with coordinates decoded into Decoder arrays.
+         */
+        class Move {
+          public:
+            // Index of the output node to replace with the encoded operation.
+            std::size_t     node;
+            Operation::Kind kind;
+            bool            has_offsets;
+            bool            single_quadrant;
+        };
+
+        /**
+         * First pass, resolves modal and incremental coordinates of all operations into
+         * absolute positions in millimeters and rewrites nodes which don't carry
+         * coordinates. Operations are left as placeholders filled by encode().
+         */
+        class Decoder : public Visitor {
+          private:
+            std::vector<std::shared_ptr<Node>>& output;
+            std::shared_ptr<Node>               current;
+            const AffineTransform&              transform;
+            const TransformOptions&             options;
+
+            // Input to output size ratio of apertures.
+            double aperture_scale;
+            bool   header_written;
+
+            std::optional<CoordinateFormat> x_format;
+            std::optional<CoordinateFormat> y_format;
+            double                          unit_scale;
+            bool                            format_incremental;
+            bool                            code_incremental;
+            bool                            multi_quadrant;
+            Point                           current_point;
+            std::optional<double>           pending_x;
+            std::optional<double>           pending_y;
+            std::optional<double>           pending_i;
+            std::optional<double>           pending_j;
+
+          public:
+            std::vector<Move>   moves;
+            std::vector<double> x;
+            std::vector<double> y;
+            std::vector<double> i;
+            std::vector<double> j;
+
+            Decoder(
+                std::vector<std::shared_ptr<Node>>& output_,
+                const AffineTransform&              transform_,
+                const TransformOptions&             options_
+            ) :
+                output(output_),
+                current(),
+                transform(transform_),
+                options(options_),
+                aperture_scale(transform_.scale_factor() / unit_millimeters(options_.units)),
+                header_written(false),
+                x_format(std::nullopt),
+                y_format(std::nullopt),
+                unit_scale(1.0),
+                format_incremental(false),
+                code_incremental(false),
+                multi_quadrant(true),
+                current_point{0.0, 0.0},
+                pending_x(std::nullopt),
+                pending_y(std::nullopt),
+                pending_i(std::nullopt),
+                pending_j(std::nullopt),
+                moves(),
+                x(),
+                y(),
+                i(),
+                j() {}
+
+            void on_file(const File& file) override {
+                for (const auto& node : file.getNodes()) {
+                    current = node;
+                    node->visit(*this);
+                }
+            }
+
+            void on_node(const Node&) override {
+                output.push_back(current);
+            }
+
+            // Aperture
+
+            double size(double value) const {
+                return value * unit_scale * aperture_scale;
+            }
+
+            std::optional<double> size(const std::optional<double>& value) const {
+                if (!value.has_value()) {
+                    return std::nullopt;
+                }
+                return size(*value);
+            }
+
+            /**
+             * Whether sides of rectangular aperture are swapped, throws when the
+             * rotation can't be represented.
+             */
+            bool swaps_sides(const AD& node) const {
+                if (!transform.axis_aligned()) {
+                    throw std::invalid_argument(fmt::format(
+                        "Aperture D{} can only be rotated by multiples of 90 degrees",
+                        node.getApertureIdView()
+                    ));
+                }
+                return std::abs(transform.xx) < std::abs(transform.yx);
+            }
+
+            void on_adc(const ADC& node) override {
+                output.push_back(std::make_shared<ADC>(
+                    node.getApertureIdView(),
+                    size(node.getDiameter()),
+                    size(node.getHoleDiameter())
+                ));
+            }
+
+            void on_ado(const ADO& node) override {
+                const bool swap = swaps_sides(node);
+                output.push_back(std::make_shared<ADO>(
+                    node.getApertureIdView(),
+                    size(swap ? node.getHeight() : node.getWidth()),
+                    size(swap ? node.getWidth() : node.getHeight()),
+                    size(node.getHoleDiameter())
+                ));
+            }
+
+            void on_adp(const ADP& node) override {
+                // Rotation is the angle of the first vertex, transform its direction.
+                const double angle     = node.getRotation().value_or(0.0) / degrees_per_radian;
+                const Point  direction = {
+                    transform.xx * std::cos(angle) + transform.xy * std::sin(angle),
+                    transform.yx * std::cos(angle) + transform.yy * std::sin(angle),
+                };
+                const double degrees  = std::atan2(direction.y, direction.x) * degrees_per_radian;
+                // Drop rounding noise, so that eg. 45 degrees stay 45.
+                double       rotation = std::round(degrees * 1e6) / 1e6;
+                if (rotation < 0) {
+                    rotation += 360;
+                }
+
+                output.push_back(std::make_shared<ADP>(
+                    node.getApertureIdView(),
+                    size(node.getOuterDiameter()),
+                    node.getVerticesCount(),
+                    node.getRotation().has_value() || rotation != 0
+                        ? std::optional<double>(rotation)
+                        : std::nullopt,
+                    size(node.getHoleDiameter())
+                ));
+            }
+
+            void on_adr(const ADR& node) override {
+                const bool swap = swaps_sides(node);
+                output.push_back(std::make_shared<ADR>(
+                    node.getApertureIdView(),
+                    size(swap ? node.getHeight() : node.getWidth()),
+                    size(swap ? node.getWidth() : node.getHeight()),
+                    size(node.getHoleDiameter())
+                ));
+            }
+
+            // D codes
+
+            void add_move(Operation::Kind kind) {
+                const bool incremental = format_incremental || code_incremental;
+                Point      target      = current_point;
+                if (pending_x.has_value()) {
+                    target.x = incremental ? current_point.x + *pending_x : *pending_x;
+                }
+                if (pending_y.has_value()) {
+                    target.y = incremental ? current_point.y + *pending_y : *pending_y;
+                }
+                const bool has_offsets = pending_i.has_value() || pending_j.has_value();
+                if (has_offsets && !multi_quadrant && !transform.axis_aligned()) {
+                    throw std::invalid_argument(
+                        "Single quadrant arcs can only be rotated by multiples of 90 degrees"
+                    );
+                }
+
+                moves.push_back(Move{output.size(), kind, has_offsets, !multi_quadrant});
+                x.push_back(target.x);
+                y.push_back(target.y);
+                i.push_back(pending_i.value_or(0.0));
+                j.push_back(pending_j.value_or(0.0));
+                output.push_back(nullptr);
+
+                current_point = target;
+                pending_x     = std::nullopt;
+                pending_y     = std::nullopt;
+                pending_i     = std::nullopt;
+                pending_j     = std::nullopt;
+            }
+
+            void on_d01(const D01&) override {
+                add_move(Operation::INTERPOLATE);
+            }
+
+            void on_d02(const D02&) override {
+                add_move(Operation::MOVE);
+            }
+
+            void on_d03(const D03&) override {
+                add_move(Operation::FLASH);
+            }
+
+            void on_operation(const Operation& node) override {
+                set_pending(pending_x, x_format, node.getXView());
+                set_pending(pending_y, y_format, node.getYView());
+                set_pending(pending_i, x_format, node.getIView());
+                set_pending(pending_j, y_format, node.getJView());
+                add_move(node.getKind());
+            }
+
+            // G codes
+
+            void on_g02(const G02&) override {
+                if (transform.mirrors()) {
+                    output.push_back(std::make_shared<G03>());
+                } else {
+                    output.push_back(current);
+                }
+            }
+
+            void on_g03(const G03&) override {
+                if (transform.mirrors()) {
+                    output.push_back(std::make_shared<G02>());
+                } else {
+                    output.push_back(current);
+                }
+            }
+
+            void on_g70(const G70&) override {
+                unit_scale = inch_to_millimeters;
+                write_header();
+            }
+
+            void on_g71(const G71&) override {
+                unit_scale = 1.0;
+                write_header();
+            }
+
+            void on_g74(const G74&) override {
+                multi_quadrant = false;
+                output.push_back(current);
+            }
+
+            void on_g75(const G75&) override {
+                multi_quadrant = true;
+                output.push_back(current);
+            }
+
+            void on_g90(const G90&) override {
+                code_incremental = false;
+            }
+
+            void on_g91(const G91&) override {
+                code_incremental = true;
+            }
+
+            // Other
+
+            void set_pending(
+                std::optional<double>&                 pending,
+                const std::optional<CoordinateFormat>& format,
+                const std::optional<std::string_view>& value
+            ) {
+                if (!value.has_value()) {
+                    return;
+                }
+                if (!format.has_value()) {
+                    throw InterpreterError("Coordinate data used before FS command");
+                }
+                try {
+                    pending = format->toDouble(*value) * unit_scale;
+                } catch (const std::invalid_argument&) {
+                    throw InterpreterError(fmt::format("Invalid coordinate data '{}'", *value));
+                }
+            }
+
+            void on_coordinate_i(const CoordinateI& node) override {
+                set_pending(pending_i, x_format, node.getValueView());
+            }
+
+            void on_coordinate_j(const CoordinateJ& node) override {
+                set_pending(pending_j, y_format, node.getValueView());
+            }
+
+            void on_coordinate_x(const CoordinateX& node) override {
+                set_pending(pending_x, x_format, node.getValueView());
+            }
+
+            void on_coordinate_y(const CoordinateY& node) override {
+                set_pending(pending_y, y_format, node.getValueView());
+            }
+
+            // Properties
+
+            /**
+             * Output FS and MO in place of the first command setting format or units,
+             * later ones are dropped.
+             */
+            void write_header() {
+                if (header_written) {
+                    return;
+                }
+                header_written = true;
+                output.push_back(std::make_shared<FS>(
+                    "L", "A", options.integral, options.decimal, options.integral, options.decimal
+                ));
+                output.push_back(std::make_shared<MO>(UnitMode(options.units).toString()));
+            }
+
+            void on_fs(const FS& node) override {
+                x_format           = CoordinateFormat::x(node);
+                y_format           = CoordinateFormat::y(node);
+                format_incremental = node.coordinate_mode == CoordinateNotation::INCREMENTAL;
+                write_header();
+            }
+
+            void on_mo(const MO& node) override {
+                unit_scale = unit_millimeters(node.unit_mode.value);
+                write_header();
+            }
+        };
+
+        Text number_text(int64_t value) {
+            const fmt::format_int text(value);
+            return Text(std::string_view(text.data(), text.size()));
+        }
+
+        /**
+         * Last pass, writes transformed operations into their placeholders. Coordinates
+         * equal to the previous ones are omitted, except in the first operation.
+         */
+        void encode(
+            const Decoder&                      decoder,
+            const std::vector<int64_t>&         x,
+            const std::vector<int64_t>&         y,
+            const std::vector<int64_t>&         i,
+            const std::vector<int64_t>&         j,
+            std::vector<std::shared_ptr<Node>>& output
+        ) {
+            // Nodes point into one array instead of allocating each operation.
+            const auto operations = std::make_shared<std::vector<Operation>>();
+            operations->reserve(decoder.moves.size());
+            for (std::size_t index = 0; index < decoder.moves.size(); index++) {
+                const auto& move  = decoder.moves[index];
+                const bool  first = index == 0;
+
+                std::optional<Text> x_text;
+                std::optional<Text> y_text;
+                std::optional<Text> i_text;
+                std::optional<Text> j_text;
+                if (first || x[index] != x[index - 1]) {
+                    x_text = number_text(x[index]);
+                }
+                if (first || y[index] != y[index - 1]) {
+                    y_text = number_text(y[index]);
+                }
+                if (move.has_offsets) {
+                    // Single quadrant offsets are unsigned, axis aligned transform only
+                    // changes their order.
+                    i_text = number_text(move.single_quadrant ? std::abs(i[index]) : i[index]);
+                    j_text = number_text(move.single_quadrant ? std::abs(j[index]) : j[index]);
+                }
+                operations->emplace_back(
+                    move.kind,
+                    std::move(x_text),
+                    std::move(y_text),
+                    std::move(i_text),
+                    std::move(j_text)
+                );
+                output[move.node] = std::shared_ptr<Node>(operations, &operations->back());
+            }
+        }
+
+        /**
+         * Transform points from index begin on, offset is zero for vectors. Sums are
+         * evaluated in the same order by all kernels, so they give identical results.
+         */
+        void apply_scalar(
+            const AffineTransform& transform,
+            double                 dx,
+            double                 dy,
+            double* __restrict     px,
+            double* __restrict     py,
+            std::size_t            begin,
+            std::size_t            count
+        ) {
+            for (std::size_t index = begin; index < count; index++) {
+                const double source_x = px[index];
+                const double source_y = py[index];
+                px[index]             = transform.xx * source_x + transform.xy * source_y + dx;
+                py[index]             = transform.yx * source_x + transform.yy * source_y + dy;
+            }
+        }
+
+#ifdef GERBER_TRANSFORM_X86_64
+        // SSE2 is part of x86-64, so it needs no dispatch.
+        void apply_sse2(
+            const AffineTransform& transform,
+            double                 dx,
+            double                 dy,
+            double*                px,
+            double*                py,
+            std::size_t            count
+        ) {
+            const __m128d xx       = _mm_set1_pd(transform.xx);
+            const __m128d xy       = _mm_set1_pd(transform.xy);
+            const __m128d yx       = _mm_set1_pd(transform.yx);
+            const __m128d yy       = _mm_set1_pd(transform.yy);
+            const __m128d offset_x = _mm_set1_pd(dx);
+            const __m128d offset_y = _mm_set1_pd(dy);
+
+            std::size_t index = 0;
+            for (; index + 2 <= count; index += 2) {
+                const __m128d x = _mm_loadu_pd(px + index);
+                const __m128d y = _mm_loadu_pd(py + index);
+                _mm_storeu_pd(
+                    px + index,
+                    _mm_add_pd(_mm_add_pd(_mm_mul_pd(xx, x), _mm_mul_pd(xy, y)), offset_x)
+                );
+                _mm_storeu_pd(
+                    py + index,
+                    _mm_add_pd(_mm_add_pd(_mm_mul_pd(yx, x), _mm_mul_pd(yy, y)), offset_y)
+                );
+            }
+            apply_scalar(transform, dx, dy, px, py, index, count);
+        }
+
+        GERBER_TARGET_AVX2 void apply_avx2(
+            const AffineTransform& transform,
+            double                 dx,
+            double                 dy,
+            double*                px,
+            double*                py,
+            std::size_t            count
+        ) {
+            const __m256d xx       = _mm256_set1_pd(transform.xx);
+            const __m256d xy       = _mm256_set1_pd(transform.xy);
+            const __m256d yx       = _mm256_set1_pd(transform.yx);
+            const __m256d yy       = _mm256_set1_pd(transform.yy);
+            const __m256d offset_x = _mm256_set1_pd(dx);
+            const __m256d offset_y = _mm256_set1_pd(dy);
+
+            std::size_t index = 0;
+            for (; index + 4 <= count; index += 4) {
+                const __m256d x = _mm256_loadu_pd(px + index);
+                const __m256d y = _mm256_loadu_pd(py + index);
+                _mm256_storeu_pd(
+                    px + index,
+                    _mm256_add_pd(
+                        _mm256_add_pd(_mm256_mul_pd(xx, x), _mm256_mul_pd(xy, y)), offset_x
+                    )
+                );
+                _mm256_storeu_pd(
+                    py + index,
+                    _mm256_add_pd(
+                        _mm256_add_pd(_mm256_mul_pd(yx, x), _mm256_mul_pd(yy, y)), offset_y
+                    )
+                );
+            }
+            apply_scalar(transform, dx, dy, px, py, index, count);
+        }
+#endif
+
+        void apply_arrays(
+            const AffineTransform& transform,
+            double                 dx,
+            double                 dy,
+            std::vector<double>&   x,
+            std::vector<double>&   y
+        ) {
+            const std::size_t count = std::min(x.size(), y.size());
+#ifdef GERBER_TRANSFORM_X86_64
+            if (Scanner::detect_backend() == Scanner::AVX2) {
+                apply_avx2(transform, dx, dy, x.data(), y.data(), count);
+            } else {
+                apply_sse2(transform, dx, dy, x.data(), y.data(), count);
+            }
+#else
+            apply_scalar(transform, dx, dy, x.data(), y.data(), 0, count);
+#endif
+        }
+
+        std::vector<int64_t> round_all(const std::vector<double>& values) {
+            std::vector<int64_t> result(values.size());
+            for (std::size_t index = 0; index < values.size(); index++) {
+                result[index] = std::llround(values[index]);
+            }
+            return result;
+        }
+    } // namespace
+
+    AffineTransform AffineTransform::translate(double dx, double dy) {
+        return AffineTransform{1.0, 0.0, 0.0, 1.0, dx, dy};
+    }
+
+    AffineTransform AffineTransform::rotate(double degrees) {
+        // Exact values for multiples of 90 degrees keep axis aligned transforms exact.
+        const double turns = degrees / 90;
+        if (turns == std::round(turns)) {
+            static constexpr double cosines[] = {1.0, 0.0, -1.0, 0.0};
+            const auto              quarter   = ((static_cast<int64_t>(turns) % 4) + 4) % 4;
+            const double            cos       = cosines[quarter];
+            const double            sin       = cosines[(quarter + 3) % 4];
+            return AffineTransform{cos, -sin, sin, cos, 0.0, 0.0};
+        }
+        const double radians = degrees / degrees_per_radian;
+        const double cos     = std::cos(radians);
+        const double sin     = std::sin(radians);
+        return AffineTransform{cos, -sin, sin, cos, 0.0, 0.0};
+    }
+
+    AffineTransform AffineTransform::scale(double factor) {
+        return AffineTransform{factor, 0.0, 0.0, factor, 0.0, 0.0};
+    }
+
+    AffineTransform AffineTransform::mirror_x() {
+        return AffineTransform{-1.0, 0.0, 0.0, 1.0, 0.0, 0.0};
+    }
+
+    AffineTransform AffineTransform::mirror_y() {
+        return AffineTransform{1.0, 0.0, 0.0, -1.0, 0.0, 0.0};
+    }
+
+    AffineTransform AffineTransform::then(const AffineTransform& other) const {
+        return AffineTransform{
+            other.xx * xx + other.xy * yx,
+            other.xx * xy + other.xy * yy,
+            other.yx * xx + other.yy * yx,
+            other.yx * xy + other.yy * yy,
+            other.xx * dx + other.xy * dy + other.dx,
+            other.yx * dx + other.yy * dy + other.dy,
+        };
+    }
+
+    Point AffineTransform::apply(const Point& point) const {
+        return Point{xx * point.x + xy * point.y + dx, yx * point.x + yy * point.y + dy};
+    }
+
+    void AffineTransform::apply(std::vector<double>& x, std::vector<double>& y) const {
+        apply_arrays(*this, dx, dy, x, y);
+    }
+
+    void AffineTransform::apply_linear(std::vector<double>& x, std::vector<double>& y) const {
+        apply_arrays(*this, 0.0, 0.0, x, y);
+    }
+
+    double AffineTransform::scale_factor() const {
+        return std::hypot(xx, yx);
+    }
+
+    bool AffineTransform::mirrors() const {
+        return xx * yy - xy * yx < 0;
+    }
+
+    bool AffineTransform::conformal() const {
+        const double scale = scale_factor();
+        if (!(scale > 0)) {
+            return false;
+        }
+        // Columns are orthogonal and of the same length.
+        return std::abs(xx * xy + yx * yy) <= tolerance * scale * scale &&
+               std::abs(std::hypot(xy, yy) - scale) <= tolerance * scale;
+    }
+
+    bool AffineTransform::axis_aligned() const {
+        const double limit = tolerance * scale_factor();
+        return (std::abs(xy) <= limit && std::abs(yx) <= limit) ||
+               (std::abs(xx) <= limit && std::abs(yy) <= limit);
+    }
+
+    File Transformer::transform(
+        const File& file, const AffineTransform& transform, const TransformOptions& options
+    ) {
+        if (!transform.conformal()) {
+            throw std::invalid_argument("Transform has to keep angles to keep arcs circular");
+        }
+
+        std::vector<std::shared_ptr<Node>> output;
+        output.reserve(file.getNodes().size());
+        Decoder decoder(output, transform, options);
+        file.visit(decoder);
+
+        // Convert millimeters to integer count of output units in the same pass.
+        const auto to_output =
+            transform.then(AffineTransform::scale(
+                std::pow(10.0, options.decimal) / unit_millimeters(options.units)
+            ));
+        to_output.apply(decoder.x, decoder.y);
+        to_output.apply_linear(decoder.i, decoder.j);
+
+        encode(
+            decoder,
+            round_all(decoder.x),
+            round_all(decoder.y),
+            round_all(decoder.i),
+            round_all(decoder.j),
+            output
+        );
+        return File(std::move(output), file.getSource());
+    }
+} // namespace gerber
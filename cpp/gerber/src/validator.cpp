@@ -0,0 +1,222 @@
+#include "gerber/validator.hpp"
+#include "gerber/ast/ast.hpp"
+#include "gerber/ast/visitor.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <fmt/format.h>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace gerber {
+
+    namespace {
+        /**
+         * Set of aperture numbers. Numbers below Validator::dense_apertures are bits,
+         * the rest is kept by text, which parser stores without leading zeros.
+         */
+        class ApertureSet {
+          private:
+            std::vector<uint64_t>                bits;
+            std::unordered_set<std::string_view> sparse;
+
+            static bool dense_index(const std::string_view& id, uint32_t& index) {
+                if (id.empty() || (id[0] == '0' && id.size() > 1)) {
+                    return false;
+                }
+                const auto result = std::from_chars(id.data(), id.data() + id.size(), index);
+                return result.ec == std::errc() && result.ptr == id.data() + id.size() &&
+                       index < Validator::dense_apertures;
+            }
+
+          public:
+            ApertureSet() :
+                bits(Validator::dense_apertures / 64),
+                sparse() {}
+
+            bool contains(const std::string_view& id) const {
+                uint32_t index = 0;
+                if (dense_index(id, index)) {
+                    return (bits[index / 64] >> (index % 64)) & 1;
+                }
+                return sparse.contains(id);
+            }
+
+            /**
+             * Add number, returns false when it was already present.
+             */
+            bool insert(const std::string_view& id) {
+                uint32_t index = 0;
+                if (dense_index(id, index)) {
+                    const uint64_t mask  = uint64_t{1} << (index % 64);
+                    const bool     fresh = (bits[index / 64] & mask) == 0;
+                    bits[index / 64] |= mask;
+                    return fresh;
+                }
+                return sparse.insert(id).second;
+            }
+        };
+
+        class ValidatingVisitor : public Visitor {
+          private:
+            const File&              file;
+            std::vector<Diagnostic>& diagnostics;
+            ApertureSet              apertures;
+            bool                     has_format;
+            bool                     has_units;
+            bool                     coordinates_seen;
+            // Index of the G36 opening current region.
+            std::optional<size_t>    region;
+
+            void report(Diagnostic::Code code, std::size_t node, std::string&& message) {
+                std::optional<Span> span;
+                if (node < file.getSpans().size()) {
+                    span = file.getSpans()[node];
+                }
+                diagnostics.push_back(Diagnostic{code, node, span, std::move(message)});
+            }
+
+            void on_coordinate_data() {
+                if (coordinates_seen) {
+                    return;
+                }
+                // Reported only for the first coordinate, all later ones would repeat it.
+                coordinates_seen = true;
+                if (!has_format) {
+                    report(
+                        Diagnostic::MISSING_FORMAT, index, "Coordinate data used before FS command"
+                    );
+                }
+                if (!has_units) {
+                    report(
+                        Diagnostic::MISSING_UNITS, index, "Coordinate data used before MO command"
+                    );
+                }
+            }
+
+          public:
+            std::size_t index;
+
+            ValidatingVisitor(const File& file_, std::vector<Diagnostic>& diagnostics_) :
+                file(file_),
+                diagnostics(diagnostics_),
+                apertures(),
+                has_format(false),
+                has_units(false),
+                coordinates_seen(false),
+                region(),
+                index(0) {}
+
+            void on_ad(const AD& node) override {
+                if (!apertures.insert(node.getApertureIdView())) {
+                    report(
+                        Diagnostic::REDEFINED_APERTURE,
+                        index,
+                        fmt::format("Aperture D{} is already defined", node.getApertureIdView())
+                    );
+                }
+            }
+
+            void on_dnn(const Dnn& node) override {
+                if (!apertures.contains(node.getApertureIdView())) {
+                    report(
+                        Diagnostic::UNDEFINED_APERTURE,
+                        index,
+                        fmt::format("Aperture D{} is not defined", node.getApertureIdView())
+                    );
+                }
+            }
+
+            void on_operation(const Operation& node) override {
+                if (node.getXView() || node.getYView() || node.getIView() || node.getJView()) {
+                    on_coordinate_data();
+                }
+            }
+
+            void on_coordinate(const Coordinate&) override {
+                on_coordinate_data();
+            }
+
+            void on_g36(const G36&) override {
+                if (region.has_value()) {
+                    report(
+                        Diagnostic::UNCLOSED_REGION,
+                        *region,
+                        "G36 region is not closed before next G36"
+                    );
+                }
+                region = index;
+            }
+
+            void on_g37(const G37&) override {
+                if (!region.has_value()) {
+                    report(Diagnostic::UNOPENED_REGION, index, "G37 used outside of region");
+                }
+                region.reset();
+            }
+
+            void on_fs(const FS&) override {
+                has_format = true;
+            }
+
+            void on_mo(const MO&) override {
+                has_units = true;
+            }
+
+            void finish() {
+                const auto& nodes = file.getNodes();
+                if (region.has_value()) {
+                    report(Diagnostic::UNCLOSED_REGION, *region, "G36 region is not closed by G37");
+                }
+                if (nodes.empty() || dynamic_cast<const M02*>(nodes.back().get()) == nullptr) {
+                    report(Diagnostic::MISSING_END, nodes.size(), "File doesn't end with M02");
+                }
+            }
+        };
+    } // namespace
+
+    std::string_view Diagnostic::code_name(Code code) {
+        switch (code) {
+            case UNDEFINED_APERTURE:
+                return "undefined_aperture";
+            case REDEFINED_APERTURE:
+                return "redefined_aperture";
+            case MISSING_FORMAT:
+                return "missing_format";
+            case MISSING_UNITS:
+                return "missing_units";
+            case UNCLOSED_REGION:
+                return "unclosed_region";
+            case UNOPENED_REGION:
+                return "unopened_region";
+            case MISSING_END:
+                return "missing_end";
+            default:
+                return "unknown";
+        }
+    }
+
+    std::vector<Diagnostic> Validator::validate(const File& file) {
+        std::vector<Diagnostic> diagnostics;
+        ValidatingVisitor       visitor(file, diagnostics);
+
+        const auto& nodes = file.getNodes();
+        for (visitor.index = 0; visitor.index < nodes.size(); visitor.index++) {
+            nodes[visitor.index]->visit(visitor);
+        }
+        visitor.finish();
+
+        // Unclosed regions are reported at their G36, after later nodes.
+        std::stable_sort(
+            diagnostics.begin(),
+            diagnostics.end(),
+            [](const Diagnostic& left, const Diagnostic& right) { return left.node < right.node; }
+        );
+        return diagnostics;
+    }
+} // namespace gerber
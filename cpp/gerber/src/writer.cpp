@@ -0,0 +1,272 @@
+#include "gerber/writer.hpp"
+#include "gerber/ast/ast.hpp"
+#include "gerber/ast/visitor.hpp"
+#include "decimal.hpp"
+#include <fmt/compile.h>
+#include <fmt/format.h>
+#include <iterator>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace gerber {
+
+    namespace {
+        // Average length of a serialized node, used to pre-size output buffer.
+        constexpr size_t average_node_length = 10;
+
+        class WriterVisitor : public Visitor {
+          private:
+            std::string&                           out;
+            std::back_insert_iterator<std::string> it;
+            std::ostream*                          stream;
+
+          public:
+            WriterVisitor(std::string& out_, std::ostream* stream_) :
+                out(out_),
+                it(std::back_inserter(out_)),
+                stream(stream_) {}
+
+            void on_file(const File& node) override {
+                for (const auto& child : node.getNodes()) {
+                    child->visit(*this);
+
+                    if (stream != nullptr && out.size() >= Writer::flush_threshold) {
+                        flush();
+                    }
+                }
+            }
+
+            void flush() {
+                stream->write(out.data(), static_cast<std::streamsize>(out.size()));
+                out.clear();
+            }
+
+            void write_number(char prefix, double value) {
+                out.push_back(prefix);
+                format_decimal(it, value);
+            }
+
+            void write_optional(char prefix, const std::optional<double>& value) {
+                if (value.has_value()) {
+                    write_number(prefix, value.value());
+                }
+            }
+
+            // Aperture
+
+            void on_adc(const ADC& node) override {
+                fmt::format_to(it, FMT_COMPILE("%ADD{}C"), node.getApertureIdView());
+                write_number(',', node.getDiameter());
+                write_optional('X', node.getHoleDiameter());
+                out.append("*%\n");
+            }
+
+            void on_adr(const ADR& node) override {
+                fmt::format_to(it, FMT_COMPILE("%ADD{}R"), node.getApertureIdView());
+                write_number(',', node.getWidth());
+                write_number('X', node.getHeight());
+                write_optional('X', node.getHoleDiameter());
+                out.append("*%\n");
+            }
+
+            void on_ado(const ADO& node) override {
+                fmt::format_to(it, FMT_COMPILE("%ADD{}O"), node.getApertureIdView());
+                write_number(',', node.getWidth());
+                write_number('X', node.getHeight());
+                write_optional('X', node.getHoleDiameter());
+                out.append("*%\n");
+            }
+
+            void on_adp(const ADP& node) override {
+                fmt::format_to(it, FMT_COMPILE("%ADD{}P"), node.getApertureIdView());
+                write_number(',', node.getOuterDiameter());
+                write_number('X', node.getVerticesCount());
+                const auto holeDiameter = node.getHoleDiameter();
+                // Hole diameter is positional, rotation has to be present when it is.
+                if (holeDiameter.has_value()) {
+                    write_number('X', node.getRotation().value_or(0.0));
+                    write_number('X', *holeDiameter);
+                } else {
+                    write_optional('X', node.getRotation());
+                }
+                out.append("*%\n");
+            }
+
+            void on_am(const AM& node) override {
+                fmt::format_to(it, FMT_COMPILE("%AM{}*"), node.getAmOpen()->getApertureId());
+                out.append("%\n");
+            }
+
+            // D codes
+
+            void on_d01(const D01&) override {
+                out.append("D01*\n");
+            }
+
+            void on_d02(const D02&) override {
+                out.append("D02*\n");
+            }
+
+            void on_d03(const D03&) override {
+                out.append("D03*\n");
+            }
+
+            void on_dnn(const Dnn& node) override {
+                fmt::format_to(it, FMT_COMPILE("D{}*\n"), node.getApertureIdView());
+            }
+
+            void write_coordinate(char prefix, const std::optional<std::string_view>& value) {
+                if (value.has_value()) {
+                    fmt::format_to(it, FMT_COMPILE("{}{}"), prefix, *value);
+                }
+            }
+
+            void on_operation(const Operation& node) override {
+                write_coordinate('X', node.getXView());
+                write_coordinate('Y', node.getYView());
+                write_coordinate('I', node.getIView());
+                write_coordinate('J', node.getJView());
+
+                switch (node.getKind()) {
+                    case Operation::INTERPOLATE:
+                        out.append("D01*\n");
+                        break;
+                    case Operation::MOVE:
+                        out.append("D02*\n");
+                        break;
+                    case Operation::FLASH:
+                        out.append("D03*\n");
+                        break;
+                }
+            }
+
+            // G codes
+
+            void on_g01(const G01&) override {
+                out.append("G01*\n");
+            }
+
+            void on_g02(const G02&) override {
+                out.append("G02*\n");
+            }
+
+            void on_g03(const G03&) override {
+                out.append("G03*\n");
+            }
+
+            void on_g04(const G04& node) override {
+                fmt::format_to(it, FMT_COMPILE("G04{}*\n"), node.getCommentView());
+            }
+
+            void on_g36(const G36&) override {
+                out.append("G36*\n");
+            }
+
+            void on_g37(const G37&) override {
+                out.append("G37*\n");
+            }
+
+            void on_g54(const G54&) override {
+                out.append("G54*\n");
+            }
+
+            void on_g55(const G55&) override {
+                out.append("G55*\n");
+            }
+
+            void on_g70(const G70&) override {
+                out.append("G70*\n");
+            }
+
+            void on_g71(const G71&) override {
+                out.append("G71*\n");
+            }
+
+            void on_g74(const G74&) override {
+                out.append("G74*\n");
+            }
+
+            void on_g75(const G75&) override {
+                out.append("G75*\n");
+            }
+
+            void on_g90(const G90&) override {
+                out.append("G90*\n");
+            }
+
+            void on_g91(const G91&) override {
+                out.append("G91*\n");
+            }
+
+            // Load
+
+            void on_lp(const LP& node) override {
+                out.append(node.polarity == Polarity::DARK ? "%LPD*%\n" : "%LPC*%\n");
+            }
+
+            // M codes
+
+            void on_m02(const M02&) override {
+                out.append("M02*\n");
+            }
+
+            // Other
+
+            void on_coordinate_x(const CoordinateX& node) override {
+                fmt::format_to(it, FMT_COMPILE("X{}"), node.getValueView());
+            }
+
+            void on_coordinate_y(const CoordinateY& node) override {
+                fmt::format_to(it, FMT_COMPILE("Y{}"), node.getValueView());
+            }
+
+            void on_coordinate_i(const CoordinateI& node) override {
+                fmt::format_to(it, FMT_COMPILE("I{}"), node.getValueView());
+            }
+
+            void on_coordinate_j(const CoordinateJ& node) override {
+                fmt::format_to(it, FMT_COMPILE("J{}"), node.getValueView());
+            }
+
+            // Properties
+
+            void on_fs(const FS& node) override {
+                fmt::format_to(
+                    it,
+                    FMT_COMPILE("%FS{}{}X{}{}Y{}{}*%\n"),
+                    node.zeros == Zeros::SKIP_LEADING ? 'L' : 'T',
+                    node.coordinate_mode == CoordinateNotation::ABSOLUTE ? 'A' : 'I',
+                    node.x_integral,
+                    node.x_decimal,
+                    node.y_integral,
+                    node.y_decimal
+                );
+            }
+
+            void on_mo(const MO& node) override {
+                out.append(node.unit_mode == UnitMode::INCHES ? "%MOIN*%\n" : "%MOMM*%\n");
+            }
+        };
+    } // namespace
+
+    std::string Writer::write(const File& file) const {
+        std::string out;
+        out.reserve(file.getNodes().size() * average_node_length);
+
+        WriterVisitor visitor(out, nullptr);
+        file.visit(visitor);
+
+        return out;
+    }
+
+    void Writer::write(const File& file, std::ostream& output) const {
+        std::string out;
+        out.reserve(flush_threshold + flush_threshold / 4);
+
+        WriterVisitor visitor(out, &output);
+        file.visit(visitor);
+        visitor.flush();
+    }
+} // namespace gerber
@@ -1,6 +1,21 @@
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "gerber/gerber.hpp"
+#include <pybind11/gil_safe_call_once.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/pytypes.h>
 #include <pybind11/stl.h>
@@ -9,15 +24,572 @@ namespace py = pybind11;
 
 namespace gbr = gerber;
 
+namespace {
+    // Worker pool of parse_async(), created on first use.
+    std::mutex                       async_pool_mutex;
+    std::unique_ptr<gbr::ThreadPool> async_pool;
+    std::size_t                      async_pool_size = 0;
+
+    /**
+     * Python objects of a pending parse_async() call, only touched with GIL held.
+     */
+    class AsyncParse {
+      public:
+        py::object loop;
+        py::object future;
+        py::object syntax_error_type;
+    };
+
+    void submit_async(std::function<void()> task) {
+        std::lock_guard lock(async_pool_mutex);
+        if (!async_pool) {
+            async_pool = std::make_unique<gbr::ThreadPool>(async_pool_size);
+        }
+        async_pool->submit(std::move(task));
+    }
+
+    /**
+     * Destroy current pool, waiting for queued parses. Their results are delivered
+     * with GIL, so it has to be released while waiting.
+     */
+    void reset_async_pool(std::optional<std::size_t> size) {
+        std::unique_ptr<gbr::ThreadPool> old_pool;
+        {
+            std::lock_guard lock(async_pool_mutex);
+            if (size.has_value()) {
+                async_pool_size = *size;
+            }
+            old_pool = std::move(async_pool);
+        }
+        py::gil_scoped_release release;
+        old_pool.reset();
+    }
+
+    /**
+     * Lazy sequence over nodes of a File, Python wrappers are created only for
+     * elements which are accessed. Keeps the File alive.
+     */
+    class NodesView {
+      public:
+        using nodes_t = std::vector<std::shared_ptr<gbr::Node>>;
+
+        py::object     owner;
+        const nodes_t* nodes;
+
+        std::size_t size() const {
+            return nodes->size();
+        }
+
+        std::shared_ptr<gbr::Node> at(py::ssize_t index) const {
+            const auto size = static_cast<py::ssize_t>(nodes->size());
+            if (index < 0) {
+                index += size;
+            }
+            if (index < 0 || index >= size) {
+                throw py::index_error("NodesView index out of range");
+            }
+            return (*nodes)[static_cast<std::size_t>(index)];
+        }
+
+        py::list slice(const py::slice& range) const {
+            std::size_t start, stop, step, length;
+            if (!range.compute(nodes->size(), &start, &stop, &step, &length)) {
+                throw py::error_already_set();
+            }
+            py::list result(length);
+            for (std::size_t i = 0; i < length; i++) {
+                result[i] = py::cast((*nodes)[start + i * step]);
+            }
+            return result;
+        }
+    };
+
+    py::dict stats_to_dict(const gbr::ParseStats& stats) {
+        py::dict families;
+        for (int i = 0; i < gbr::ParseStats::FAMILY_COUNT; i++) {
+            const auto family = static_cast<gbr::ParseStats::Family>(i);
+            py::dict   entry;
+            entry["commands"] = stats.family_commands[i];
+            entry["time_ns"]  = stats.family_time[i].count();
+            families[py::str(std::string(gbr::ParseStats::family_name(family)))] = entry;
+        }
+
+        py::dict result;
+        result["bytes_scanned"]  = stats.bytes_scanned;
+        result["comment_bytes"]  = stats.comment_bytes;
+        result["aperture_count"] = stats.aperture_count;
+        result["largest_region"] = stats.largest_region;
+        result["peak_bytes"]     = stats.peak_bytes;
+        result["scan_time_ns"]   = stats.scan_time.count();
+        result["total_time_ns"]  = stats.total_time.count();
+        result["timing_enabled"] = gbr::ParseStats::timing_enabled;
+        result["families"]       = families;
+        result["nodes"]          = stats.nodes;
+        return result;
+    }
+
+    py::object parse_async(
+        const gbr::Parser& parser, std::string source, const py::object& syntax_error_type
+    ) {
+        auto loop   = py::module_::import("asyncio").attr("get_running_loop")();
+        auto future = loop.attr("create_future")();
+
+        auto stop_source = std::make_shared<std::stop_source>();
+        future.attr("add_done_callback")(py::cpp_function([stop_source](py::object done) {
+            if (done.attr("cancelled")().cast<bool>()) {
+                stop_source->request_stop();
+            }
+        }));
+
+        // Owned by the worker once submitted, it has to acquire GIL to release it.
+        auto pending = std::make_unique<AsyncParse>(AsyncParse{loop, future, syntax_error_type});
+
+        submit_async([parser,
+                      source     = std::move(source),
+                      stop_token = stop_source->get_token(),
+                      pending    = pending.get()]() {
+            std::optional<gbr::File>   file;
+            std::optional<std::string> syntax_error;
+            std::optional<std::string> runtime_error;
+            try {
+                file.emplace(parser.parse(source, stop_token));
+            } catch (const gbr::CancelledError&) {
+                // Future is already cancelled, nothing to deliver.
+            } catch (const gbr::SyntaxError& error) {
+                syntax_error = error.what();
+            } catch (const std::exception& error) {
+                runtime_error = error.what();
+            }
+
+            py::gil_scoped_acquire      acquire;
+            std::unique_ptr<AsyncParse> owner(pending);
+            try {
+                py::object result    = file.has_value() ? py::cast(std::move(*file)) : py::none();
+                py::object exception = py::none();
+                if (syntax_error.has_value()) {
+                    exception = owner->syntax_error_type(*syntax_error);
+                } else if (runtime_error.has_value()) {
+                    exception = py::module_::import("builtins").attr("RuntimeError")(*runtime_error);
+                }
+                auto future = owner->future;
+                owner->loop.attr("call_soon_threadsafe")(
+                    py::cpp_function([future, result, exception]() {
+                        if (future.attr("done")().cast<bool>()) {
+                            return;
+                        }
+                        if (exception.is_none()) {
+                            future.attr("set_result")(result);
+                        } else {
+                            future.attr("set_exception")(exception);
+                        }
+                    })
+                );
+            } catch (py::error_already_set&) {
+                // Event loop was closed before parsing finished.
+            }
+        });
+        pending.release();
+        return future;
+    }
+
+    /**
+     * PyGerber AST classes and enum members, imported once per process and kept
+     * until interpreter exits.
+     */
+    class PyGerberTypes {
+      public:
+        py::object file;
+        py::object adc, ado, adp, adr, am, am_open, am_close;
+        py::object d01, d02, d03, dnn;
+        py::object g01, g02, g03, g04, g36, g37, g54, g55, g70, g71, g74, g75, g90, g91;
+        py::object lp, m02, fs, mo;
+        py::object coordinate_x, coordinate_y, coordinate_i, coordinate_j;
+        py::object zeros_skip_leading, zeros_skip_trailing;
+        py::object notation_absolute, notation_incremental;
+        py::object unit_inches, unit_millimeters;
+        py::object polarity_dark, polarity_clear;
+
+        static const PyGerberTypes& get() {
+            PYBIND11_CONSTINIT static py::gil_safe_call_once_and_store<PyGerberTypes> storage;
+            return storage
+                .call_once_and_store_result([]() {
+                    return PyGerberTypes();
+                })
+                .get_stored();
+        }
+
+      private:
+        PyGerberTypes() {
+            const auto nodes = py::module_::import("pygerber.gerber.ast.nodes");
+            const auto enums = py::module_::import("pygerber.gerber.ast.nodes.enums");
+
+            file     = nodes.attr("File");
+            adc      = nodes.attr("ADC");
+            ado      = nodes.attr("ADO");
+            adp      = nodes.attr("ADP");
+            adr      = nodes.attr("ADR");
+            am       = nodes.attr("AM");
+            am_open  = nodes.attr("AMopen");
+            am_close = nodes.attr("AMclose");
+            d01      = nodes.attr("D01");
+            d02      = nodes.attr("D02");
+            d03      = nodes.attr("D03");
+            dnn      = nodes.attr("DNN");
+            g01      = nodes.attr("G01");
+            g02      = nodes.attr("G02");
+            g03      = nodes.attr("G03");
+            g04      = nodes.attr("G04");
+            g36      = nodes.attr("G36");
+            g37      = nodes.attr("G37");
+            g54      = nodes.attr("G54");
+            g55      = nodes.attr("G55");
+            g70      = nodes.attr("G70");
+            g71      = nodes.attr("G71");
+            g74      = nodes.attr("G74");
+            g75      = nodes.attr("G75");
+            g90      = nodes.attr("G90");
+            g91      = nodes.attr("G91");
+            lp       = nodes.attr("LP");
+            m02      = nodes.attr("M02");
+            fs       = nodes.attr("FS");
+            mo       = nodes.attr("MO");
+
+            coordinate_x = nodes.attr("CoordinateX");
+            coordinate_y = nodes.attr("CoordinateY");
+            coordinate_i = nodes.attr("CoordinateI");
+            coordinate_j = nodes.attr("CoordinateJ");
+
+            // Enum members are looked up by their Gerber values, eg. Zeros("L").
+            zeros_skip_leading   = enums.attr("Zeros")("L");
+            zeros_skip_trailing  = enums.attr("Zeros")("T");
+            notation_absolute    = enums.attr("CoordinateNotation")("A");
+            notation_incremental = enums.attr("CoordinateNotation")("I");
+            unit_inches          = enums.attr("UnitMode")("IN");
+            unit_millimeters     = enums.attr("UnitMode")("MM");
+            polarity_dark        = enums.attr("Polarity")("D");
+            polarity_clear       = enums.attr("Polarity")("C");
+        }
+    };
+
+    /**
+     * Builds PyGerber AST of a File in a single pass. Standalone coordinates, as
+     * emitted with split operations, are attached to the following D01, D02 or D03
+     * like PyGerber does.
+     */
+    class PyGerberBuilder : public gbr::Visitor {
+      private:
+        const PyGerberTypes& types;
+        py::list             nodes;
+        py::object           pending_x;
+        py::object           pending_y;
+        py::object           pending_i;
+        py::object           pending_j;
+
+      public:
+        PyGerberBuilder() :
+            types(PyGerberTypes::get()),
+            nodes(),
+            pending_x(py::none()),
+            pending_y(py::none()),
+            pending_i(py::none()),
+            pending_j(py::none()) {}
+
+        py::object build(const gbr::File& file) {
+            file.visit(*this);
+            return types.file(py::arg("nodes") = nodes);
+        }
+
+        // Aperture
+
+        void on_adc(const gbr::ADC& node) override {
+            nodes.append(types.adc(
+                py::arg("aperture_id")   = aperture_id(node.getApertureIdView()),
+                py::arg("diameter")      = node.getDiameter(),
+                py::arg("hole_diameter") = node.getHoleDiameter()
+            ));
+        }
+
+        void on_ado(const gbr::ADO& node) override {
+            nodes.append(types.ado(
+                py::arg("aperture_id")   = aperture_id(node.getApertureIdView()),
+                py::arg("width")         = node.getWidth(),
+                py::arg("height")        = node.getHeight(),
+                py::arg("hole_diameter") = node.getHoleDiameter()
+            ));
+        }
+
+        void on_adp(const gbr::ADP& node) override {
+            nodes.append(types.adp(
+                py::arg("aperture_id")    = aperture_id(node.getApertureIdView()),
+                py::arg("outer_diameter") = node.getOuterDiameter(),
+                py::arg("vertices")       = static_cast<int>(node.getVerticesCount()),
+                py::arg("base_rotation")  = node.getRotation(),
+                py::arg("hole_diameter")  = node.getHoleDiameter()
+            ));
+        }
+
+        void on_adr(const gbr::ADR& node) override {
+            nodes.append(types.adr(
+                py::arg("aperture_id")   = aperture_id(node.getApertureIdView()),
+                py::arg("width")         = node.getWidth(),
+                py::arg("height")        = node.getHeight(),
+                py::arg("hole_diameter") = node.getHoleDiameter()
+            ));
+        }
+
+        void on_am(const gbr::AM& node) override {
+            nodes.append(types.am(
+                py::arg("open") =
+                    types.am_open(py::arg("name") = node.getAmOpen()->getApertureIdView()),
+                py::arg("primitives") = py::list(),
+                py::arg("close")      = types.am_close()
+            ));
+        }
+
+        // D codes
+
+        void on_d01(const gbr::D01&) override {
+            nodes.append(types.d01(
+                py::arg("x") = take(pending_x),
+                py::arg("y") = take(pending_y),
+                py::arg("i") = take(pending_i),
+                py::arg("j") = take(pending_j)
+            ));
+        }
+
+        void on_d02(const gbr::D02&) override {
+            nodes.append(types.d02(py::arg("x") = take(pending_x), py::arg("y") = take(pending_y))
+            );
+        }
+
+        void on_d03(const gbr::D03&) override {
+            nodes.append(types.d03(py::arg("x") = take(pending_x), py::arg("y") = take(pending_y))
+            );
+        }
+
+        void on_dnn(const gbr::Dnn& node) override {
+            nodes.append(types.dnn(py::arg("aperture_id") = aperture_id(node.getApertureIdView())));
+        }
+
+        void on_operation(const gbr::Operation& node) override {
+            const auto x = coordinate(types.coordinate_x, node.getXView());
+            const auto y = coordinate(types.coordinate_y, node.getYView());
+
+            switch (node.getKind()) {
+                case gbr::Operation::INTERPOLATE:
+                    nodes.append(types.d01(
+                        py::arg("x") = x,
+                        py::arg("y") = y,
+                        py::arg("i") = coordinate(types.coordinate_i, node.getIView()),
+                        py::arg("j") = coordinate(types.coordinate_j, node.getJView())
+                    ));
+                    break;
+                case gbr::Operation::MOVE:
+                    nodes.append(types.d02(py::arg("x") = x, py::arg("y") = y));
+                    break;
+                case gbr::Operation::FLASH:
+                    nodes.append(types.d03(py::arg("x") = x, py::arg("y") = y));
+                    break;
+            }
+        }
+
+        // G codes
+
+        void on_g01(const gbr::G01&) override {
+            nodes.append(types.g01());
+        }
+
+        void on_g02(const gbr::G02&) override {
+            nodes.append(types.g02());
+        }
+
+        void on_g03(const gbr::G03&) override {
+            nodes.append(types.g03());
+        }
+
+        void on_g04(const gbr::G04& node) override {
+            nodes.append(types.g04(py::arg("string") = node.getCommentView()));
+        }
+
+        void on_g36(const gbr::G36&) override {
+            nodes.append(types.g36());
+        }
+
+        void on_g37(const gbr::G37&) override {
+            nodes.append(types.g37());
+        }
+
+        void on_g54(const gbr::G54&) override {
+            nodes.append(types.g54());
+        }
+
+        void on_g55(const gbr::G55&) override {
+            nodes.append(types.g55());
+        }
+
+        void on_g70(const gbr::G70&) override {
+            nodes.append(types.g70());
+        }
+
+        void on_g71(const gbr::G71&) override {
+            nodes.append(types.g71());
+        }
+
+        void on_g74(const gbr::G74&) override {
+            nodes.append(types.g74());
+        }
+
+        void on_g75(const gbr::G75&) override {
+            nodes.append(types.g75());
+        }
+
+        void on_g90(const gbr::G90&) override {
+            nodes.append(types.g90());
+        }
+
+        void on_g91(const gbr::G91&) override {
+            nodes.append(types.g91());
+        }
+
+        // Load
+
+        void on_lp(const gbr::LP& node) override {
+            nodes.append(types.lp(
+                py::arg("polarity") = node.polarity == gbr::Polarity::DARK ? types.polarity_dark
+                                                                           : types.polarity_clear
+            ));
+        }
+
+        // M codes
+
+        void on_m02(const gbr::M02&) override {
+            nodes.append(types.m02());
+        }
+
+        // Other
+
+        void on_coordinate_x(const gbr::CoordinateX& node) override {
+            pending_x = coordinate(types.coordinate_x, node.getValueView());
+        }
+
+        void on_coordinate_y(const gbr::CoordinateY& node) override {
+            pending_y = coordinate(types.coordinate_y, node.getValueView());
+        }
+
+        void on_coordinate_i(const gbr::CoordinateI& node) override {
+            pending_i = coordinate(types.coordinate_i, node.getValueView());
+        }
+
+        void on_coordinate_j(const gbr::CoordinateJ& node) override {
+            pending_j = coordinate(types.coordinate_j, node.getValueView());
+        }
+
+        // Properties
+
+        void on_fs(const gbr::FS& node) override {
+            const auto& zeros = node.zeros == gbr::Zeros::SKIP_LEADING ? types.zeros_skip_leading
+                                                                        : types.zeros_skip_trailing;
+            const auto& coordinate_mode = node.coordinate_mode == gbr::CoordinateNotation::ABSOLUTE
+                                            ? types.notation_absolute
+                                            : types.notation_incremental;
+            nodes.append(types.fs(
+                py::arg("zeros")           = zeros,
+                py::arg("coordinate_mode") = coordinate_mode,
+                py::arg("x_integral")      = node.x_integral,
+                py::arg("x_decimal")       = node.x_decimal,
+                py::arg("y_integral")      = node.y_integral,
+                py::arg("y_decimal")       = node.y_decimal
+            ));
+        }
+
+        void on_mo(const gbr::MO& node) override {
+            nodes.append(types.mo(
+                py::arg("mode") = node.unit_mode == gbr::UnitMode::INCHES ? types.unit_inches
+                                                                          : types.unit_millimeters
+            ));
+        }
+
+      private:
+        // PyGerber aperture ids include the D prefix, eg. D10.
+        static py::str aperture_id(const std::string_view& digits) {
+            std::string id;
+            id.reserve(digits.size() + 1);
+            id.push_back('D');
+            id.append(digits);
+            return py::str(id);
+        }
+
+        static py::object
+        coordinate(const py::object& type, const std::optional<std::string_view>& value) {
+            if (!value.has_value()) {
+                return py::none();
+            }
+            return type(py::arg("value") = *value);
+        }
+
+        static py::object take(py::object& pending) {
+            return std::exchange(pending, py::none());
+        }
+    };
+} // namespace
+
 PYBIND11_MODULE(gerber_parser, m) {
-    py::register_exception<gbr::SyntaxError>(m, "SyntaxError", PyExc_RuntimeError);
+    py::object syntax_error_type =
+        py::register_exception<gbr::SyntaxError>(m, "SyntaxError", PyExc_RuntimeError);
+    py::register_exception<gbr::ArchiveError>(m, "ArchiveError", PyExc_RuntimeError);
 
     py::class_<gbr::Node, std::shared_ptr<gbr::Node>>(m, "Node").def(py::init<>());
 
-    py::class_<gbr::File>(m, "File").def_property_readonly("nodes", &gbr::File::getNodes);
+    py::class_<NodesView>(m, "NodesView")
+        .def("__len__", &NodesView::size)
+        .def("__getitem__", &NodesView::at, py::arg("index"))
+        .def("__getitem__", &NodesView::slice, py::arg("index"))
+        .def(
+            "__iter__",
+            [](const NodesView& self) {
+                return py::make_iterator(self.nodes->begin(), self.nodes->end());
+            },
+            py::keep_alive<0, 1>()
+        );
+
+    py::class_<gbr::File>(m, "File")
+        .def_property_readonly(
+            "nodes",
+            [](py::object self) {
+                const auto& file = self.cast<const gbr::File&>();
+                return NodesView{self, &file.getNodes()};
+            }
+        )
+        .def("memory_usage", &gbr::File::memory_usage)
+        .def("to_pygerber", [](const gbr::File& self) {
+            PyGerberBuilder builder;
+            return builder.build(self);
+        });
 
     py::class_<gbr::Command>(m, "Command").def(py::init<>());
 
+    // D-codes
+    py::class_<gbr::Operation, std::shared_ptr<gbr::Operation>>(m, "Operation")
+        .def("__str__", &gbr::Operation::getNodeName)
+        .def_property_readonly(
+            "kind", [](const gbr::Operation& self) { return static_cast<int>(self.getKind()); }
+        )
+        .def_property_readonly("x", &gbr::Operation::getX)
+        .def_property_readonly("y", &gbr::Operation::getY)
+        .def_property_readonly("i", &gbr::Operation::getI)
+        .def_property_readonly("j", &gbr::Operation::getJ)
+        .def("visit", [](py::object self, py::object visitor) {
+            switch (self.cast<const gbr::Operation&>().getKind()) {
+                case gbr::Operation::INTERPOLATE:
+                    return visitor.attr("on_d01")(self);
+                case gbr::Operation::MOVE:
+                    return visitor.attr("on_d02")(self);
+                case gbr::Operation::FLASH:
+                    return visitor.attr("on_d03")(self);
+            }
+            throw std::runtime_error("Invalid operation kind");
+        });
+
     // G-codes
     py::class_<gbr::G01, std::shared_ptr<gbr::G01>>(m, "G01")
         .def(py::init<>())
@@ -123,15 +695,14 @@ PYBIND11_MODULE(gerber_parser, m) {
         .def("__str__", &gbr::FS::getNodeName)
         .def_property_readonly(
             "zeros",
-            [](const gbr::FS& self) {
-                py::object pygerber_gerber_enums =
-                    py::module_::import("pygerber.gerber.ast.nodes.enums");
+            [](const gbr::FS& self) -> py::object {
+                const auto& types = PyGerberTypes::get();
 
                 switch (self.zeros.value) {
                     case gbr::Zeros::SKIP_LEADING:
-                        return pygerber_gerber_enums.attr("Zeros").attr("SKIP_LEADING");
+                        return types.zeros_skip_leading;
                     case gbr::Zeros::SKIP_TRAILING:
-                        return pygerber_gerber_enums.attr("Zeros").attr("SKIP_TRAILING");
+                        return types.zeros_skip_trailing;
                 }
                 throw std::runtime_error("Invalid 'zeros' value");
             }
@@ -140,5 +711,141 @@ PYBIND11_MODULE(gerber_parser, m) {
             return visitor.attr("on_fs")(self);
         });
 
-    py::class_<gbr::Parser>(m, "GerberParser").def(py::init<>()).def("parse", &gbr::Parser::parse);
+    py::class_<gbr::Parser>(m, "GerberParser")
+        .def(
+            py::init([](bool split_operations) {
+                return gbr::Parser(gbr::ParserOptions{.split_operations = split_operations});
+            }),
+            py::kw_only(),
+            py::arg("split_operations") = false
+        )
+        .def(
+            "parse",
+            py::overload_cast<const std::string&>(&gbr::Parser::parse, py::const_),
+            py::call_guard<py::gil_scoped_release>()
+        )
+        .def(
+            "parse_with_stats",
+            [](const gbr::Parser& self, const std::string& source) {
+                gbr::ParseStats stats;
+                auto            file = [&]() {
+                    py::gil_scoped_release release;
+                    return self.parse(source, stats);
+                }();
+                return py::make_tuple(std::move(file), stats_to_dict(stats));
+            },
+            py::arg("source")
+        )
+        .def(
+            "parse_file",
+            &gbr::Parser::parse_file,
+            py::arg("path"),
+            py::call_guard<py::gil_scoped_release>()
+        )
+        .def(
+            "parse_package",
+            [](const gbr::Parser&              self,
+               const std::string&              path,
+               const std::vector<std::string>& names,
+               std::size_t                     threads) {
+                std::vector<gbr::PackageMember> members;
+                {
+                    py::gil_scoped_release release;
+                    const auto archive = gbr::ZipArchive::open(path);
+                    members            = gbr::Package::parse(archive, self, names, threads);
+                }
+                py::dict result;
+                for (auto& member : members) {
+                    result[py::str(member.name)] = py::cast(std::move(member.file));
+                }
+                return result;
+            },
+            py::arg("path"),
+            py::arg("names")   = std::vector<std::string>{},
+            py::arg("threads") = 0
+        )
+        .def(
+            "parse_async",
+            [syntax_error_type](const gbr::Parser& self, std::string source) {
+                return parse_async(self, std::move(source), syntax_error_type);
+            },
+            py::arg("source")
+        );
+
+    m.def(
+        "set_async_pool_size",
+        [](std::size_t size) {
+            reset_async_pool(size);
+        },
+        py::arg("size"),
+        "Set number of worker threads used by parse_async(), 0 means one per CPU core."
+    );
+    m.def("get_async_pool_size", []() -> std::size_t {
+        std::lock_guard lock(async_pool_mutex);
+        if (async_pool) {
+            return async_pool->size();
+        }
+        return async_pool_size != 0 ? async_pool_size
+                                    : std::max(1u, std::thread::hardware_concurrency());
+    });
+
+    // Workers must finish before interpreter shuts down, as they need GIL.
+    py::module_::import("atexit").attr("register")(py::cpp_function([]() {
+        reset_async_pool(std::nullopt);
+    }));
+
+    py::class_<gbr::Writer>(m, "GerberWriter")
+        .def(py::init<>())
+        .def(
+            "write",
+            py::overload_cast<const gbr::File&>(&gbr::Writer::write, py::const_),
+            py::call_guard<py::gil_scoped_release>()
+        )
+        .def(
+            "write_file",
+            [](const gbr::Writer& self, const gbr::File& file, const std::string& path) {
+                std::ofstream output(path, std::ios::binary);
+                if (!output) {
+                    throw std::runtime_error("Failed to open '" + path + "' for writing");
+                }
+                self.write(file, output);
+            },
+            py::call_guard<py::gil_scoped_release>()
+        );
+
+    // Python exporter holds only options, each export streams into its own SvgExporter.
+    py::class_<gbr::SvgOptions>(m, "SvgExporter")
+        .def(
+            py::init([](std::string color, int precision) {
+                return gbr::SvgOptions{std::move(color), precision};
+            }),
+            py::kw_only(),
+            py::arg("color")     = "black",
+            py::arg("precision") = 4
+        )
+        .def(
+            "export",
+            [](const gbr::SvgOptions& self, const std::string& source) {
+                std::string svg;
+                {
+                    py::gil_scoped_release release;
+                    svg = gbr::SvgExporter::render(source, self);
+                }
+                return py::bytes(svg);
+            },
+            py::arg("source")
+        )
+        .def(
+            "export_file",
+            [](const gbr::SvgOptions& self, const std::string& source, const std::string& path) {
+                std::ofstream output(path, std::ios::binary);
+                if (!output) {
+                    throw std::runtime_error("Failed to open '" + path + "' for writing");
+                }
+                gbr::SvgExporter::render(source, output, self);
+            },
+            py::arg("source"),
+            py::arg("path"),
+            py::call_guard<py::gil_scoped_release>()
+        );
 }
\ No newline at end of file
@@ -0,0 +1,227 @@
+#include "gerber/gerber.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef GERBER_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+namespace {
+    const std::string gerber_source =
+        "%FSLAX24Y24*%\n%MOMM*%\n%ADD10C,0.5*%\nD10*\nX100Y100D03*\nM02*\n";
+
+    uint32_t crc32_of(const std::string& data) {
+        uint32_t crc = 0xFFFFFFFF;
+        for (const unsigned char c : data) {
+            crc ^= c;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+            }
+        }
+        return ~crc;
+    }
+
+    void put_u16(std::string& out, uint32_t value) {
+        out.push_back(static_cast<char>(value & 0xFF));
+        out.push_back(static_cast<char>((value >> 8) & 0xFF));
+    }
+
+    void put_u32(std::string& out, uint32_t value) {
+        put_u16(out, value & 0xFFFF);
+        put_u16(out, value >> 16);
+    }
+
+    class TestMember {
+      public:
+        std::string name;
+        std::string content;
+        uint16_t    method;
+        std::string compressed;
+    };
+
+    /**
+     * Minimal zip writer, enough to exercise ZipArchive.
+     */
+    std::string make_zip(const std::vector<TestMember>& members) {
+        std::string archive;
+        std::string directory;
+
+        for (const auto& member : members) {
+            const auto offset = static_cast<uint32_t>(archive.size());
+            const auto crc    = crc32_of(member.content);
+
+            put_u32(archive, 0x04034b50);
+            put_u16(archive, 20);
+            put_u16(archive, 0);
+            put_u16(archive, member.method);
+            put_u32(archive, 0);
+            put_u32(archive, crc);
+            put_u32(archive, static_cast<uint32_t>(member.compressed.size()));
+            put_u32(archive, static_cast<uint32_t>(member.content.size()));
+            put_u16(archive, static_cast<uint32_t>(member.name.size()));
+            put_u16(archive, 0);
+            archive += member.name;
+            archive += member.compressed;
+
+            put_u32(directory, 0x02014b50);
+            put_u16(directory, 20);
+            put_u16(directory, 20);
+            put_u16(directory, 0);
+            put_u16(directory, member.method);
+            put_u32(directory, 0);
+            put_u32(directory, crc);
+            put_u32(directory, static_cast<uint32_t>(member.compressed.size()));
+            put_u32(directory, static_cast<uint32_t>(member.content.size()));
+            put_u16(directory, static_cast<uint32_t>(member.name.size()));
+            put_u16(directory, 0);
+            put_u16(directory, 0);
+            put_u16(directory, 0);
+            put_u16(directory, 0);
+            put_u32(directory, 0);
+            put_u32(directory, offset);
+            directory += member.name;
+        }
+
+        const auto directory_offset = static_cast<uint32_t>(archive.size());
+        archive += directory;
+        put_u32(archive, 0x06054b50);
+        put_u16(archive, 0);
+        put_u16(archive, 0);
+        put_u16(archive, static_cast<uint32_t>(members.size()));
+        put_u16(archive, static_cast<uint32_t>(members.size()));
+        put_u32(archive, static_cast<uint32_t>(directory.size()));
+        put_u32(archive, directory_offset);
+        put_u16(archive, 0);
+        return archive;
+    }
+
+    TestMember stored(const std::string& name, const std::string& content) {
+        return TestMember{name, content, 0, content};
+    }
+
+#ifdef GERBER_WITH_ZLIB
+    std::string deflate(const std::string& data, int window_bits) {
+        z_stream stream{};
+        deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, window_bits, 8, Z_DEFAULT_STRATEGY);
+
+        std::string output(deflateBound(&stream, data.size()) + 32, '\0');
+        stream.next_in   = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+        stream.avail_in  = static_cast<uInt>(data.size());
+        stream.next_out  = reinterpret_cast<Bytef*>(output.data());
+        stream.avail_out = static_cast<uInt>(output.size());
+        deflate(&stream, Z_FINISH);
+        output.resize(stream.total_out);
+        deflateEnd(&stream);
+        return output;
+    }
+
+    TestMember deflated(const std::string& name, const std::string& content) {
+        return TestMember{name, content, 8, deflate(content, -15)};
+    }
+#endif
+} // namespace
+
+TEST_CASE("Read stored zip members", "[archive]") {
+    gerber::ZipArchive archive(make_zip({
+        stored("board/", ""),
+        stored("board/top.gtl", gerber_source),
+        stored("board/readme.txt", "hello"),
+    }));
+
+    REQUIRE(archive.getEntries().size() == 3);
+    REQUIRE(archive.getEntries()[0].isDirectory());
+    REQUIRE(archive.find("board/readme.txt") != nullptr);
+    REQUIRE(archive.read(*archive.find("board/readme.txt")) == "hello");
+
+    const gerber::Parser parser;
+    auto                 members = gerber::Package::parse(archive, parser);
+
+    REQUIRE(members.size() == 1);
+    REQUIRE(members[0].name == "board/top.gtl");
+    REQUIRE(members[0].file.getNodes().size() == 6);
+}
+
+TEST_CASE("Invalid zip archive", "[archive]") {
+    REQUIRE_THROWS_AS(gerber::ZipArchive(std::string(100, 'x')), gerber::ArchiveError);
+    REQUIRE_THROWS_AS(gerber::ZipArchive("PK"), gerber::ArchiveError);
+}
+
+TEST_CASE("Gerber file names", "[archive]") {
+    REQUIRE(gerber::Package::is_gerber_name("top.GTL"));
+    REQUIRE(gerber::Package::is_gerber_name("dir/copper.gbr"));
+    REQUIRE_FALSE(gerber::Package::is_gerber_name("drill.xln"));
+    REQUIRE_FALSE(gerber::Package::is_gerber_name("Makefile"));
+}
+
+#ifdef GERBER_WITH_ZLIB
+
+TEST_CASE("Parse deflated zip members in parallel", "[archive]") {
+    std::vector<TestMember>  members;
+    std::vector<std::string> names;
+    for (int i = 0; i < 16; i++) {
+        names.push_back("layer" + std::to_string(i) + ".gbr");
+        members.push_back(deflated(names.back(), gerber_source));
+    }
+    gerber::ZipArchive   archive(make_zip(members));
+    const gerber::Parser parser;
+
+    auto parsed = gerber::Package::parse(archive, parser, {}, 4);
+
+    REQUIRE(parsed.size() == 16);
+    for (size_t i = 0; i < parsed.size(); i++) {
+        REQUIRE(parsed[i].name == names[i]);
+        REQUIRE(parsed[i].file.getNodes().size() == 6);
+    }
+
+    auto selected = gerber::Package::parse(archive, parser, {"layer3.gbr"});
+    REQUIRE(selected.size() == 1);
+    REQUIRE(selected[0].name == "layer3.gbr");
+}
+
+TEST_CASE("Syntax error in zip member is propagated", "[archive]") {
+    gerber::ZipArchive   archive(make_zip({deflated("bad.gbr", "lol")}));
+    const gerber::Parser parser;
+
+    REQUIRE_THROWS_AS(gerber::Package::parse(archive, parser), gerber::SyntaxError);
+}
+
+TEST_CASE("Parse gzip file", "[archive]") {
+    // Two concatenated gzip members are one stream.
+    const auto half = gerber_source.size() / 2;
+    const auto data = deflate(gerber_source.substr(0, half), 15 + 16) +
+                      deflate(gerber_source.substr(half), 15 + 16);
+    const auto path = std::filesystem::temp_directory_path() / "gerber_archive_test.gbr.gz";
+    {
+        std::ofstream output(path, std::ios::binary);
+        output << data;
+    }
+    REQUIRE(gerber::is_gzip(data));
+    REQUIRE(gerber::decompress_gzip(data) == gerber_source);
+
+    const gerber::Parser parser;
+    REQUIRE(parser.parse_file(path.string()).getNodes().size() == 6);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Inflated size is limited", "[archive]") {
+    const std::string zeros(1 << 20, '0');
+    const auto        data = deflate(zeros, 15 + 16);
+    REQUIRE(gerber::decompress_gzip(data, zeros.size()) == zeros);
+    REQUIRE_THROWS_AS(gerber::decompress_gzip(data, zeros.size() - 1), gerber::ArchiveError);
+    REQUIRE_THROWS_AS(gerber::decompress_gzip(data, 0), gerber::ArchiveError);
+
+    // Member which inflates to more than its declared size.
+    auto bomb    = deflated("bomb.gbr", zeros);
+    bomb.content = gerber_source;
+    gerber::ZipArchive archive(make_zip({bomb, deflated("empty.gbr", "")}));
+    REQUIRE_THROWS_AS(archive.read(archive.getEntries()[0]), gerber::ArchiveError);
+    REQUIRE(archive.read(archive.getEntries()[1]).empty());
+}
+
+#endif
@@ -0,0 +1,110 @@
+#include "gerber/code_table.hpp"
+#include "gerber/gerber.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace {
+    /**
+     * Code dispatch as done before code tables, kept as benchmark baseline.
+     */
+    std::shared_ptr<gerber::Node> switch_g_code(const std::string_view& digits) {
+        switch (std::stoi(std::string(digits))) {
+            case 1:
+                return std::make_shared<gerber::G01>();
+            case 2:
+                return std::make_shared<gerber::G02>();
+            case 3:
+                return std::make_shared<gerber::G03>();
+            case 4:
+                return std::make_shared<gerber::G04>("");
+            case 36:
+                return std::make_shared<gerber::G36>();
+            case 37:
+                return std::make_shared<gerber::G37>();
+            case 54:
+                return std::make_shared<gerber::G54>();
+            case 55:
+                return std::make_shared<gerber::G55>();
+            case 70:
+                return std::make_shared<gerber::G70>();
+            case 71:
+                return std::make_shared<gerber::G71>();
+            case 74:
+                return std::make_shared<gerber::G74>();
+            case 75:
+                return std::make_shared<gerber::G75>();
+            case 90:
+                return std::make_shared<gerber::G90>();
+            case 91:
+                return std::make_shared<gerber::G91>();
+        }
+        return nullptr;
+    }
+
+    std::shared_ptr<gerber::Node> table_g_code(const std::string_view& digits) {
+        const auto factory = gerber::g_code_table.find(gerber::scan_code_number(digits).value);
+        return factory != nullptr ? factory(digits) : nullptr;
+    }
+
+    constexpr std::string_view benchmark_codes[] = {
+        "1", "2", "3", "36", "37", "54", "70", "71", "74", "75", "90", "91",
+    };
+} // namespace
+
+TEST_CASE("Scan code number", "[code_table]") {
+    using gerber::CodeNumber;
+
+    REQUIRE(gerber::scan_code_number("") == CodeNumber{0, 0});
+    REQUIRE(gerber::scan_code_number("*") == CodeNumber{0, 0});
+    REQUIRE(gerber::scan_code_number("1*") == CodeNumber{1, 1});
+    REQUIRE(gerber::scan_code_number("75*X100Y100") == CodeNumber{75, 2});
+    REQUIRE(gerber::scan_code_number("1234567*D10*") == CodeNumber{1234567, 7});
+    REQUIRE(gerber::scan_code_number("12345678*D10*") == CodeNumber{12345678, 8});
+    REQUIRE(gerber::scan_code_number("123456789*") == CodeNumber{123456789, 9});
+    REQUIRE(gerber::scan_code_number("0001/:9*") == CodeNumber{1, 4});
+    REQUIRE(gerber::scan_code_number("12345678901*") == CodeNumber{UINT32_MAX, 11});
+}
+
+TEST_CASE("Code tables", "[code_table]") {
+    static_assert(gerber::g_code_table.find(5) == nullptr);
+    static_assert(gerber::g_code_table.find(129) == nullptr);
+    static_assert(gerber::m_code_table.find(6) == nullptr);
+    static_assert(gerber::d_code_table.find(5) == &gerber::make_code_node<gerber::Dnn>);
+
+    for (const auto digits : benchmark_codes) {
+        REQUIRE(table_g_code(digits)->getNodeName() == switch_g_code(digits)->getNodeName());
+    }
+    REQUIRE(gerber::d_code_table.find(2)("2")->getNodeName() == "D02");
+    REQUIRE(gerber::m_code_table.find(2)("2")->getNodeName() == "M02");
+}
+
+TEST_CASE("Code dispatch benchmark", "[.][benchmark]") {
+    BENCHMARK("switch") {
+        std::size_t count = 0;
+        for (const auto digits : benchmark_codes) {
+            count += switch_g_code(digits) != nullptr;
+        }
+        return count;
+    };
+
+    BENCHMARK("table") {
+        std::size_t count = 0;
+        for (const auto digits : benchmark_codes) {
+            count += table_g_code(digits) != nullptr;
+        }
+        return count;
+    };
+
+    std::string source;
+    for (int i = 0; i < 10000; i++) {
+        source += "G01*G75*D10*G36*D02*G37*M02*";
+    }
+    BENCHMARK("parse codes") {
+        gerber::Parser parser;
+        return parser.parse(source).getNodes().size();
+    };
+}
@@ -0,0 +1,76 @@
+#include "gerber/gerber.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+    std::string write_node(const std::shared_ptr<gerber::Node>& node) {
+        std::vector<std::shared_ptr<gerber::Node>> nodes{node};
+        return gerber::Writer().write(gerber::File(std::move(nodes)));
+    }
+
+    class NodeCounter : public gerber::Visitor {
+      public:
+        std::size_t count = 0;
+
+        void on_node(const gerber::Node&) override {
+            count++;
+        }
+    };
+} // namespace
+
+TEST_CASE("Compact file decodes to the same commands", "[compact]") {
+    const std::string source = R"(%FSLAX26Y26*%
+%MOMM*%
+%ADD10C,0.5*%
+G04 comment*
+D10*
+%LPC*%
+X-1000Y+2000D02*
+X000100Y0D01*
+G75*
+G03*
+X2000000Y-50I1000000J0D01*
+%LPD*%
+X5Y5D03*
+M02*
+)";
+    for (const bool split_operations : {false, true}) {
+        gerber::Parser parser(gerber::ParserOptions{.split_operations = split_operations});
+        const auto     file    = parser.parse(source);
+        const auto     compact = gerber::CompactFile(file);
+
+        const auto expected = gerber::Writer().write(file);
+        REQUIRE(compact.size() == file.getNodes().size());
+        REQUIRE(gerber::Writer().write(compact.decode()) == expected);
+
+        NodeCounter counter;
+        compact.visit(counter);
+        REQUIRE(counter.count == file.getNodes().size());
+    }
+}
+
+TEST_CASE("Compact file gives random access to nodes", "[compact]") {
+    gerber::CorpusOptions options;
+    options.target_bytes = 512 * 1024;
+
+    gerber::Parser parser;
+    const auto     file    = parser.parse(gerber::CorpusGenerator::generate(options));
+    const auto     compact = gerber::CompactFile(file);
+    const auto&    nodes   = file.getNodes();
+    REQUIRE(nodes.size() > 10 * gerber::CompactFile::checkpoint_interval);
+
+    for (std::size_t index = 0; index < nodes.size(); index += 97) {
+        REQUIRE(write_node(compact.at(index)) == write_node(nodes[index]));
+    }
+    REQUIRE(write_node(compact.at(nodes.size() - 1)) == "M02*\n");
+    REQUIRE_THROWS_AS(compact.at(nodes.size()), std::out_of_range);
+
+    REQUIRE(gerber::Writer().write(compact.decode()) == gerber::Writer().write(file));
+    // Coordinates of synthetic files change by at most a few millimeters.
+    REQUIRE(compact.memory_usage() * 8 < file.memory_usage());
+}
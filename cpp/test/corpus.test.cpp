@@ -0,0 +1,60 @@
+#include "gerber/gerber.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <sstream>
+#include <string>
+
+TEST_CASE("Generated corpus is deterministic and parses", "[corpus]") {
+    gerber::CorpusOptions options;
+    options.seed         = 7;
+    options.target_bytes = 256 * 1024;
+
+    const auto source = gerber::CorpusGenerator::generate(options);
+    REQUIRE(source == gerber::CorpusGenerator::generate(options));
+    REQUIRE(source.size() >= options.target_bytes);
+    REQUIRE(source.size() < options.target_bytes * 2);
+    REQUIRE(source.ends_with("M02*\n"));
+
+    // Streamed output crosses flush threshold several times.
+    std::ostringstream stream;
+    gerber::CorpusGenerator::generate(options, stream);
+    REQUIRE(stream.str() == source);
+
+    options.seed = 8;
+    REQUIRE(gerber::CorpusGenerator::generate(options) != source);
+
+    for (const auto* command : {"D01*", "D03*", "G36*", "G02*", "G03*", "%LPC*%", "%AM", "G04"}) {
+        REQUIRE(source.find(command) != std::string::npos);
+    }
+
+    gerber::Parser parser;
+    const auto     file  = parser.parse(source);
+    const auto     image = gerber::Interpreter::interpret(file);
+    REQUIRE(image.features.size() > 1000);
+}
+
+TEST_CASE("Generated corpus respects disabled blocks", "[corpus]") {
+    gerber::CorpusOptions options;
+    options.target_bytes = 64 * 1024;
+    options.tracks       = 0;
+    options.pours        = 0;
+    options.arcs         = 0;
+    options.clears       = 0;
+    options.comments     = 0;
+    options.macros       = 0;
+
+    const auto source = gerber::CorpusGenerator::generate(options);
+    REQUIRE(source.find("D01*") == std::string::npos);
+    REQUIRE(source.find("G36*") == std::string::npos);
+    REQUIRE(source.find("%AM") == std::string::npos);
+    REQUIRE(source.find("D03*") != std::string::npos);
+
+    // Only header remains.
+    options.pads      = 0;
+    options.apertures = 1;
+    const auto header = gerber::CorpusGenerator::generate(options);
+    REQUIRE(header.starts_with("G04 Synthetic corpus, seed 1*\n%FSLAX46Y46*%\n%MOMM*%\n%ADD10C,"));
+    REQUIRE(header.ends_with("*%\nM02*\n"));
+    REQUIRE(std::count(header.begin(), header.end(), '\n') == 5);
+}
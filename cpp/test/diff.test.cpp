@@ -0,0 +1,166 @@
+#include "gerber/gerber.hpp"
+#include "helpers.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    gerber::Image interpret(const std::string& body) {
+        gerber::Parser parser;
+        return gerber::Interpreter::interpret(
+            parser.parse(helpers::source("%ADD10C,0.5*%\n%ADD11R,1X2*%\n" + body))
+        );
+    }
+
+    gerber::Feature flash(int32_t aperture, double x, double y) {
+        const gerber::Point point{x, y};
+        return gerber::Feature{
+            gerber::Feature::FLASH,
+            gerber::Polarity::DARK,
+            aperture,
+            gerber::Segment{gerber::Segment::LINE, true, point, point, point},
+            0,
+            0,
+        };
+    }
+} // namespace
+
+TEST_CASE("Diff ignores order of features and direction of draws", "[diff]") {
+    const auto before = interpret(R"(
+        D10*
+        X0Y0D02*
+        G01*
+        X1000000Y0D01*
+        D11*
+        X5000000Y5000000D03*
+        G36*
+        X0Y0D02*
+        X1000000D01*
+        Y1000000D01*
+        G37*
+    )");
+    const auto after  = interpret(R"(
+        G36*
+        X0Y0D02*
+        G01*
+        X1000000D01*
+        Y1000000D01*
+        G37*
+        D11*
+        X5000000Y5000000D03*
+        D10*
+        X1000000Y0D02*
+        X0Y0D01*
+    )");
+
+    const auto diff = gerber::Differ::diff(before, after);
+    REQUIRE(diff.empty());
+    REQUIRE(diff.unchanged == 3);
+    REQUIRE(diff.added_bounds.empty);
+}
+
+TEST_CASE("Diff ignores start vertex and direction of contours", "[diff]") {
+    const auto before = interpret(R"(
+        G01*
+        G36*
+        X0Y0D02*
+        X1000000D01*
+        Y1000000D01*
+        X0D01*
+        Y0D01*
+        G37*
+    )");
+    const auto after  = interpret(R"(
+        G01*
+        G36*
+        X1000000Y1000000D02*
+        X1000000Y0D01*
+        X0D01*
+        Y1000000D01*
+        X1000000D01*
+        G37*
+    )");
+
+    const auto diff = gerber::Differ::diff(before, after);
+    REQUIRE(diff.empty());
+    REQUIRE(diff.unchanged == 1);
+}
+
+TEST_CASE("Diff reports added, removed and moved features", "[diff]") {
+    gerber::Image before;
+    before.apertures = {
+        {gerber::Aperture::CIRCLE, 0.5, 0.5, 0, 0, 0},
+        {gerber::Aperture::RECTANGLE, 1, 2, 0, 0, 0},
+    };
+    gerber::Image after = before;
+
+    before.features = {flash(0, 0, 0), flash(0, 10, 0), flash(1, 20, 0), flash(1, 30, 0)};
+    // Nudged within tolerance, moved, replaced by other aperture, moved too far.
+    after.features = {
+        flash(0, 0, 1e-9), flash(0, 10.5, 0), flash(0, 20, 0), flash(1, 40, 0), flash(1, 50, 0)
+    };
+
+    gerber::DiffOptions options;
+    options.move_radius = 1.0;
+    const auto diff     = gerber::Differ::diff(before, after, options);
+
+    REQUIRE(diff.unchanged == 1);
+    REQUIRE(diff.moved.size() == 1);
+    REQUIRE(diff.moved[0].before == 1);
+    REQUIRE(diff.moved[0].after == 1);
+    REQUIRE(diff.moved[0].offset.x == Approx(0.5));
+    REQUIRE(diff.moved[0].offset.y == Approx(0));
+    REQUIRE(diff.removed == std::vector<uint32_t>{2, 3});
+    REQUIRE(diff.added == std::vector<uint32_t>{2, 3, 4});
+
+    REQUIRE(diff.moved_bounds.min.x == Approx(9.75));
+    REQUIRE(diff.moved_bounds.max.x == Approx(10.75));
+    REQUIRE(diff.removed_bounds.max.x == Approx(30 + std::hypot(1, 2) / 2));
+    REQUIRE(diff.added_bounds.min.x == Approx(19.75));
+
+    options.move_radius = 0;
+    REQUIRE(gerber::Differ::diff(before, after, options).moved.empty());
+}
+
+TEST_CASE("Diff result doesn't depend on threads", "[diff]") {
+    gerber::Image before;
+    before.apertures = {
+        {gerber::Aperture::CIRCLE, 0.5, 0.5, 0, 0, 0},
+        {gerber::Aperture::CIRCLE, 0.3, 0.3, 0, 0, 0},
+    };
+    gerber::Image after = before;
+
+    std::mt19937 random(42);
+    for (int i = 0; i < 100000; i++) {
+        before.features.push_back(flash(i % 2, (i % 1000) * 2.0, (i / 1000) * 2.0));
+    }
+    after.features = before.features;
+    for (int i = 0; i < 1000; i++) {
+        after.features[random() % after.features.size()].segment.end.x += 0.25;
+    }
+    after.features.erase(after.features.begin() + 500, after.features.begin() + 600);
+    after.features.push_back(flash(0, -10, -10));
+    std::shuffle(after.features.begin(), after.features.end(), random);
+
+    gerber::DiffOptions single;
+    single.threads = 1;
+    gerber::DiffOptions parallel;
+    parallel.threads = 8;
+
+    const auto expected = gerber::Differ::diff(before, after, single);
+    const auto actual   = gerber::Differ::diff(before, after, parallel);
+
+    REQUIRE(expected.removed.size() == 100);
+    REQUIRE(expected.added.size() == 1);
+    REQUIRE(expected.unchanged + expected.moved.size() + expected.removed.size() == 100000);
+    REQUIRE(actual.removed == expected.removed);
+    REQUIRE(actual.added == expected.added);
+    REQUIRE(actual.unchanged == expected.unchanged);
+    REQUIRE(actual.moved.size() == expected.moved.size());
+    REQUIRE(actual.removed_bounds == expected.removed_bounds);
+}
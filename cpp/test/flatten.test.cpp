@@ -0,0 +1,168 @@
+#include "gerber/gerber.hpp"
+#include "helpers.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <string>
+#include <vector>
+
+namespace {
+    using helpers::square;
+
+    std::vector<gerber::Polygon>
+    flatten(const std::string& body, const gerber::FlattenOptions& options = {}) {
+        gerber::Parser parser;
+        const auto     file = parser.parse(helpers::source(body));
+        return gerber::Flattener::flatten(gerber::Interpreter::interpret(file), options);
+    }
+
+    double total_area(const std::vector<gerber::Polygon>& polygons) {
+        double area = 0;
+        for (const auto& polygon : polygons) {
+            area += polygon.area();
+        }
+        return area;
+    }
+} // namespace
+
+TEST_CASE("Flatten overlapping dark regions into one polygon", "[flatten]") {
+    const auto polygons = flatten(square(0, 0, 10) + square(5, 5, 10));
+
+    REQUIRE(polygons.size() == 1);
+    REQUIRE(polygons[0].holes.empty());
+    // Two 10x10 squares overlapping in 5x5, union outline has 8 vertices.
+    REQUIRE(polygons[0].outer.size() == 8);
+    REQUIRE(polygons[0].area() == Approx(175));
+
+    const auto apart = flatten(square(0, 0, 10) + square(20, 0, 10));
+    REQUIRE(apart.size() == 2);
+    REQUIRE(total_area(apart) == Approx(200));
+}
+
+TEST_CASE("Flatten clear polarity into holes", "[flatten]") {
+    const auto polygons = flatten(square(0, 0, 10) + "%LPC*%" + square(3, 3, 4) + "%LPD*%");
+
+    REQUIRE(polygons.size() == 1);
+    REQUIRE(polygons[0].outer.size() == 4);
+    REQUIRE(polygons[0].holes.size() == 1);
+    REQUIRE(polygons[0].holes[0].size() == 4);
+    REQUIRE(polygons[0].area() == Approx(84));
+
+    // Last feature wins, dark drawn over clear fills part of the hole again.
+    const auto refilled = flatten(
+        square(0, 0, 10) + "%LPC*%" + square(3, 3, 4) + "%LPD*%" + square(4, 4, 2)
+    );
+    REQUIRE(refilled.size() == 2);
+    REQUIRE(total_area(refilled) == Approx(88));
+
+    // Clear before dark has nothing to erase.
+    const auto nothing_erased = flatten("%LPC*%" + square(3, 3, 4) + "%LPD*%" + square(0, 0, 10));
+    REQUIRE(nothing_erased.size() == 1);
+    REQUIRE(nothing_erased[0].holes.empty());
+    REQUIRE(nothing_erased[0].area() == Approx(100));
+
+    // Clear covering all dark features erases everything.
+    REQUIRE(flatten(square(0, 0, 10) + "%LPC*%" + square(-1, -1, 12)).empty());
+}
+
+TEST_CASE("Flatten flashes and draws", "[flatten]") {
+    gerber::FlattenOptions options;
+    options.tolerance = 0.0001;
+
+    const auto flashes = flatten(
+        R"(
+        %ADD10C,2X1*%
+        %ADD11R,2X1*%
+        D10*
+        X0Y0D03*
+        D11*
+        X10000000Y0D03*
+    )",
+        options
+    );
+    REQUIRE(flashes.size() == 2);
+    for (const auto& polygon : flashes) {
+        if (polygon.holes.empty()) {
+            REQUIRE(polygon.area() == Approx(2));
+        } else {
+            REQUIRE(polygon.area() == Approx(std::numbers::pi * 0.75).epsilon(0.001));
+        }
+    }
+
+    // Line drawn with circular aperture is a stadium.
+    const auto draw = flatten(
+        R"(
+        %ADD10C,1*%
+        D10*
+        X0Y0D02*
+        G01*
+        X10000000Y0D01*
+    )",
+        options
+    );
+    REQUIRE(draw.size() == 1);
+    REQUIRE(draw[0].holes.empty());
+    REQUIRE(draw[0].area() == Approx(10 + std::numbers::pi / 4).epsilon(0.001));
+}
+
+TEST_CASE("Flatten result doesn't depend on tiles", "[flatten]") {
+    std::string body = "%ADD10C,0.5*%D10*";
+    for (int i = 0; i < 20; i++) {
+        body += square(i * 3, i % 4, 4);
+        body += "X" + std::to_string(i * 3000000) + "Y-5000000D02*X" +
+                  std::to_string(i * 3000000 + 6000000) + "Y20000000D01*";
+        if (i % 3 == 0) {
+            body += "%LPC*%" + square(i * 3 + 1, 1, 1) + "%LPD*%";
+        }
+    }
+
+    gerber::FlattenOptions single;
+    single.tiles = 1;
+    gerber::FlattenOptions tiled;
+    tiled.tiles   = 8;
+    tiled.threads = 4;
+
+    const auto expected = flatten(body, single);
+    const auto actual   = flatten(body, tiled);
+    REQUIRE(total_area(actual) == Approx(total_area(expected)));
+
+    size_t expected_holes = 0;
+    size_t actual_holes   = 0;
+    for (const auto& polygon : expected) {
+        expected_holes += polygon.holes.size();
+    }
+    for (const auto& polygon : actual) {
+        actual_holes += polygon.holes.size();
+    }
+    REQUIRE(actual.size() == expected.size());
+    REQUIRE(actual_holes == expected_holes);
+}
+
+TEST_CASE("Flatten generated corpus to the area of its raster", "[flatten]") {
+    gerber::CorpusOptions options;
+    options.board_width  = 40;
+    options.board_height = 30;
+    options.arcs         = 0;
+    options.comments     = 0;
+
+    SECTION("45 degree tracks") {
+        options.seed         = 3;
+        options.target_bytes = 8 * 1024;
+        options.pads         = 0;
+        options.pours        = 0;
+        options.clears       = 0;
+    }
+    SECTION("Tracks, pads, pours and clear pads") {
+        options.seed          = 5;
+        options.target_bytes  = 16 * 1024;
+        options.apertures     = 20;
+        options.pour_vertices = 50;
+    }
+
+    const auto image    = helpers::generated(options);
+    const auto polygons = gerber::Flattener::flatten(image);
+    REQUIRE(!polygons.empty());
+    REQUIRE(total_area(polygons) == Approx(helpers::raster_area(image, 0.01)).epsilon(0.002));
+}
@@ -0,0 +1,164 @@
+#pragma once
+#include "gerber/gerber.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+#include <string>
+#include <vector>
+
+// Sources and reference geometry shared by tests.
+namespace helpers {
+    /**
+     * Complete file in 2.6 format and millimeters, body goes between the header and M02.
+     */
+    inline std::string source(const std::string& body) {
+        return "%FSLAX26Y26*%\n%MOMM*%\n" + body + "M02*\n";
+    }
+
+    /**
+     * G36/G37 region of axis aligned rectangle, coordinates in whole millimeters.
+     */
+    inline std::string rectangle(int x, int y, int width, int height) {
+        const auto coordinate = [](int value) {
+            return std::to_string(value * 1000000);
+        };
+        return "G36*X" + coordinate(x) + "Y" + coordinate(y) + "D02*G01*X" + coordinate(x + width) +
+               "D01*Y" + coordinate(y + height) + "D01*X" + coordinate(x) + "D01*Y" +
+               coordinate(y) + "D01*G37*\n";
+    }
+
+    inline std::string square(int x, int y, int size) {
+        return rectangle(x, y, size, size);
+    }
+
+    inline gerber::Image generated(const gerber::CorpusOptions& options) {
+        gerber::Parser parser;
+        const auto     file = parser.parse(gerber::CorpusGenerator::generate(options));
+        return gerber::Interpreter::interpret(file);
+    }
+
+    inline double
+    distance_to_segment(const gerber::Point& p, const gerber::Point& a, const gerber::Point& b) {
+        const double dx     = b.x - a.x;
+        const double dy     = b.y - a.y;
+        const double length = dx * dx + dy * dy;
+        const double t =
+            length > 0 ? std::clamp(((p.x - a.x) * dx + (p.y - a.y) * dy) / length, 0.0, 1.0) : 0.0;
+        return std::hypot(p.x - a.x - t * dx, p.y - a.y - t * dy);
+    }
+
+    inline bool inside_aperture(const gerber::Aperture& aperture, double x, double y) {
+        const double w = aperture.width / 2;
+        const double h = aperture.height / 2;
+        if (aperture.hole > 0 && std::hypot(x, y) < aperture.hole / 2) {
+            return false;
+        }
+        switch (aperture.shape) {
+            case gerber::Aperture::CIRCLE:
+                return std::hypot(x, y) <= w;
+            case gerber::Aperture::RECTANGLE:
+                return std::abs(x) <= w && std::abs(y) <= h;
+            case gerber::Aperture::OBROUND: {
+                const double r = std::min(w, h);
+                return distance_to_segment({x, y}, {-(w - r), -(h - r)}, {w - r, h - r}) <= r;
+            }
+            case gerber::Aperture::POLYGON: {
+                const auto count = std::max<long>(3, std::lround(aperture.vertices));
+                for (long i = 0; i < count; i++) {
+                    const double a0 = aperture.rotation * std::numbers::pi / 180 +
+                                      2 * std::numbers::pi * i / count;
+                    const double a1 = a0 + 2 * std::numbers::pi / count;
+                    const double ax = w * std::cos(a0);
+                    const double ay = w * std::sin(a0);
+                    const double bx = w * std::cos(a1);
+                    const double by = w * std::sin(a1);
+                    if ((bx - ax) * (y - ay) - (by - ay) * (x - ax) < 0) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline bool
+    inside_region(const gerber::Image& image, const gerber::Feature& feature, double x, double y) {
+        bool inside = false;
+        for (uint32_t i = 0; i < feature.contour_size; i++) {
+            const auto& segment = image.contours[feature.contour_begin + i];
+            const auto& a       = segment.start;
+            const auto& b       = segment.end;
+            if ((a.y > y) != (b.y > y) && x < (b.x - a.x) * (y - a.y) / (b.y - a.y) + a.x) {
+                inside = !inside;
+            }
+        }
+        return inside;
+    }
+
+    /**
+     * Copper area of straight draws, flashes and regions with straight contours, sampled
+     * at centers of a grid of square cells. Features paint cells within their bounding
+     * box in order, independently of Flattener.
+     */
+    inline double raster_area(const gerber::Image& image, double cell) {
+        gerber::BoundingBox bounds;
+        for (const auto& feature : image.features) {
+            const double margin = feature.aperture >= 0 ? image.apertures[feature.aperture].extent()
+                                                        : 0.0;
+            bounds.include(feature.segment, margin);
+            for (uint32_t i = 0; i < feature.contour_size; i++) {
+                bounds.include(image.contours[feature.contour_begin + i]);
+            }
+        }
+        const auto columns = static_cast<std::size_t>((bounds.max.x - bounds.min.x) / cell) + 1;
+        const auto rows    = static_cast<std::size_t>((bounds.max.y - bounds.min.y) / cell) + 1;
+        std::vector<bool> dark(columns * rows, false);
+
+        for (const auto& feature : image.features) {
+            gerber::BoundingBox box;
+            if (feature.kind == gerber::Feature::REGION) {
+                for (uint32_t i = 0; i < feature.contour_size; i++) {
+                    box.include(image.contours[feature.contour_begin + i]);
+                }
+            } else {
+                box.include(feature.segment, image.apertures[feature.aperture].extent());
+            }
+            const auto first_column = static_cast<std::size_t>((box.min.x - bounds.min.x) / cell);
+            const auto first_row    = static_cast<std::size_t>((box.min.y - bounds.min.y) / cell);
+            const auto last_column  = static_cast<std::size_t>((box.max.x - bounds.min.x) / cell);
+            const auto last_row     = static_cast<std::size_t>((box.max.y - bounds.min.y) / cell);
+            for (std::size_t row = first_row; row <= last_row && row < rows; row++) {
+                for (std::size_t column = first_column; column <= last_column && column < columns;
+                     column++) {
+                    const double x      = bounds.min.x + (column + 0.5) * cell;
+                    const double y      = bounds.min.y + (row + 0.5) * cell;
+                    bool         inside = false;
+                    switch (feature.kind) {
+                        case gerber::Feature::DRAW:
+                            inside = distance_to_segment(
+                                         {x, y}, feature.segment.start, feature.segment.end
+                                     ) <= image.apertures[feature.aperture].width / 2;
+                            break;
+                        case gerber::Feature::FLASH:
+                            inside = inside_aperture(
+                                image.apertures[feature.aperture],
+                                x - feature.segment.end.x,
+                                y - feature.segment.end.y
+                            );
+                            break;
+                        case gerber::Feature::REGION:
+                            inside = inside_region(image, feature, x, y);
+                            break;
+                    }
+                    if (inside) {
+                        dark[row * columns + column] = feature.polarity == gerber::Polarity::DARK;
+                    }
+                }
+            }
+        }
+        return static_cast<double>(std::count(dark.begin(), dark.end(), true)) * cell * cell;
+    }
+} // namespace helpers
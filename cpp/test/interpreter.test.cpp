@@ -0,0 +1,93 @@
+#include "gerber/gerber.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE("Interpret lines and flashes", "[interpreter]") {
+    gerber::Parser parser;
+    auto           file  = parser.parse(R"(
+        %FSLAX24Y24*%
+        %MOIN*%
+        %ADD10C,0.5*%
+        %ADD11C,0.5*%
+        D10*
+        X10000Y10000D02*
+        X20000D01*
+        %LPC*%
+        D11*
+        Y20000D03*
+        M02*
+    )");
+    auto           image = gerber::Interpreter::interpret(file);
+
+    REQUIRE(image.apertures.size() == 1);
+    REQUIRE(image.apertures[0].shape == gerber::Aperture::CIRCLE);
+    REQUIRE(image.apertures[0].width == Approx(12.7));
+
+    REQUIRE(image.features.size() == 2);
+
+    const auto& line = image.features[0];
+    REQUIRE(line.kind == gerber::Feature::DRAW);
+    REQUIRE(line.polarity == gerber::Polarity::DARK);
+    REQUIRE(line.segment.kind == gerber::Segment::LINE);
+    REQUIRE(line.segment.start.x == Approx(25.4));
+    REQUIRE(line.segment.start.y == Approx(25.4));
+    REQUIRE(line.segment.end.x == Approx(50.8));
+    REQUIRE(line.segment.end.y == Approx(25.4));
+
+    const auto& flash = image.features[1];
+    REQUIRE(flash.kind == gerber::Feature::FLASH);
+    REQUIRE(flash.polarity == gerber::Polarity::CLEAR);
+    REQUIRE(flash.aperture == 0);
+    REQUIRE(flash.segment.end.x == Approx(50.8));
+    REQUIRE(flash.segment.end.y == Approx(50.8));
+}
+
+TEST_CASE("Interpret single quadrant arc", "[interpreter]") {
+    gerber::Parser parser;
+    auto           file  = parser.parse(R"(
+        %FSLAX26Y26*%
+        %MOMM*%
+        %ADD10C,0.1*%
+        D10*
+        G74*
+        X1000000Y0D02*
+        G03*
+        X0Y1000000I1000000J0D01*
+    )");
+    auto           image = gerber::Interpreter::interpret(file);
+
+    REQUIRE(image.features.size() == 1);
+    const auto& arc = image.features[0].segment;
+    REQUIRE(arc.kind == gerber::Segment::ARC_CCW);
+    REQUIRE_FALSE(arc.multi_quadrant);
+    REQUIRE(arc.center.x == Approx(0.0));
+    REQUIRE(arc.center.y == Approx(0.0));
+}
+
+TEST_CASE("Interpret region", "[interpreter]") {
+    gerber::Parser parser;
+    auto           file  = parser.parse(R"(
+        %FSLAX26Y26*%
+        %MOMM*%
+        G36*
+        X0Y0D02*
+        X1000000D01*
+        Y1000000D01*
+        X0D01*
+        Y0D01*
+        G37*
+    )");
+    auto           image = gerber::Interpreter::interpret(file);
+
+    REQUIRE(image.features.size() == 1);
+    REQUIRE(image.features[0].kind == gerber::Feature::REGION);
+    REQUIRE(image.features[0].contour_size == 4);
+    REQUIRE(image.contours.size() == 4);
+}
+
+TEST_CASE("Interpret undefined aperture", "[interpreter]") {
+    gerber::Parser parser;
+    auto           file = parser.parse("%FSLAX26Y26*%D10*");
+
+    REQUIRE_THROWS_AS(gerber::Interpreter::interpret(file), gerber::InterpreterError);
+}
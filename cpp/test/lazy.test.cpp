@@ -0,0 +1,78 @@
+#include "gerber/gerber.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    std::shared_ptr<const std::string> corpus() {
+        gerber::CorpusOptions options;
+        options.target_bytes = 256 * 1024;
+        return std::make_shared<const std::string>(gerber::CorpusGenerator::generate(options));
+    }
+} // namespace
+
+TEST_CASE("Lazy file decodes only accessed commands", "[lazy]") {
+    const gerber::LazyFile file(corpus());
+    REQUIRE(file.size() > 1000);
+
+    std::size_t apertures = 0;
+    for (std::size_t index = 0; index < file.size(); index++) {
+        const auto code = file.getCode(index);
+        if (code == "FS" || code == "MO" || code == "AD") {
+            const auto& nodes = file.getNodes(index);
+            REQUIRE(nodes.size() == 1);
+            REQUIRE(nodes[0]->getNodeName().starts_with(std::string(code)));
+            apertures += code == "AD";
+        }
+    }
+    REQUIRE(apertures == 100);
+    REQUIRE(file.getCode(0) == "G04");
+    REQUIRE(file.getCode(file.size() - 1) == "M02");
+    REQUIRE_FALSE(file.isDecoded(0));
+    REQUIRE_FALSE(file.isDecoded(file.size() - 1));
+    REQUIRE(file.isDecoded(1));
+}
+
+TEST_CASE("Lazy file decodes the same nodes as parser", "[lazy]") {
+    const auto source = corpus();
+    for (const bool split_operations : {false, true}) {
+        const gerber::ParserOptions options{.split_operations = split_operations};
+        const gerber::LazyFile      lazy(source, options);
+
+        // Commands are decoded concurrently, each exactly once.
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < 4; thread++) {
+            threads.emplace_back([&]() {
+                for (std::size_t index = 0; index < lazy.size(); index++) {
+                    lazy.getNodes(index);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        const auto expected = gerber::Parser(options).parse(*source);
+        const auto actual   = lazy.decode();
+        REQUIRE(actual.getNodes().size() == expected.getNodes().size());
+        REQUIRE(gerber::Writer().write(actual) == gerber::Writer().write(expected));
+        REQUIRE(actual.getNodes()[5] == lazy.getNodes(5)[0]);
+    }
+}
+
+TEST_CASE("Lazy file reports syntax errors on access", "[lazy]") {
+    const auto source = std::make_shared<const std::string>("G01*\nX1Y1D01*\n%MOXX*%\nM02*\n");
+    const gerber::LazyFile file(source);
+
+    REQUIRE(file.size() == 4);
+    REQUIRE(file.getSpan(2) == gerber::Span{14, 21});
+    REQUIRE(file.getCode(2) == "MO");
+    REQUIRE(file.getNodes(3).size() == 1);
+    REQUIRE_THROWS_AS(file.getNodes(2), gerber::SyntaxError);
+    REQUIRE_FALSE(file.isDecoded(2));
+    REQUIRE_THROWS_AS(file.decode(), gerber::SyntaxError);
+}
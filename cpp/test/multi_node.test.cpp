@@ -1,6 +1,10 @@
 #include "gerber/gerber.hpp"
 #include <catch2/catch_all.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
 
 TEST_CASE("Basic Gerber #0", "[multi_node]") {
     gerber::Parser parser;
@@ -16,6 +20,64 @@ TEST_CASE("Basic Gerber #0", "[multi_node]") {
     auto           result        = parser.parse(gerber_source);
     const auto&    nodes         = result.getNodes();
 
-    REQUIRE(nodes.size() == 11);
+    REQUIRE(nodes.size() == 7);
     // Additional checks can be added here based on the expected nodes
-}
\ No newline at end of file
+}
+
+TEST_CASE("Basic Gerber #0 with split operations", "[multi_node]") {
+    gerber::Parser parser(gerber::ParserOptions{.split_operations = true});
+    auto           gerber_source = R"(
+        %FSLAX24Y24*%
+        %MOIN*%
+        %ADD10C,0.5*%
+        D10*
+        X100000Y100000D02*
+        X200000Y200000D01*
+        M02*
+    )";
+    auto           result        = parser.parse(gerber_source);
+    const auto&    nodes         = result.getNodes();
+
+    REQUIRE(nodes.size() == 11);
+}
+
+TEST_CASE("Shared parser used from many threads", "[multi_node]") {
+    const gerber::Parser parser;
+    auto                 gerber_source = std::string(R"(
+        %FSLAX24Y24*%
+        %MOIN*%
+        %ADD10C,0.5*%
+        %ADD11R,0.5X0.25*%
+        D10*
+        X100000Y100000D02*
+        X200000Y200000D01*
+        D11*
+        G04 flash*
+        X300000D03*
+        M02*
+    )");
+    const auto           expected      = parser.parse(gerber_source).getNodes().size();
+
+    constexpr int            thread_count     = 8;
+    constexpr int            parses_per_thread = 200;
+    std::vector<std::size_t> failures(thread_count, 0);
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < thread_count; t++) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < parses_per_thread; i++) {
+                if (parser.parse(gerber_source).getNodes().size() != expected) {
+                    failures[t]++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(expected == 11);
+    for (const auto count : failures) {
+        REQUIRE(count == 0);
+    }
+}
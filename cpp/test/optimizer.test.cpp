@@ -0,0 +1,100 @@
+#include "gerber/gerber.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE("Optimize redundant modal commands", "[optimizer]") {
+    gerber::Parser    parser;
+    gerber::Optimizer optimizer;
+    gerber::Writer    writer;
+    auto              file      = parser.parse(R"(
+        %FSLAX26Y26*%
+        %MOMM*%
+        %LPD*%
+        %ADD10C,0.5*%
+        %ADD11C,0.5*%
+        %ADD12R,0.5X0.5*%
+        D10*
+        G01*
+        X0Y0D02*
+        G01*
+        X1000000Y0D01*
+        D11*
+        G01*
+        X1000000Y1000000D01*
+        D12*
+        X1000000Y1000000D02*
+        X2000000Y1000000D03*
+        %MOMM*%
+        M02*
+    )");
+    auto              optimized = optimizer.optimize(file);
+
+    REQUIRE(optimized.getNodes().size() < file.getNodes().size());
+    REQUIRE(gerber::Interpreter::interpret(optimized) == gerber::Interpreter::interpret(file));
+    REQUIRE(
+        writer.write(optimized) == "%FSLAX26Y26*%\n"
+                                   "%MOMM*%\n"
+                                   "%ADD10C,0.5*%\n"
+                                   "%ADD12R,0.5X0.5*%\n"
+                                   "D10*\n"
+                                   "G01*\n"
+                                   "X0Y0D02*\n"
+                                   "X1000000D01*\n"
+                                   "Y1000000D01*\n"
+                                   "D12*\n"
+                                   "X2000000D03*\n"
+                                   "M02*\n"
+    );
+}
+
+TEST_CASE("Optimize keeps redefined apertures", "[optimizer]") {
+    gerber::Parser    parser;
+    gerber::Optimizer optimizer;
+    auto              file      = parser.parse(R"(
+        %FSLAX26Y26*%
+        %MOMM*%
+        %ADD10C,0.5*%
+        %ADD11C,0.5*%
+        D11*
+        X0Y0D03*
+        %ADD10C,0.7*%
+        D10*
+        X0Y0D03*
+    )");
+    auto              optimized = optimizer.optimize(file);
+
+    REQUIRE(gerber::Interpreter::interpret(optimized) == gerber::Interpreter::interpret(file));
+}
+
+TEST_CASE("Optimize keeps moves inside regions", "[optimizer]") {
+    gerber::Parser    parser;
+    gerber::Optimizer optimizer;
+    auto              file      = parser.parse(R"(
+        %FSLAX26Y26*%
+        %MOMM*%
+        G36*
+        X0Y0D02*
+        X1000000D01*
+        Y1000000D01*
+        X0Y0D01*
+        D02*
+        X5000000D01*
+        Y5000000D01*
+        X0Y0D01*
+        G37*
+    )");
+    auto              optimized = optimizer.optimize(file);
+
+    REQUIRE(gerber::Interpreter::interpret(optimized) == gerber::Interpreter::interpret(file));
+    REQUIRE(gerber::Interpreter::interpret(optimized).features.size() == 2);
+}
+
+TEST_CASE("Optimize keeps unit mode changed by G70", "[optimizer]") {
+    gerber::Parser    parser;
+    gerber::Optimizer optimizer;
+    gerber::Writer    writer;
+    auto              file      = parser.parse("%MOMM*%G70*%MOMM*%%ADD10C,0.5*%G71*%MOMM*%");
+    auto              optimized = optimizer.optimize(file);
+
+    REQUIRE(writer.write(optimized) == "%MOMM*%\nG70*\n%MOMM*%\n%ADD10C,0.5*%\nG71*\n");
+}
@@ -0,0 +1,131 @@
+#include "gerber/gerber.hpp"
+#include "helpers.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+    std::shared_ptr<const gerber::File> board() {
+        return std::make_shared<const gerber::File>(gerber::Parser().parse(helpers::source(R"(
+            %ADD10C,0.5*%
+            %ADD11R,1X2*%
+            D10*
+            X0Y0D02*
+            G01*
+            X5000000Y0D01*
+            G03*
+            X0Y5000000I-5000000J0D01*
+            G01*
+            D11*
+            X2000000Y2000000D03*
+            %LPC*%
+            G36*
+            X1000000Y1000000D02*
+            X1500000D01*
+            Y1500000D01*
+            X1000000D01*
+            Y1000000D01*
+            G37*
+        )")));
+    }
+
+    std::size_t count(const std::string& text, const std::string& pattern) {
+        std::size_t result = 0;
+        for (auto found = text.find(pattern); found != std::string::npos;
+             found      = text.find(pattern, found + 1)) {
+            result++;
+        }
+        return result;
+    }
+} // namespace
+
+TEST_CASE("Panel places shared layers without copying them", "[panel]") {
+    const auto    layer = board();
+    gerber::Panel panel;
+    const auto    index = panel.addLayer(layer);
+    panel.placeGrid(index, 6, 8, 10, 10);
+
+    REQUIRE(panel.getInstances().size() == 48);
+    REQUIRE(&panel.getLayer(index) == layer.get());
+    REQUIRE(layer.use_count() == 2);
+
+    const auto bounds = panel.getBounds(7);
+    // Arcs are bounded by their whole circle.
+    REQUIRE(bounds.min.x == Approx(4.75));
+    REQUIRE(bounds.min.y == Approx(4.75));
+    REQUIRE(bounds.max.x == Approx(15.25));
+    REQUIRE(bounds.max.y == Approx(15.25));
+    REQUIRE(panel.getBounds().max.x == Approx(55.25));
+
+    const auto found = panel.query(gerber::BoundingBox{{14.9, 24.9}, {15, 25}, false});
+    REQUIRE(found == std::vector<std::size_t>{13, 14, 19, 20});
+    REQUIRE(panel.query(gerber::BoundingBox{{100, 100}, {101, 101}, false}).empty());
+
+    REQUIRE_THROWS_AS(panel.place(1, gerber::AffineTransform()), std::out_of_range);
+    REQUIRE_THROWS_AS(
+        panel.place(index, gerber::AffineTransform{1, 0, 0, 2, 0, 0}), std::invalid_argument
+    );
+}
+
+TEST_CASE("Panel writes grids as step and repeat blocks", "[panel]") {
+    gerber::Panel panel;
+    const auto    first  = panel.addLayer(board());
+    const auto    second = panel.addLayer(board());
+    panel.placeGrid(first, 3, 2, 12, 8);
+    panel.place(
+        second,
+        gerber::AffineTransform::rotate(90).then(gerber::AffineTransform::translate(60, 0))
+    );
+    panel.place(second, gerber::AffineTransform::translate(80, 0));
+    panel.place(second, gerber::AffineTransform::translate(90, 3));
+    panel.place(second, gerber::AffineTransform::translate(100, 0));
+
+    gerber::PanelWriteOptions options;
+    options.step_repeat = true;
+    const auto output   = panel.write(options);
+    REQUIRE(output.starts_with("%FSLAX46Y46*%\n%MOMM*%\n%ADD10C,0.5*%\n%ADD11R,1X2*%\n"));
+    REQUIRE(count(output, "%SRX3Y2I12J8*%\n") == 1);
+    REQUIRE(count(output, "%SR*%\n") == 1);
+    // Grid is written once, the other layer is not a grid and is rotated once.
+    REQUIRE(count(output, "D03*") == 5);
+    REQUIRE(count(output, "%ADD") == 6);
+    REQUIRE(output.find("%ADD13R,2X1*%") != std::string::npos);
+    REQUIRE(output.ends_with("M02*\n"));
+
+    gerber::Panel small;
+    small.placeGrid(small.addLayer(board()), 2, 1, 0.00001, 0);
+    REQUIRE(count(small.write(options), "%SRX2Y1I0.00001J0*%\n") == 1);
+}
+
+TEST_CASE("Panel expanded output matches flattened instances", "[panel]") {
+    gerber::Panel panel;
+    const auto    layer = panel.addLayer(board());
+    panel.placeGrid(layer, 2, 2, 12, 8);
+    panel.place(
+        layer,
+        gerber::AffineTransform::rotate(90)
+            .then(gerber::AffineTransform::mirror_y())
+            .then(gerber::AffineTransform::translate(40, 20))
+    );
+
+    // Default output has no step and repeat blocks, so it can be parsed back.
+    const auto output = panel.write();
+    REQUIRE(count(output, "%SR") == 0);
+
+    const auto file = gerber::Parser().parse(output);
+    REQUIRE(gerber::Validator::validate(file).empty());
+    REQUIRE(gerber::Interpreter::interpret(file).features.size() == 5 * 4);
+
+    gerber::FlattenOptions flatten_options;
+    flatten_options.tolerance = 1e-5;
+    const auto expected       = gerber::Flattener::flatten(
+        gerber::Interpreter::interpret(file), flatten_options
+    );
+    REQUIRE(
+        gerber::RasterComparator::compare(expected, panel.flatten(flatten_options)).identical()
+    );
+}
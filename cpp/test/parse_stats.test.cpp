@@ -0,0 +1,59 @@
+#include "gerber/gerber.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE("Collect parse stats", "[parse_stats]") {
+    gerber::Parser     parser;
+    gerber::ParseStats stats;
+    auto               gerber_source = R"(
+        G04 Hello*
+        %FSLAX24Y24*%
+        %MOMM*%
+        %ADD10C,0.5*%
+        %ADD11R,0.5X0.5*%
+        D10*
+        G36*
+        X0Y0D02*
+        X100D01*
+        Y100D01*
+        X0D01*
+        G37*
+        G36*
+        X0Y0D02*
+        X100D01*
+        G37*
+        M02*
+    )";
+    const auto         file          = parser.parse(gerber_source, stats);
+
+    REQUIRE(stats.bytes_scanned == std::string_view(gerber_source).size());
+    REQUIRE(stats.comment_bytes == 6);
+    REQUIRE(stats.aperture_count == 2);
+    REQUIRE(stats.largest_region == 3);
+
+    REQUIRE(stats.nodes.at("G36") == 2);
+    REQUIRE(stats.nodes.at("Operation") == 6);
+    REQUIRE(stats.nodes.at("ADC") == 1);
+
+    REQUIRE(stats.family_commands[gerber::ParseStats::G_CODE] == 5);
+    REQUIRE(stats.family_commands[gerber::ParseStats::D_CODE] == 1);
+    REQUIRE(stats.family_commands[gerber::ParseStats::M_CODE] == 1);
+    REQUIRE(stats.family_commands[gerber::ParseStats::OPERATION] == 6);
+    REQUIRE(stats.family_commands[gerber::ParseStats::EXTENDED] == 4);
+
+    REQUIRE(stats.total_time >= stats.scan_time);
+    REQUIRE(file.getNodes().size() == 17);
+}
+
+TEST_CASE("File memory usage", "[parse_stats]") {
+    gerber::Parser parser;
+    const auto     small = parser.parse("G04 x*");
+    const auto     large = parser.parse("G04 " + std::string(1000, 'x') + "*");
+
+    REQUIRE(small.memory_usage() >= sizeof(gerber::File) + sizeof(gerber::G04));
+    REQUIRE(large.memory_usage() >= small.memory_usage() + 1000);
+
+    gerber::ParseStats stats;
+    const auto         file = parser.parse("G04 x*G04 y*D10*X1Y2D01*", stats);
+    REQUIRE(stats.peak_bytes == file.memory_usage());
+}
@@ -0,0 +1,119 @@
+#include "gerber/gerber.hpp"
+#include "helpers.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    using helpers::rectangle;
+
+    gerber::File parse(const std::string& body) {
+        gerber::Parser parser;
+        return parser.parse(helpers::source("%ADD10C,1*%\n" + body));
+    }
+} // namespace
+
+TEST_CASE("Raster comparison ignores how geometry was constructed", "[raster]") {
+    const auto before = parse(rectangle(0, 0, 10, 10) + "D10*X5000000Y5000000D03*");
+    const auto after  = parse(
+        "D10*X5000000Y5000000D03*" + rectangle(5, 0, 5, 10) + rectangle(0, 0, 5, 5) +
+        rectangle(0, 5, 5, 5)
+    );
+
+    gerber::RasterOptions options;
+    options.resolution = 0.1;
+    options.tile_size  = 16;
+    const auto result  = gerber::RasterComparator::compare(before, after, options);
+
+    REQUIRE(result.identical());
+    REQUIRE(result.regions.empty());
+    REQUIRE(result.tiles == 49);
+    REQUIRE(result.identical_tiles == result.tiles);
+}
+
+TEST_CASE("Raster comparison reports differing regions", "[raster]") {
+    const auto before = parse(rectangle(0, 0, 10, 10));
+    const auto after  = parse(rectangle(0, 0, 10, 10) + "%LPC*%" + rectangle(3, 3, 4, 4));
+
+    gerber::RasterOptions options;
+    options.resolution = 0.1;
+    options.tile_size  = 16;
+    const auto result  = gerber::RasterComparator::compare(before, after, options);
+
+    REQUIRE_FALSE(result.identical());
+    // 4x4 mm hole at 0.1 mm per pixel.
+    REQUIRE(result.different_pixels == 1600);
+    REQUIRE(result.identical_tiles + result.regions.size() == result.tiles);
+
+    gerber::BoundingBox bounds;
+    for (const auto& region : result.regions) {
+        REQUIRE(region.bounds.min.x >= 3 - 1e-9);
+        REQUIRE(region.bounds.max.y <= 7 + 1e-9);
+        bounds.include(region.bounds);
+    }
+    REQUIRE(bounds.min.x == Approx(3));
+    REQUIRE(bounds.min.y == Approx(3));
+    REQUIRE(bounds.max.x == Approx(7));
+    REQUIRE(bounds.max.y == Approx(7));
+}
+
+TEST_CASE("Raster comparison doesn't depend on tiles and threads", "[raster]") {
+    const auto before = parse("D10*X0Y0D02*G01*X20000000Y3000000D01*" + rectangle(2, 5, 6, 4));
+    const auto after  = parse("D10*X0Y0D02*G01*X20000000Y3100000D01*" + rectangle(2, 5, 6, 5));
+
+    gerber::RasterOptions options;
+    options.resolution = 0.05;
+    options.tile_size  = 1000;
+    options.threads    = 1;
+    const auto expected = gerber::RasterComparator::compare(before, after, options);
+    REQUIRE(expected.different_pixels > 0);
+
+    options.tile_size = 7;
+    options.threads   = 4;
+    const auto actual = gerber::RasterComparator::compare(before, after, options);
+    REQUIRE(actual.different_pixels == expected.different_pixels);
+    REQUIRE(actual.regions.size() > expected.regions.size());
+
+    options.resolution = 0;
+    REQUIRE_THROWS_AS(
+        gerber::RasterComparator::compare(before, after, options), std::invalid_argument
+    );
+}
+
+TEST_CASE("Raster comparison of generated 45 degree tracks", "[raster]") {
+    gerber::CorpusOptions corpus;
+    corpus.seed         = 3;
+    corpus.target_bytes = 8 * 1024;
+    corpus.board_width  = 40;
+    corpus.board_height = 30;
+    corpus.pads         = 0;
+    corpus.pours        = 0;
+    corpus.arcs         = 0;
+    corpus.clears       = 0;
+    corpus.comments     = 0;
+    const auto source   = gerber::CorpusGenerator::generate(corpus);
+    // Without the last track, which starts with the last D02.
+    const auto last      = source.rfind('\n', source.rfind("D02*")) + 1;
+    const auto shortened = source.substr(0, last) + "M02*\n";
+
+    gerber::Parser parser;
+    const auto     empty = parser.parse(helpers::source(""));
+    const auto     before = parser.parse(source);
+    const auto     after  = parser.parse(shortened);
+
+    gerber::RasterOptions options;
+    options.resolution = 0.01;
+    const double pixel = options.resolution * options.resolution;
+    const double before_area =
+        helpers::raster_area(gerber::Interpreter::interpret(before), options.resolution);
+    const double after_area =
+        helpers::raster_area(gerber::Interpreter::interpret(after), options.resolution);
+
+    const auto copper = gerber::RasterComparator::compare(empty, before, options);
+    REQUIRE(copper.different_pixels * pixel == Approx(before_area).epsilon(0.002));
+
+    const auto removed = gerber::RasterComparator::compare(before, after, options);
+    REQUIRE_FALSE(removed.identical());
+    REQUIRE(removed.different_pixels * pixel == Approx(before_area - after_area).epsilon(0.05));
+}
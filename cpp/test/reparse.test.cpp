@@ -0,0 +1,123 @@
+#include "gerber/gerber.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    const std::string source = "%FSLAX26Y26*%\n"
+                               "%MOMM*%\n"
+                               "%ADD10C,0.5*%\n"
+                               "D10*\n"
+                               "X0Y0D02*\n"
+                               "G01*\n"
+                               "X1000000Y0D01*\n"
+                               "X1000000Y1000000D01*\n"
+                               "M02*\n";
+
+    /**
+     * Apply edit to file with reparse and check result against full parse.
+     */
+    gerber::NodeSplice edit(
+        const gerber::Parser& parser,
+        gerber::File&         file,
+        std::size_t           begin,
+        std::size_t           end,
+        const std::string&    text
+    ) {
+        std::string expected_source = *file.getSource();
+        expected_source.replace(begin, end - begin, text);
+
+        const auto splice   = parser.reparse(file, gerber::Span{begin, end}, text);
+        const auto expected = parser.parse(expected_source);
+
+        REQUIRE(*file.getSource() == expected_source);
+        REQUIRE(file.getSpans() == expected.getSpans());
+        REQUIRE(gerber::Writer().write(file) == gerber::Writer().write(expected));
+        return splice;
+    }
+} // namespace
+
+TEST_CASE("Reparse only commands touched by edit", "[reparse]") {
+    const gerber::Parser parser(gerber::ParserOptions{.incremental = true});
+    auto                 file = parser.parse(source);
+    REQUIRE(file.getSpans().size() == file.getNodes().size());
+    REQUIRE(file.getSpans()[3] == gerber::Span{36, 40});
+
+    // X1000000Y0D01* becomes X2000000Y0D01*.
+    const auto changed = edit(parser, file, 56, 57, "2");
+    REQUIRE(changed.first == 6);
+    REQUIRE(changed.removed == 1);
+    REQUIRE(changed.inserted == 1);
+
+    // New command between two others.
+    const auto inserted = edit(parser, file, 50, 50, "G75*\n");
+    REQUIRE(inserted.first == 5);
+    REQUIRE(inserted.removed == 0);
+    REQUIRE(inserted.inserted == 1);
+
+    // Command before removed whitespace is reparsed.
+    const auto whitespace = edit(parser, file, 40, 41, "");
+    REQUIRE(whitespace.removed == 1);
+    REQUIRE(whitespace.inserted == 1);
+
+    const auto removed = edit(parser, file, 0, 14, "");
+    REQUIRE(removed.first == 0);
+    REQUIRE(removed.removed == 1);
+    REQUIRE(removed.inserted == 0);
+
+    const auto size     = file.getSource()->size();
+    const auto appended = edit(parser, file, size, size, "M02*");
+    REQUIRE(appended.first == file.getNodes().size() - 1);
+    REQUIRE(appended.inserted == 1);
+}
+
+TEST_CASE("Reparse extends split coordinates", "[reparse]") {
+    const gerber::Parser parser(
+        gerber::ParserOptions{.split_operations = true, .incremental = true}
+    );
+    auto file = parser.parse(source);
+
+    // X0Y0D02* becomes X05Y0D02*, X node is extended.
+    const auto extended = edit(parser, file, 43, 43, "5");
+    REQUIRE(extended.first == 4);
+    REQUIRE(extended.removed == 1);
+    REQUIRE(extended.inserted == 1);
+    // Edit every position of the operation, one by one.
+    for (std::size_t index = 45; index < 53; index++) {
+        edit(parser, file, index, index + 1, std::string(1, (*file.getSource())[index]));
+    }
+}
+
+TEST_CASE("Reparse whole statement of fused operation", "[reparse]") {
+    const gerber::Parser parser(gerber::ParserOptions{.incremental = true});
+    auto file = parser.parse("%FSLAX26Y26*%\nX2908Y50Y169949556D01*\nM02*\n");
+    REQUIRE(file.getNodes().size() == 5);
+
+    // Coordinates split by repeated Y become a single operation.
+    const auto fused = edit(parser, file, 19, 28, "Y44");
+    REQUIRE(fused.first == 1);
+    REQUIRE(fused.removed == 3);
+    REQUIRE(fused.inserted == 1);
+
+    const auto split = edit(parser, file, 19, 22, "Y50Y16994");
+    REQUIRE(split.first == 1);
+    REQUIRE(split.removed == 1);
+    REQUIRE(split.inserted == 3);
+}
+
+TEST_CASE("Reparse leaves file unchanged on syntax error", "[reparse]") {
+    const gerber::Parser parser(gerber::ParserOptions{.incremental = true});
+    auto                 file = parser.parse(source);
+
+    REQUIRE_THROWS_AS(parser.reparse(file, gerber::Span{41, 42}, "?"), gerber::SyntaxError);
+    REQUIRE(*file.getSource() == source);
+    REQUIRE(gerber::Writer().write(file) == gerber::Writer().write(parser.parse(source)));
+
+    REQUIRE_THROWS_AS(
+        parser.reparse(file, gerber::Span{0, source.size() + 1}, ""), std::invalid_argument
+    );
+    auto plain = gerber::Parser().parse(source);
+    REQUIRE_THROWS_AS(parser.reparse(plain, gerber::Span{0, 0}, ""), std::invalid_argument);
+}
@@ -0,0 +1,103 @@
+#include "gerber/gerber.hpp"
+#include "gerber/scanner.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <vector>
+
+TEST_CASE("Scan small source", "[scanner]") {
+    auto backend = GENERATE(
+        gerber::Scanner::SCALAR, gerber::Scanner::SSE2, gerber::Scanner::AVX2
+    );
+    auto index = gerber::Scanner::scan("%MOMM*%\r\n  D10*\n", backend);
+
+    REQUIRE(index.delimiters == std::vector<gerber::location_t>{0, 5, 6, 14});
+    REQUIRE(
+        index.whitespace ==
+        std::vector<gerber::Span>{gerber::Span{7, 11}, gerber::Span{15, 16}}
+    );
+}
+
+TEST_CASE("Scan whitespace run crossing block boundary", "[scanner]") {
+    auto backend = GENERATE(
+        gerber::Scanner::SCALAR, gerber::Scanner::SSE2, gerber::Scanner::AVX2
+    );
+    auto source = std::string(60, 'X') + std::string(10, ' ') + "D01*" + std::string(58, ' ');
+    auto index  = gerber::Scanner::scan(source, backend);
+
+    REQUIRE(index.delimiters == std::vector<gerber::location_t>{73});
+    REQUIRE(
+        index.whitespace ==
+        std::vector<gerber::Span>{gerber::Span{60, 70}, gerber::Span{74, 132}}
+    );
+}
+
+TEST_CASE("All scanner backends agree", "[scanner]") {
+    std::string source;
+    for (int i = 0; i < 1000; i++) {
+        source += (i % 7 == 0) ? "G04 comment *\r\n" : "X100Y200D01*\n";
+        source += std::string(i % 5, ' ');
+    }
+    auto scalar = gerber::Scanner::scan(source, gerber::Scanner::SCALAR);
+    auto best   = gerber::Scanner::scan(source, gerber::Scanner::AUTO);
+
+    REQUIRE(scalar.delimiters == best.delimiters);
+    REQUIRE(scalar.whitespace == best.whitespace);
+}
+
+TEST_CASE("Count delimiters without index", "[scanner]") {
+    auto backend = GENERATE(
+        gerber::Scanner::SCALAR, gerber::Scanner::SSE2, gerber::Scanner::AVX2
+    );
+    std::string source;
+    for (int i = 0; i < 100; i++) {
+        source += "%MOMM*%\r\n" + std::string(i % 70, ' ') + "X100Y200D01*\n";
+        REQUIRE(
+            gerber::Scanner::count_delimiters(source, backend) ==
+            gerber::Scanner::scan(source, backend).delimiters.size()
+        );
+    }
+    REQUIRE(gerber::Scanner::count_delimiters("") == 0);
+}
+
+TEST_CASE("Skip whitespace", "[scanner]") {
+    const auto source = "D10*" + std::string(40, ' ') + "\r\nX1Y1D01*\n \r";
+    REQUIRE(gerber::Scanner::skip_whitespace(source, 0) == 0);
+    // Run longer than a single 16 character comparison.
+    REQUIRE(gerber::Scanner::skip_whitespace(source, 4) == 46);
+    REQUIRE(gerber::Scanner::skip_whitespace(source, 45) == 46);
+    // Run reaching the end of source.
+    REQUIRE(gerber::Scanner::skip_whitespace(source, 54) == source.size());
+    REQUIRE(gerber::Scanner::skip_whitespace(source, source.size()) == source.size());
+    REQUIRE(gerber::Scanner::skip_whitespace(std::string(100, '\n'), 0) == 100);
+}
+
+TEST_CASE("Parse empty source", "[scanner]") {
+    gerber::Parser parser;
+    auto           result = parser.parse("");
+    REQUIRE(result.getNodes().empty());
+}
+
+TEST_CASE("Scanner throughput benchmark", "[.][benchmark]") {
+    gerber::CorpusOptions options;
+    options.target_bytes = 16 * 1024 * 1024;
+    const auto     source = gerber::CorpusGenerator::generate(options);
+    gerber::Parser parser;
+
+    // Bytes per second are source size divided by the mean reported by Catch2.
+    BENCHMARK("count delimiters, scalar, 16 MiB") {
+        return gerber::Scanner::count_delimiters(source, gerber::Scanner::SCALAR);
+    };
+    BENCHMARK("count delimiters, SSE2, 16 MiB") {
+        return gerber::Scanner::count_delimiters(source, gerber::Scanner::SSE2);
+    };
+    BENCHMARK("count delimiters, AVX2, 16 MiB") {
+        return gerber::Scanner::count_delimiters(source, gerber::Scanner::AVX2);
+    };
+    BENCHMARK("full index, best backend, 16 MiB") {
+        return gerber::Scanner::scan(source).delimiters.size();
+    };
+    BENCHMARK("parse, 16 MiB") {
+        return parser.parse(source).getNodes().size();
+    };
+}
@@ -230,6 +230,40 @@ TEST_CASE("Parse Dnn codes", "[d_codes]") {
     REQUIRE(d3->getApertureId() == "999");
 }
 
+TEST_CASE("Parse operation", "[d_codes]") {
+    gerber::Parser parser;
+    auto           gerber_source = "X100Y-200I3J+4D01*Y5D2*X6D003*";
+    auto           result        = parser.parse(gerber_source);
+    const auto&    nodes         = result.getNodes();
+
+    REQUIRE(nodes.size() == 3);
+    auto d01 = std::dynamic_pointer_cast<gerber::Operation>(nodes[0]);
+    auto d02 = std::dynamic_pointer_cast<gerber::Operation>(nodes[1]);
+    auto d03 = std::dynamic_pointer_cast<gerber::Operation>(nodes[2]);
+
+    REQUIRE(d01->getNodeName() == "Operation");
+    REQUIRE(d01->getKind() == gerber::Operation::INTERPOLATE);
+    REQUIRE(d01->getX() == "100");
+    REQUIRE(d01->getY() == "-200");
+    REQUIRE(d01->getI() == "3");
+    REQUIRE(d01->getJ() == "+4");
+
+    REQUIRE(d02->getKind() == gerber::Operation::MOVE);
+    REQUIRE_FALSE(d02->getX().has_value());
+    REQUIRE(d02->getY() == "5");
+
+    REQUIRE(d03->getKind() == gerber::Operation::FLASH);
+    REQUIRE(d03->getX() == "6");
+    REQUIRE_FALSE(d03->getY().has_value());
+}
+
+TEST_CASE("Parse operation with lowercase code", "[d_codes]") {
+    for (const bool split_operations : {false, true}) {
+        gerber::Parser parser(gerber::ParserOptions{.split_operations = split_operations});
+        REQUIRE_THROWS_AS(parser.parse("X1Y1d01*"), gerber::SyntaxError);
+    }
+}
+
 // G codes
 
 TEMPLATE_TEST_CASE_SIG(
@@ -273,6 +307,21 @@ TEST_CASE("Parse G04 with content", "[g_codes]") {
     REQUIRE(nodes[0]->getNodeName() == "G04");
 }
 
+TEST_CASE("Parse G04 with content starting with digits", "[g_codes]") {
+    gerber::Parser parser;
+    auto           result = parser.parse("G041,2*G041st layer*G0042*G041*");
+    const auto&    nodes  = result.getNodes();
+
+    REQUIRE(nodes.size() == 4);
+    const std::string comments[] = {"1,2", "1st layer", "2", "1"};
+    for (size_t i = 0; i < nodes.size(); i++) {
+        REQUIRE(nodes[i]->getNodeName() == "G04");
+        REQUIRE(std::dynamic_pointer_cast<gerber::G04>(nodes[i])->getComment() == comments[i]);
+    }
+    REQUIRE_THROWS_AS(parser.parse("G041st layer%"), gerber::SyntaxError);
+    REQUIRE_THROWS_AS(parser.parse("G5*"), gerber::SyntaxError);
+}
+
 // M codes
 
 TEMPLATE_TEST_CASE_SIG(
@@ -0,0 +1,83 @@
+#include "gerber/gerber.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+// Global allocation functions are replaced to count memory held while streaming, which
+// affects the whole executable, so this test is built separately from other tests.
+
+namespace {
+    // Bytes allocated and not freed yet and their maximum, counted while tracking is on.
+    std::atomic<bool>           tracking{false};
+    std::atomic<std::ptrdiff_t> live_bytes{0};
+    std::atomic<std::ptrdiff_t> peak_bytes{0};
+    // Size of allocation is stored in front of it, keeping alignment of the rest.
+    constexpr std::size_t       header = alignof(std::max_align_t);
+} // namespace
+
+void* operator new(std::size_t size) {
+    auto* block = static_cast<char*>(std::malloc(size + header));
+    if (block == nullptr) {
+        throw std::bad_alloc();
+    }
+    *reinterpret_cast<std::size_t*>(block) = size;
+    if (tracking) {
+        const auto live = live_bytes += static_cast<std::ptrdiff_t>(size);
+        auto       peak = peak_bytes.load();
+        while (live > peak && !peak_bytes.compare_exchange_weak(peak, live)) {
+        }
+    }
+    return block + header;
+}
+
+void operator delete(void* pointer) noexcept {
+    if (pointer == nullptr) {
+        return;
+    }
+    auto* block = static_cast<char*>(pointer) - header;
+    if (tracking) {
+        live_bytes -= static_cast<std::ptrdiff_t>(*reinterpret_cast<std::size_t*>(block));
+    }
+    std::free(block);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    operator delete(pointer);
+}
+
+namespace {
+    /**
+     * Most memory held at once while streaming source, not counting the source.
+     */
+    std::ptrdiff_t stream_peak_bytes(const std::string& source) {
+        gerber::Parser  parser;
+        gerber::Visitor visitor;
+        live_bytes = 0;
+        peak_bytes = 0;
+        tracking   = true;
+        parser.stream(source, visitor);
+        tracking = false;
+        return peak_bytes;
+    }
+} // namespace
+
+TEST_CASE("Streaming memory doesn't grow with source size", "[stream]") {
+    const std::string commands = "D10*\nX1000Y2000D01*\nG04 comment*\n%LPC*%\n";
+    std::string       small;
+    std::string       large;
+    for (size_t i = 0; i < 100; i++) {
+        small += commands;
+    }
+    for (size_t i = 0; i < 100; i++) {
+        large += small;
+    }
+
+    const auto small_peak = stream_peak_bytes(small);
+    const auto large_peak = stream_peak_bytes(large);
+    REQUIRE(small_peak > 0);
+    REQUIRE(large_peak <= small_peak + 1024);
+}
@@ -0,0 +1,139 @@
+#include "gerber/gerber.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+    size_t count(const std::string& haystack, const std::string_view& needle) {
+        size_t result = 0;
+        for (auto position = haystack.find(needle); position != std::string::npos;
+             position      = haystack.find(needle, position + needle.size())) {
+            result++;
+        }
+        return result;
+    }
+
+    class FeatureCollector : public gerber::FeatureSink {
+      public:
+        std::vector<gerber::Feature> features;
+        size_t                       largest_contours = 0;
+
+        void on_feature(const gerber::Image& image, const gerber::Feature& feature) override {
+            features.push_back(feature);
+            largest_contours = std::max(largest_contours, image.contours.size());
+        }
+    };
+
+    const std::string source = R"(
+        %FSLAX26Y26*%
+        %MOMM*%
+        %ADD10C,0.5*%
+        %ADD11R,1X2*%
+        D11*
+        X0Y0D03*
+        X5000000Y0D03*
+        X10000000Y0D03*
+        D10*
+        X0Y5000000D02*
+        G01*
+        X10000000Y5000000D01*
+        Y10000000D01*
+        G03*
+        X0Y10000000I-5000000J0D01*
+        G36*
+        X0Y20000000D02*
+        G01*
+        X10000000D01*
+        Y30000000D01*
+        X0D01*
+        Y20000000D01*
+        G37*
+        M02*
+    )";
+} // namespace
+
+TEST_CASE("Stream features without building File", "[svg]") {
+    gerber::Parser parser;
+
+    gerber::Image       image;
+    FeatureCollector    collector;
+    gerber::Interpreter interpreter(image, &collector);
+    parser.stream(source, interpreter);
+    interpreter.finish();
+
+    const auto expected = gerber::Interpreter::interpret(parser.parse(source));
+    REQUIRE(collector.features.size() == expected.features.size());
+    for (size_t i = 0; i < expected.features.size(); i++) {
+        REQUIRE(collector.features[i].kind == expected.features[i].kind);
+        REQUIRE(collector.features[i].segment == expected.features[i].segment);
+    }
+    REQUIRE(image.apertures == expected.apertures);
+    // Contours are dropped once their region was passed on.
+    REQUIRE(image.features.empty());
+    REQUIRE(image.contours.empty());
+    REQUIRE(collector.largest_contours == 4);
+}
+
+TEST_CASE("Export SVG with shared aperture definitions", "[svg]") {
+    const auto svg = gerber::SvgExporter::render(source);
+
+    REQUIRE(svg.starts_with("<svg xmlns=\"http://www.w3.org/2000/svg\">"));
+    REQUIRE(svg.ends_with("</svg>\n"));
+    // Rectangle is defined once and flashed three times.
+    REQUIRE(count(svg, "<path id=\"a1\"") == 1);
+    REQUIRE(count(svg, "<use href=\"#a1\"") == 3);
+    REQUIRE(svg.find("<path id=\"a1\" fill-rule=\"evenodd\" d=\"M-.5 -1H.5V1H-.5Z\"/>") !=
+            std::string::npos);
+    // Connected draws share one path, including the arc.
+    REQUIRE(count(svg, "stroke-width=\"0.5\"") == 0);
+    REQUIRE(count(svg, "stroke=\"currentColor\"") == 1);
+    REQUIRE(count(svg, "stroke-width=\".5\" d=\"M0 5L10 5L10 10A5 5 0 0 1 0 10\"") == 1);
+    // Region and viewBox flipped to SVG y axis.
+    REQUIRE(svg.find("<path d=\"M0 20L10 20L10 30L0 30L0 20Z\"/>") != std::string::npos);
+    REQUIRE(svg.find("viewBox=\"-1.118 -30 12.2361 31.118\"") != std::string::npos);
+    REQUIRE(count(svg, "<g") == count(svg, "</g>"));
+}
+
+TEST_CASE("Export SVG with clear polarity as masks", "[svg]") {
+    gerber::SvgOptions options;
+    options.color     = "#b87333";
+    options.precision = 2;
+
+    std::ostringstream output;
+    gerber::SvgExporter::render(
+        R"(
+        %FSLAX26Y26*%
+        %MOMM*%
+        %ADD10C,1.234567*%
+        %LPC*%
+        D10*
+        X0Y0D03*
+        %LPD*%
+        X1000000Y1000000D03*
+        %LPC*%
+        X1500000Y1000000D03*
+        %LPD*%
+        X3000000Y1000000D03*
+        M02*
+    )",
+        output,
+        options
+    );
+    const auto svg = output.str();
+
+    // Leading clear flash has nothing to erase, one mask for the later one.
+    REQUIRE(count(svg, "<mask") == 1);
+    REQUIRE(count(svg, "<use href=\"#a0\"") == 3);
+    REQUIRE(svg.find("<use href=\"#l0\" mask=\"url(#m0)\"/>") != std::string::npos);
+    REQUIRE(svg.find("<use href=\"#l1\" fill=\"#b87333\"") != std::string::npos);
+    REQUIRE(svg.find("A.62 .62 ") != std::string::npos);
+    REQUIRE(count(svg, "<g") == count(svg, "</g>"));
+
+    REQUIRE(gerber::SvgExporter::render("") == "<svg xmlns=\"http://www.w3.org/2000/svg\">\n"
+                                               "<defs>\n<g id=\"l0\">\n</g>\n</defs>\n</svg>\n");
+}
@@ -0,0 +1,173 @@
+#include "gerber/gerber.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+    double distance(const gerber::Point& a, const gerber::Point& b) {
+        return std::hypot(a.x - b.x, a.y - b.y);
+    }
+
+    /**
+     * Largest distance of chord midpoint from the circle, which for chords of
+     * circular arc is where the chord error is the largest.
+     */
+    double max_chord_error(
+        const std::vector<gerber::Point>& vertices, const gerber::Point& center, double radius
+    ) {
+        double error = 0;
+        for (size_t i = 1; i < vertices.size(); i++) {
+            const gerber::Point middle{
+                (vertices[i - 1].x + vertices[i].x) / 2, (vertices[i - 1].y + vertices[i].y) / 2
+            };
+            error = std::max(error, std::abs(radius - distance(middle, center)));
+        }
+        return error;
+    }
+
+    // Signed area, positive for counterclockwise polylines.
+    double signed_area(const std::vector<gerber::Point>& vertices, const gerber::Point& center) {
+        double area = 0;
+        for (size_t i = 1; i < vertices.size(); i++) {
+            area += (vertices[i - 1].x - center.x) * (vertices[i].y - center.y) -
+                    (vertices[i].x - center.x) * (vertices[i - 1].y - center.y);
+        }
+        return area / 2;
+    }
+} // namespace
+
+TEST_CASE("Tessellate quarter arc within tolerance", "[tessellation]") {
+    const gerber::ArcTessellator tessellator(0.01);
+    const gerber::Segment        arc{gerber::Segment::ARC_CCW, true, {10, 0}, {0, 10}, {0, 0}};
+
+    gerber::Polylines polylines;
+    tessellator.tessellate(arc, polylines);
+
+    REQUIRE(polylines.size() == 1);
+    const auto& vertices = polylines.vertices;
+    REQUIRE(vertices.size() == tessellator.chord_count(arc) + 1);
+    REQUIRE(vertices.front() == arc.start);
+    REQUIRE(vertices.back() == arc.end);
+    REQUIRE(max_chord_error(vertices, arc.center, 10) <= 0.01);
+    // Not more chords than needed, one less would exceed the tolerance.
+    REQUIRE(10 * (1 - std::cos(std::numbers::pi / 4 / (vertices.size() - 2))) > 0.01);
+    REQUIRE(signed_area(vertices, arc.center) > 0);
+
+    for (const auto& vertex : vertices) {
+        REQUIRE(distance(vertex, arc.center) == Approx(10));
+    }
+}
+
+TEST_CASE("Tessellate clockwise and full circle arcs", "[tessellation]") {
+    const gerber::ArcTessellator tessellator(0.001);
+
+    const gerber::Segment clockwise{gerber::Segment::ARC_CW, true, {0, 1}, {1, 0}, {0, 0}};
+    gerber::Polylines     polylines;
+    tessellator.tessellate(clockwise, polylines);
+    REQUIRE(signed_area(polylines.vertices, clockwise.center) < 0);
+    // Clockwise from 90 to 0 degrees is a quarter, not three quarters of circle.
+    REQUIRE(std::abs(signed_area(polylines.vertices, clockwise.center)) ==
+            Approx(std::numbers::pi / 4).epsilon(0.01));
+
+    const gerber::Segment circle{gerber::Segment::ARC_CCW, true, {2, 0}, {2, 0}, {0, 0}};
+    polylines.clear();
+    tessellator.tessellate(circle, polylines);
+    REQUIRE(polylines.vertices.front() == polylines.vertices.back());
+    REQUIRE(signed_area(polylines.vertices, circle.center) ==
+            Approx(4 * std::numbers::pi).epsilon(0.01));
+    REQUIRE(max_chord_error(polylines.vertices, circle.center, 2) <= 0.001);
+}
+
+TEST_CASE("Tessellate single quadrant arcs", "[tessellation]") {
+    const gerber::ArcTessellator tessellator(0.001);
+
+    // In single quadrant mode start == end is a zero length arc, not a full circle.
+    const gerber::Segment empty{gerber::Segment::ARC_CCW, false, {2, 0}, {2, 0}, {0, 0}};
+    REQUIRE(tessellator.chord_count(empty) == 1);
+
+    const gerber::Segment quadrant{gerber::Segment::ARC_CW, false, {0, 1}, {1, 0}, {0, 0}};
+    const auto            polylines = tessellator.tessellate({quadrant});
+    REQUIRE(signed_area(polylines.vertices, quadrant.center) ==
+            Approx(-std::numbers::pi / 4).epsilon(0.01));
+
+    // Center resolved by interpreter from unsigned offsets.
+    gerber::Parser parser;
+    const auto     file  = parser.parse(R"(
+        %FSLAX24Y24*%
+        %MOMM*%
+        %ADD10C,0.1*%
+        D10*
+        G74*
+        X10000Y0D02*
+        G02*
+        X0Y-10000I10000J0D01*
+        M02*
+    )");
+    const auto     image = gerber::Interpreter::interpret(file);
+    const auto&    arc   = image.features.back().segment;
+    const auto     lines = tessellator.tessellate({arc});
+    REQUIRE(lines.vertices.front() == arc.start);
+    REQUIRE(lines.vertices.back() == arc.end);
+    REQUIRE(signed_area(lines.vertices, arc.center) == Approx(-std::numbers::pi / 4).epsilon(0.01));
+}
+
+TEST_CASE("Tessellate batch of segments", "[tessellation]") {
+    const gerber::ArcTessellator tessellator(0.0001);
+
+    std::vector<gerber::Segment> segments;
+    for (int i = 0; i < 1000; i++) {
+        const double r = 0.1 + i * 0.01;
+        segments.push_back(gerber::Segment{
+            i % 2 ? gerber::Segment::ARC_CW : gerber::Segment::ARC_CCW,
+            true,
+            {r, 0},
+            {-r, 0},
+            {0, 0},
+        });
+    }
+    segments.push_back(gerber::Segment{gerber::Segment::LINE, true, {0, 0}, {1, 1}, {0, 0}});
+
+    const auto polylines = tessellator.tessellate(segments);
+    REQUIRE(polylines.size() == segments.size());
+    REQUIRE(polylines.offsets.back() == polylines.vertices.size());
+
+    gerber::Polylines one_by_one;
+    for (const auto& segment : segments) {
+        tessellator.tessellate(segment, one_by_one);
+    }
+    REQUIRE(one_by_one.offsets == polylines.offsets);
+    REQUIRE(one_by_one.vertices == polylines.vertices);
+
+    double worst_error = 0;
+    for (size_t i = 0; i < 1000; i++) {
+        const std::vector<gerber::Point> vertices(
+            polylines.vertices.begin() + polylines.offsets[i],
+            polylines.vertices.begin() + polylines.offsets[i + 1]
+        );
+        worst_error = std::max(worst_error, max_chord_error(vertices, {0, 0}, segments[i].start.x));
+    }
+    REQUIRE(worst_error <= 0.0001);
+    REQUIRE(polylines.offsets[1001] - polylines.offsets[1000] == 2);
+
+    REQUIRE_THROWS_AS(gerber::ArcTessellator(0), std::invalid_argument);
+}
+
+TEST_CASE("Tessellation benchmark", "[.][benchmark]") {
+    const gerber::ArcTessellator tessellator(0.001);
+
+    std::vector<gerber::Segment> segments;
+    for (int i = 0; i < 10000; i++) {
+        const double r = 0.5 + (i % 100) * 0.05;
+        segments.push_back(gerber::Segment{gerber::Segment::ARC_CCW, true, {r, 0}, {0, r}, {0, 0}}
+        );
+    }
+
+    BENCHMARK("10000 arcs") {
+        return tessellator.tessellate(segments);
+    };
+}
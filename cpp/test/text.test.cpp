@@ -0,0 +1,81 @@
+#include "gerber/gerber.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <string>
+#include <utility>
+
+TEST_CASE("Text storage", "[text]") {
+    const std::string source = "G04 This comment does not fit inline*";
+
+    const gerber::Text small("10");
+    const gerber::Text large(source);
+    const gerber::Text borrowed = gerber::Text::borrow(source);
+
+    REQUIRE(small.view() == "10");
+    REQUIRE(small.heap_usage() == 0);
+    REQUIRE(large.view() == source);
+    REQUIRE(large.view().data() != source.data());
+    REQUIRE(large.heap_usage() == source.size());
+    REQUIRE(borrowed.isBorrowed());
+    REQUIRE(borrowed.view().data() == source.data());
+    REQUIRE(borrowed.heap_usage() == 0);
+
+    gerber::Text copy(large);
+    REQUIRE(copy == large);
+    REQUIRE(copy.view().data() != large.view().data());
+
+    gerber::Text moved(std::move(copy));
+    REQUIRE(moved.view() == source);
+    REQUIRE(copy.view().empty());
+
+    moved = small;
+    REQUIRE(moved.view() == "10");
+    REQUIRE(gerber::Text(borrowed).view().data() == source.data());
+}
+
+TEST_CASE("Parse with borrowed source", "[text]") {
+    gerber::ParserOptions options;
+    options.borrow_source = true;
+
+    const gerber::Parser parser(options);
+    const gerber::Writer writer;
+    const std::string    gerber_source = "G04 Comment*\n"
+                                         "%FSLAX26Y26*%\n"
+                                         "%MOMM*%\n"
+                                         "%ADD10C,0.5*%\n"
+                                         "D10*\n"
+                                         "X1000000Y-2000000D01*\n"
+                                         "M02*\n";
+
+    auto       source = std::make_shared<const std::string>(gerber_source);
+    const auto file   = parser.parse(source);
+
+    REQUIRE(file.getSource() == source);
+    const auto& nodes = file.getNodes();
+
+    const auto begin    = source->data();
+    const auto end      = source->data() + source->size();
+    const auto borrowed = [&](const std::string_view& text) {
+        return text.data() >= begin && text.data() < end;
+    };
+
+    const auto g04 = std::dynamic_pointer_cast<gerber::G04>(nodes[0]);
+    REQUIRE(g04->getCommentView() == " Comment");
+    REQUIRE(borrowed(g04->getCommentView()));
+
+    const auto adc = std::dynamic_pointer_cast<gerber::ADC>(nodes[3]);
+    REQUIRE(borrowed(adc->getApertureIdView()));
+
+    const auto dnn = std::dynamic_pointer_cast<gerber::Dnn>(nodes[4]);
+    REQUIRE(dnn->getApertureId() == "10");
+    REQUIRE(borrowed(dnn->getApertureIdView()));
+
+    const auto operation = std::dynamic_pointer_cast<gerber::Operation>(nodes[5]);
+    REQUIRE(operation->getYView() == "-2000000");
+    REQUIRE(borrowed(*operation->getXView()));
+
+    REQUIRE(writer.write(file) == writer.write(gerber::Parser().parse(gerber_source)));
+    REQUIRE(parser.parse(gerber_source).getSource() != nullptr);
+    REQUIRE(gerber::Parser().parse(gerber_source).getSource() == nullptr);
+}
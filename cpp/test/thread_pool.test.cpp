@@ -0,0 +1,35 @@
+#include "gerber/gerber.hpp"
+#include <atomic>
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <stop_token>
+#include <string>
+
+TEST_CASE("Thread pool executes all tasks", "[thread_pool]") {
+    std::atomic<int> counter = 0;
+    {
+        gerber::ThreadPool pool(4);
+        REQUIRE(pool.size() == 4);
+
+        for (int i = 0; i < 1000; i++) {
+            pool.submit([&counter]() {
+                counter++;
+            });
+        }
+    }
+    REQUIRE(counter == 1000);
+}
+
+TEST_CASE("Cancelled parse throws CancelledError", "[thread_pool]") {
+    std::string source;
+    for (int i = 0; i < 10000; i++) {
+        source += "G01*";
+    }
+    const gerber::Parser parser;
+    std::stop_source     stop_source;
+
+    REQUIRE(parser.parse(source, stop_source.get_token()).getNodes().size() == 10000);
+
+    stop_source.request_stop();
+    REQUIRE_THROWS_AS(parser.parse(source, stop_source.get_token()), gerber::CancelledError);
+}
@@ -0,0 +1,173 @@
+#include "gerber/gerber.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+    const std::string board = R"(
+        %FSLAX24Y24*%
+        %MOIN*%
+        %ADD10C,0.01*%
+        %ADD11R,0.02X0.04*%
+        %ADD12P,0.05X6X30*%
+        G75*
+        D10*
+        X10000Y0D02*
+        G01*
+        X20000D01*
+        G03*
+        X10000Y10000I-10000J0D01*
+        G02*
+        X0Y0I-10000J-10000D01*
+        G01*
+        D11*
+        X5000Y5000D03*
+        D12*
+        Y15000D03*
+        G36*
+        X0Y0D02*
+        X10000D01*
+        Y10000D01*
+        X0D01*
+        Y0D01*
+        G37*
+        M02*
+    )";
+
+    void require_point(const gerber::Point& actual, const gerber::Point& expected) {
+        REQUIRE(actual.x == Approx(expected.x).margin(1e-6));
+        REQUIRE(actual.y == Approx(expected.y).margin(1e-6));
+    }
+
+    void require_segment(
+        const gerber::Segment&         actual,
+        const gerber::Segment&         expected,
+        const gerber::AffineTransform& transform
+    ) {
+        auto kind = expected.kind;
+        if (transform.mirrors() && kind != gerber::Segment::LINE) {
+            kind = kind == gerber::Segment::ARC_CW ? gerber::Segment::ARC_CCW
+                                                   : gerber::Segment::ARC_CW;
+        }
+        REQUIRE(actual.kind == kind);
+        require_point(actual.start, transform.apply(expected.start));
+        require_point(actual.end, transform.apply(expected.end));
+        if (kind != gerber::Segment::LINE) {
+            require_point(actual.center, transform.apply(expected.center));
+        }
+    }
+
+    /**
+     * Interpret file before and after transform and check each feature was moved
+     * by the transform.
+     */
+    gerber::Image
+    require_transformed(const std::string& source, const gerber::AffineTransform& transform) {
+        const auto file   = gerber::Parser().parse(source);
+        const auto before = gerber::Interpreter::interpret(file);
+        const auto after  = gerber::Interpreter::interpret(
+            gerber::Parser().parse(
+                gerber::Writer().write(gerber::Transformer::transform(file, transform))
+            )
+        );
+
+        REQUIRE(after.features.size() == before.features.size());
+        for (std::size_t index = 0; index < before.features.size(); index++) {
+            REQUIRE(after.features[index].kind == before.features[index].kind);
+            require_segment(
+                after.features[index].segment, before.features[index].segment, transform
+            );
+        }
+        REQUIRE(after.contours.size() == before.contours.size());
+        for (std::size_t index = 0; index < before.contours.size(); index++) {
+            require_segment(after.contours[index], before.contours[index], transform);
+        }
+        return after;
+    }
+} // namespace
+
+TEST_CASE("Transformer converts inches to millimeters", "[transform]") {
+    const auto file   = gerber::Parser().parse(board);
+    const auto output = gerber::Writer().write(
+        gerber::Transformer::transform(file, gerber::AffineTransform())
+    );
+    REQUIRE(output.find("%FSLAX46Y46*%\n%MOMM*%\n") != std::string::npos);
+    REQUIRE(output.find("%ADD11R,0.508X1.016*%") != std::string::npos);
+
+    const auto image = require_transformed(board, gerber::AffineTransform());
+    REQUIRE(image.apertures[0].width == Approx(0.254));
+}
+
+TEST_CASE("Transformer rotates, mirrors and offsets layers", "[transform]") {
+    const auto rotation = gerber::AffineTransform::rotate(90)
+                              .then(gerber::AffineTransform::mirror_x())
+                              .then(gerber::AffineTransform::translate(100, -50));
+    const auto image    = require_transformed(board, rotation);
+
+    // Rectangle turned by 90 degrees swaps its sides, polygon vertex is turned too.
+    REQUIRE(image.apertures[1].width == Approx(1.016));
+    REQUIRE(image.apertures[1].height == Approx(0.508));
+    REQUIRE(image.apertures[2].rotation == Approx(60));
+
+    const auto scaled = gerber::AffineTransform::scale(2).then(gerber::AffineTransform::mirror_y());
+    REQUIRE(require_transformed(board, scaled).apertures[1].width == Approx(1.016));
+}
+
+TEST_CASE("Transformer handles arbitrary rotations of round apertures", "[transform]") {
+    const std::string source = R"(
+        %FSLAX26Y26*%
+        %MOMM*%
+        %ADD10C,0.5*%
+        G75*
+        D10*
+        X1000000Y0D02*
+        G03*
+        X0Y1000000I-1000000J0D01*
+        G01*
+        X-500000D01*
+        M02*
+    )";
+    require_transformed(source, gerber::AffineTransform::rotate(30));
+
+    const auto file = gerber::Parser().parse(board);
+    REQUIRE_THROWS_AS(
+        gerber::Transformer::transform(file, gerber::AffineTransform::rotate(30)),
+        std::invalid_argument
+    );
+    REQUIRE_THROWS_AS(
+        gerber::Transformer::transform(file, gerber::AffineTransform{2, 0, 0, 1, 0, 0}),
+        std::invalid_argument
+    );
+}
+
+TEST_CASE("Transform arrays of points like single points", "[transform]") {
+    const auto rotation  = gerber::AffineTransform::rotate(33);
+    const auto transform = rotation.then(gerber::AffineTransform::translate(1.5, -2.25));
+
+    // Lengths which leave every count of points after full vectors.
+    for (std::size_t count = 0; count < 10; count++) {
+        std::vector<double> x;
+        std::vector<double> y;
+        for (std::size_t index = 0; index < count; index++) {
+            x.push_back(0.1 * index - 0.3);
+            y.push_back(7.0 / (index + 1));
+        }
+        auto linear_x = x;
+        auto linear_y = y;
+        transform.apply(x, y);
+        transform.apply_linear(linear_x, linear_y);
+
+        for (std::size_t index = 0; index < count; index++) {
+            const gerber::Point source{0.1 * index - 0.3, 7.0 / (index + 1)};
+            const auto          expected = transform.apply(source);
+            const auto          linear   = rotation.apply(source);
+            REQUIRE(x[index] == expected.x);
+            REQUIRE(y[index] == expected.y);
+            REQUIRE(linear_x[index] == linear.x);
+            REQUIRE(linear_y[index] == linear.y);
+        }
+    }
+}
@@ -0,0 +1,78 @@
+#include "gerber/gerber.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+namespace {
+    std::vector<gerber::Diagnostic::Code> codes(const std::vector<gerber::Diagnostic>& diagnostics) {
+        std::vector<gerber::Diagnostic::Code> result;
+        for (const auto& diagnostic : diagnostics) {
+            result.push_back(diagnostic.code);
+        }
+        return result;
+    }
+} // namespace
+
+TEST_CASE("Validator accepts generated corpus", "[validator]") {
+    gerber::CorpusOptions options;
+    options.target_bytes = 256 * 1024;
+    options.apertures    = 70000;
+
+    const auto file = gerber::Parser().parse(gerber::CorpusGenerator::generate(options));
+    REQUIRE(gerber::Validator::validate(file).empty());
+}
+
+TEST_CASE("Validator reports semantic errors", "[validator]") {
+    const auto file = gerber::Parser().parse(R"(G04 no format*
+X100Y100D02*
+%FSLAX26Y26*%
+%ADD10C,0.5*%
+%ADD10R,1X1*%
+D11*
+D010*
+G36*
+X0Y0D02*
+G36*
+X0Y0D02*
+G37*
+G37*
+G36*
+X0Y0D02*
+)");
+
+    const auto diagnostics = gerber::Validator::validate(file);
+    REQUIRE(
+        codes(diagnostics) ==
+        std::vector<gerber::Diagnostic::Code>{
+            gerber::Diagnostic::MISSING_FORMAT,
+            gerber::Diagnostic::MISSING_UNITS,
+            gerber::Diagnostic::REDEFINED_APERTURE,
+            gerber::Diagnostic::UNDEFINED_APERTURE,
+            gerber::Diagnostic::UNCLOSED_REGION,
+            gerber::Diagnostic::UNOPENED_REGION,
+            gerber::Diagnostic::UNCLOSED_REGION,
+            gerber::Diagnostic::MISSING_END,
+        }
+    );
+    REQUIRE(diagnostics[0].node == 1);
+    REQUIRE(diagnostics[2].node == 4);
+    REQUIRE(diagnostics[2].message == "Aperture D10 is already defined");
+    REQUIRE(diagnostics[3].node == 5);
+    REQUIRE(diagnostics[3].message == "Aperture D11 is not defined");
+    REQUIRE(diagnostics[4].node == 7);
+    REQUIRE(diagnostics[5].node == 12);
+    REQUIRE(diagnostics[6].node == 13);
+    REQUIRE(diagnostics[7].node == file.getNodes().size());
+    REQUIRE_FALSE(diagnostics[0].span.has_value());
+    REQUIRE(gerber::Diagnostic::code_name(diagnostics[7].code) == "missing_end");
+}
+
+TEST_CASE("Validator reports source spans of incremental files", "[validator]") {
+    const gerber::ParserOptions options{.incremental = true};
+
+    const auto file        = gerber::Parser(options).parse("%FSLAX26Y26*%\n%MOMM*%\nD10*\nM02*\n");
+    const auto diagnostics = gerber::Validator::validate(file);
+    REQUIRE(diagnostics.size() == 1);
+    REQUIRE(diagnostics[0].code == gerber::Diagnostic::UNDEFINED_APERTURE);
+    REQUIRE(diagnostics[0].span == gerber::Span{22, 26});
+}
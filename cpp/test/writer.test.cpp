@@ -0,0 +1,62 @@
+#include "gerber/gerber.hpp"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <sstream>
+#include <string>
+
+TEST_CASE("Roundtrip canonical source", "[writer]") {
+    auto gerber_source = std::string(R"(%FSLAX24Y24*%
+%MOIN*%
+%ADD10C,0.5*%
+%ADD11C,0.5X0.1*%
+%ADD12R,0.5X0.25*%
+%ADD13O,0.5X0.25X0.1*%
+%ADD14P,0.5X5*%
+%ADD15P,0.5X6X0X0.1*%
+%AMCIRCLE*%
+%LPC*%
+G04 Hello, world!*
+G75*
+G01*
+D10*
+X100000Y100000D02*
+X200000Y200000D01*
+G03*
+X0Y0I100J100D01*
+D03*
+%LPD*%
+M02*
+)");
+
+    gerber::Parser parser;
+    gerber::Writer writer;
+    auto           file = parser.parse(gerber_source);
+
+    REQUIRE(writer.write(file) == gerber_source);
+
+    std::ostringstream stream;
+    writer.write(file, stream);
+    REQUIRE(stream.str() == gerber_source);
+}
+
+TEST_CASE("Write normalizes layout", "[writer]") {
+    gerber::Parser parser;
+    gerber::Writer writer;
+    auto           file = parser.parse("G1*  D010*\r\nX1Y2D1*G04 x*");
+
+    REQUIRE(writer.write(file) == "G01*\nD10*\nX1Y2D01*\nG04 x*\n");
+}
+
+TEST_CASE("Write very small and large numbers without exponent", "[writer]") {
+    auto gerber_source = std::string(R"(%ADD10C,0.00005*%
+%ADD11R,100000000000000000000X0.0000001234*%
+%ADD12P,123456789012.5X3X-0.000001X0.1*%
+)");
+
+    gerber::Parser parser;
+    gerber::Writer writer;
+    auto           output = writer.write(parser.parse(gerber_source));
+
+    REQUIRE(output == gerber_source);
+    REQUIRE(writer.write(parser.parse(output)) == gerber_source);
+}
@@ -0,0 +1,146 @@
+#include "gerber/corpus.hpp"
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+    constexpr std::string_view usage = R"(Usage: generate_corpus [options]
+
+Writes a deterministic synthetic Gerber file to standard output.
+
+Options:
+  --output PATH         Write to file instead of standard output.
+  --seed N              Random seed, same seed and options give the same file.
+  --size N[K|M|G]       Approximate size of the file in bytes.
+  --board WxH           Board size in millimeters.
+  --apertures N         Number of %ADD apertures.
+  --macros N            Number of %AM macros.
+  --pour-vertices N     Vertices of each G36/G37 pour.
+  --comment-bytes N     Length of each G04 comment.
+  --tracks N            Relative weight of D01 track blocks.
+  --pads N              Relative weight of D03 pad arrays.
+  --pours N             Relative weight of G36/G37 pours.
+  --arcs N              Relative weight of G02/G03 outlines.
+  --clears N            Relative weight of LPC/LPD blocks.
+  --comments N          Relative weight of G04 comments.
+)";
+
+    uint64_t parse_size(const std::string& value) {
+        size_t   length = 0;
+        uint64_t size   = std::stoull(value, &length);
+        if (length + 1 == value.size()) {
+            switch (value.back()) {
+                case 'K':
+                    return size << 10;
+                case 'M':
+                    return size << 20;
+                case 'G':
+                    return size << 30;
+                default:
+                    break;
+            }
+        }
+        if (length != value.size()) {
+            throw std::invalid_argument("Invalid size: " + value);
+        }
+        return size;
+    }
+
+    uint32_t parse_count(const std::string& value) {
+        size_t length = 0;
+        auto   count  = std::stoul(value, &length);
+        if (length != value.size()) {
+            throw std::invalid_argument("Invalid number: " + value);
+        }
+        return static_cast<uint32_t>(count);
+    }
+
+    void parse_board(const std::string& value, gerber::CorpusOptions& options) {
+        const auto separator = value.find('x');
+        if (separator == std::string::npos) {
+            throw std::invalid_argument("Invalid board size: " + value);
+        }
+        options.board_width  = std::stod(value.substr(0, separator));
+        options.board_height = std::stod(value.substr(separator + 1));
+        if (!(options.board_width > 0 && options.board_height > 0)) {
+            throw std::invalid_argument("Invalid board size: " + value);
+        }
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    gerber::CorpusOptions options;
+    std::string           output;
+
+    try {
+        const std::vector<std::string> arguments(argv + 1, argv + argc);
+        for (size_t index = 0; index < arguments.size(); index++) {
+            const auto& name = arguments[index];
+            if (name == "--help" || name == "-h") {
+                std::cout << usage;
+                return 0;
+            }
+            if (index + 1 == arguments.size()) {
+                throw std::invalid_argument("Missing value of " + name);
+            }
+            const auto& value = arguments[++index];
+
+            if (name == "--output") {
+                output = value;
+            } else if (name == "--seed") {
+                options.seed = std::stoull(value);
+            } else if (name == "--size") {
+                options.target_bytes = parse_size(value);
+            } else if (name == "--board") {
+                parse_board(value, options);
+            } else if (name == "--apertures") {
+                options.apertures = parse_count(value);
+            } else if (name == "--macros") {
+                options.macros = parse_count(value);
+            } else if (name == "--pour-vertices") {
+                options.pour_vertices = parse_count(value);
+            } else if (name == "--comment-bytes") {
+                options.comment_bytes = parse_count(value);
+            } else if (name == "--tracks") {
+                options.tracks = parse_count(value);
+            } else if (name == "--pads") {
+                options.pads = parse_count(value);
+            } else if (name == "--pours") {
+                options.pours = parse_count(value);
+            } else if (name == "--arcs") {
+                options.arcs = parse_count(value);
+            } else if (name == "--clears") {
+                options.clears = parse_count(value);
+            } else if (name == "--comments") {
+                options.comments = parse_count(value);
+            } else {
+                throw std::invalid_argument("Unknown option " + name);
+            }
+        }
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << "\n\n" << usage;
+        return 2;
+    }
+
+    // Nothing is written through C stdio, unsynchronized std::cout is faster.
+    std::ios::sync_with_stdio(false);
+    if (output.empty()) {
+        gerber::CorpusGenerator::generate(options, std::cout);
+        std::cout.flush();
+        return std::cout ? 0 : 1;
+    }
+
+    std::ofstream file(output, std::ios::binary);
+    if (!file) {
+        std::cerr << "Can't open " << output << "\n";
+        return 1;
+    }
+    gerber::CorpusGenerator::generate(options, file);
+    file.close();
+    return file ? 0 : 1;
+}
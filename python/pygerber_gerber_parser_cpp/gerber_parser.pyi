@@ -1,16 +1,88 @@
 from __future__ import annotations
-from typing import Any
+import asyncio
+from typing import Any, Iterator, overload
 
 class Node:
     def visit(self, visitor: Any) -> None:
         pass
 
+class NodesView:
+    """Read-only lazy sequence of File nodes."""
+
+    def __len__(self) -> int: ...
+    @overload
+    def __getitem__(self, index: int) -> Node: ...
+    @overload
+    def __getitem__(self, index: slice) -> list[Node]: ...
+    def __iter__(self) -> Iterator[Node]: ...
+
 class File:
-    nodes: list[Node]
+    nodes: NodesView
+
+    def memory_usage(self) -> int:
+        """Bytes used by the file, its nodes and strings they own."""
+
+    def to_pygerber(self) -> Any:
+        """Build equivalent `pygerber.gerber.ast.nodes.File` in a single pass."""
+
+class Operation(Node):
+    kind: int
+    x: str | None
+    y: str | None
+    i: str | None
+    j: str | None
 
 class GerberParser:
+    def __init__(self, *, split_operations: bool = False) -> None:
+        pass
+
     def parse(self, source: str) -> File:
         pass
 
+    def parse_with_stats(self, source: str) -> tuple[File, dict[str, Any]]:
+        """Parse and return statistics: bytes_scanned, comment_bytes, aperture_count,
+        largest_region, peak_bytes, scan_time_ns, total_time_ns, timing_enabled, families
+        (commands and time_ns per command family) and nodes (count per node name)."""
+
+    def parse_file(self, path: str) -> File:
+        """Parse file from disk, gzip compressed files are inflated in memory."""
+
+    def parse_package(
+        self, path: str, names: list[str] = [], threads: int = 0
+    ) -> dict[str, File]:
+        """Parse members of zip archive in parallel. When names are empty, all
+        members with Gerber file extensions are parsed."""
+
+    def parse_async(self, source: str) -> asyncio.Future[File]:
+        """Parse on a worker thread, must be called from a running event loop.
+        Cancelling returned future stops parsing."""
+
+def set_async_pool_size(size: int) -> None:
+    """Set number of worker threads used by parse_async(), 0 means one per CPU core."""
+
+def get_async_pool_size() -> int:
+    pass
+
+class GerberWriter:
+    def write(self, file: File) -> str:
+        pass
+
+    def write_file(self, file: File, path: str) -> None:
+        pass
+
+class SvgExporter:
+    def __init__(self, *, color: str = "black", precision: int = 4) -> None:
+        pass
+
+    def export(self, source: str) -> bytes:
+        """Parse source and render it as SVG in a single streaming pass, without
+        building File."""
+
+    def export_file(self, source: str, path: str) -> None:
+        """Same as export(), but SVG is written to a file as it is produced."""
+
 class SyntaxError(Exception):
     pass
+
+class ArchiveError(Exception):
+    pass
@@ -5,6 +5,8 @@ from unittest.mock import MagicMock
 import pytest
 
 if TYPE_CHECKING:
+    from pathlib import Path
+
     import pygerber_gerber_parser_cpp.gerber_parser as gerber_parser
 
 
@@ -41,3 +43,200 @@ def test_visit_g_code(g_code, parser: gerber_parser.GerberParser) -> None:
     mock = MagicMock()
     node.visit(mock)
     getattr(mock, f"on_g{g_code:0>2}").assert_called_once_with(node)
+
+
+@pytest.mark.parametrize("d_code", [1, 2, 3])
+def test_visit_operation(d_code, parser: gerber_parser.GerberParser) -> None:
+    file = parser.parse(f"X10Y-20D0{d_code}*")
+    assert len(file.nodes) == 1
+
+    node = file.nodes[0]
+    assert node.kind == d_code
+    assert node.x == "10"
+    assert node.y == "-20"
+    assert node.i is None
+
+    mock = MagicMock()
+    node.visit(mock)
+    getattr(mock, f"on_d{d_code:0>2}").assert_called_once_with(node)
+
+
+def test_split_operations() -> None:
+    import pygerber_gerber_parser_cpp.gerber_parser as gerber_parser
+
+    parser = gerber_parser.GerberParser(split_operations=True)
+    file = parser.parse("X10Y20D01*")
+    assert len(file.nodes) == 3
+
+
+def test_parse_from_many_threads(parser: gerber_parser.GerberParser) -> None:
+    from concurrent.futures import ThreadPoolExecutor
+
+    source = "%FSLAX24Y24*%\n%MOMM*%\n%ADD10C,0.5*%\nD10*\nX100Y100D02*\nM02*\n"
+
+    with ThreadPoolExecutor(max_workers=8) as executor:
+        counts = list(executor.map(lambda _: len(parser.parse(source).nodes), range(64)))
+
+    assert counts == [6] * 64
+
+
+def test_parse_async(parser: gerber_parser.GerberParser) -> None:
+    import asyncio
+
+    source = "%FSLAX24Y24*%\n%MOMM*%\n%ADD10C,0.5*%\nD10*\nX100Y100D02*\nM02*\n"
+
+    async def main() -> list[int]:
+        files = await asyncio.gather(*(parser.parse_async(source) for _ in range(16)))
+        return [len(file.nodes) for file in files]
+
+    assert asyncio.run(main()) == [6] * 16
+
+
+def test_parse_async_syntax_error(parser: gerber_parser.GerberParser) -> None:
+    import asyncio
+
+    import pygerber_gerber_parser_cpp.gerber_parser as gerber_parser
+
+    async def main() -> None:
+        await parser.parse_async("lol")
+
+    with pytest.raises(gerber_parser.SyntaxError):
+        asyncio.run(main())
+
+
+def test_parse_async_cancel(parser: gerber_parser.GerberParser) -> None:
+    import asyncio
+
+    async def main() -> None:
+        future = parser.parse_async("G01*" * 1_000_000)
+        future.cancel()
+        with pytest.raises(asyncio.CancelledError):
+            await future
+
+    asyncio.run(main())
+
+
+def test_async_pool_size() -> None:
+    import pygerber_gerber_parser_cpp.gerber_parser as gerber_parser
+
+    gerber_parser.set_async_pool_size(2)
+    assert gerber_parser.get_async_pool_size() == 2
+
+
+def test_parse_gzip_file(parser: gerber_parser.GerberParser, tmp_path) -> None:
+    import gzip
+
+    source = "%FSLAX24Y24*%\n%MOMM*%\n%ADD10C,0.5*%\nD10*\nX100Y100D02*\nM02*\n"
+    path = tmp_path / "top.gtl.gz"
+    path.write_bytes(gzip.compress(source.encode()))
+
+    assert len(parser.parse_file(str(path)).nodes) == 6
+
+
+def test_parse_package(parser: gerber_parser.GerberParser, tmp_path) -> None:
+    import zipfile
+
+    source = "%FSLAX24Y24*%\n%MOMM*%\n%ADD10C,0.5*%\nD10*\nX100Y100D02*\nM02*\n"
+    path = tmp_path / "package.zip"
+    with zipfile.ZipFile(path, "w", compression=zipfile.ZIP_DEFLATED) as archive:
+        archive.writestr("top.gtl", source)
+        archive.writestr("bottom.gbl", source)
+        archive.writestr("readme.txt", "not a gerber file")
+
+    files = parser.parse_package(str(path))
+    assert sorted(files) == ["bottom.gbl", "top.gtl"]
+    assert all(len(file.nodes) == 6 for file in files.values())
+
+
+def test_parse_with_stats(parser: gerber_parser.GerberParser) -> None:
+    source = "G04 comment*%FSLAX24Y24*%%ADD10C,0.5*%D10*X100Y100D03*M02*"
+    file, stats = parser.parse_with_stats(source)
+
+    assert len(file.nodes) == 6
+    assert stats["bytes_scanned"] == len(source)
+    assert stats["comment_bytes"] == 8
+    assert stats["aperture_count"] == 1
+    assert stats["nodes"]["Operation"] == 1
+    assert stats["families"]["extended"]["commands"] == 2
+    assert stats["peak_bytes"] >= file.memory_usage() > 0
+
+
+def test_nodes_view(parser: gerber_parser.GerberParser) -> None:
+    file = parser.parse("G1*G2*G3*G36*G37*")
+    nodes = file.nodes
+
+    assert len(nodes) == 5
+    assert str(nodes[0]) == "G01"
+    assert str(nodes[-1]) == "G37"
+    assert [str(node) for node in nodes[1:4:2]] == ["G02", "G36"]
+    assert [str(node) for node in nodes] == ["G01", "G02", "G03", "G36", "G37"]
+    assert nodes[2] is file.nodes[2]
+
+    with pytest.raises(IndexError):
+        nodes[5]
+
+    del file
+    assert str(nodes[1]) == "G02"
+
+
+def test_to_pygerber(parser: gerber_parser.GerberParser) -> None:
+    pygerber_nodes = pytest.importorskip("pygerber.gerber.ast.nodes")
+    pygerber_enums = pytest.importorskip("pygerber.gerber.ast.nodes.enums")
+
+    source = "G04 Hello*%FSLAX24Y24*%%MOMM*%%ADD10C,0.5*%D10*X100Y-200D01*X5D02*M02*"
+    file = parser.parse(source).to_pygerber()
+
+    assert isinstance(file, pygerber_nodes.File)
+    assert [node.__class__.__qualname__ for node in file.nodes] == [
+        "G04",
+        "FS",
+        "MO",
+        "ADC",
+        "DNN",
+        "D01",
+        "D02",
+        "M02",
+    ]
+    assert file.nodes[0].string == " Hello"
+    assert file.nodes[1].zeros == pygerber_enums.Zeros.SKIP_LEADING
+    assert file.nodes[3].aperture_id == "D10"
+    assert file.nodes[5].x.value == "100"
+    assert file.nodes[5].y.value == "-200"
+    assert file.nodes[6].y is None
+
+
+def test_to_pygerber_split_operations() -> None:
+    pytest.importorskip("pygerber.gerber.ast.nodes")
+    import pygerber_gerber_parser_cpp.gerber_parser as gerber_parser
+
+    parser = gerber_parser.GerberParser(split_operations=True)
+    file = parser.parse("X100Y200D01*D03*").to_pygerber()
+
+    assert [node.__class__.__qualname__ for node in file.nodes] == ["D01", "D03"]
+    assert file.nodes[0].x.value == "100"
+    assert file.nodes[1].x is None
+
+
+def test_write_roundtrip(parser: gerber_parser.GerberParser) -> None:
+    import pygerber_gerber_parser_cpp.gerber_parser as gerber_parser
+
+    source = "%FSLAX24Y24*%\n%MOMM*%\n%ADD10C,0.5*%\nD10*\nX100Y100D02*\nM02*\n"
+    file = parser.parse(source)
+
+    assert gerber_parser.GerberWriter().write(file) == source
+
+
+def test_svg_export(tmp_path: Path) -> None:
+    import pygerber_gerber_parser_cpp.gerber_parser as gerber_parser
+
+    source = "%FSLAX24Y24*%\n%MOMM*%\n%ADD10C,0.5*%\nD10*\nX0Y0D03*\nX10000Y0D03*\nM02*\n"
+    exporter = gerber_parser.SvgExporter(color="#b87333")
+    svg = exporter.export(source)
+
+    assert svg.startswith(b"<svg ")
+    assert svg.count(b'<use href="#a0"') == 2
+    assert b'fill="#b87333"' in svg
+
+    path = tmp_path / "layer.svg"
+    exporter.export_file(source, str(path))
+    assert path.read_bytes() == svg